@@ -1,9 +1,37 @@
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++11 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += main.cpp
 
 HEADERS += \
-    graph.hpp
+    graph.hpp \
+    compact_graph.hpp \
+    weights.hpp \
+    dot_reader.hpp \
+    parallel_loader.hpp \
+    string_pool.hpp \
+    graph_snapshot.hpp \
+    priority_queues.hpp \
+    parallel.hpp \
+    disjoint_set.hpp \
+    label_index.hpp \
+    pooled_label.hpp \
+    components.hpp \
+    spanning_forest.hpp \
+    thread_pool.hpp \
+    all_sources.hpp \
+    distance_matrix.hpp \
+    contraction_hierarchy.hpp \
+    tree_cache.hpp \
+    batch_paths.hpp \
+    traversal.hpp \
+    parallel_bfs.hpp \
+    arena.hpp \
+    overlay.hpp \
+    dot_writer.hpp \
+    subgraph_mask.hpp \
+    instrumentation.hpp \
+    dynamic_sssp.hpp \
+    dynamic_msf.hpp
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "compact_graph.hpp"
+#include "thread_pool.hpp"
+
+
+// Per-source summaries of the shortest-path trees of a CompactGraph, one
+// Dijkstra per source spread over a ThreadPool. Every worker keeps its own
+// Search, so the trees are never materialized and a run allocates nothing per
+// source. Unreached vertices are left out of every aggregate.
+template<class EDATA>
+struct SourceStats
+{
+    EDATA tree_weight;      // sum of the weights of the tree edges
+    EDATA distance_sum;     // sum of the distances, the inverse of closeness
+    EDATA eccentricity;     // largest distance
+    unsigned reached;       // vertices reached, the source included
+};
+
+enum PivotCriterion { TREE_WEIGHT, CLOSENESS, ECCENTRICITY };
+
+
+template<class EDATA, class QUEUE = DaryHeap<>, class WEIGHTS = DefaultWeights<EDATA> >
+class AllSourcesBuilder
+{
+
+private:
+    typedef typename CompactGraph<EDATA>::template Search<QUEUE> Search;
+
+    const CompactGraph<EDATA>* graph;
+    WEIGHTS weights;
+    ThreadPool* pool;
+    unsigned threads;
+
+    SourceStats<EDATA> summarize(Search& search, unsigned source) const
+    {
+        graph->shortest_path_tree(source, weights, search);
+
+        EDATA zero = weights.zero();
+        SourceStats<EDATA> stats = { zero, zero, zero, 0 };
+        const std::vector<unsigned>& touched = search.touched_vertices();
+        for (unsigned i = 0; i < touched.size(); i++)
+        {
+            unsigned v = touched[i];
+            EDATA d = search.distance[v];
+            if (search.parent[v] != CompactGraph<EDATA>::NONE)
+            {
+                stats.tree_weight = stats.tree_weight + graph->edge_weight(search.parent[v]);
+            }
+            stats.distance_sum = stats.distance_sum + d;
+            if (stats.eccentricity < d)
+            {
+                stats.eccentricity = d;
+            }
+        }
+        stats.reached = touched.size();
+        return stats;
+    }
+
+    static EDATA criterion_value(const SourceStats<EDATA>& s, PivotCriterion criterion)
+    {
+        switch (criterion)
+        {
+        case CLOSENESS:
+            return s.distance_sum;
+        case ECCENTRICITY:
+            return s.eccentricity;
+        default:
+            return s.tree_weight;
+        }
+    }
+
+public:
+    // pool may be null: a pool of threads workers (0 = every core) is then made per run
+    AllSourcesBuilder(const CompactGraph<EDATA>* g, const WEIGHTS& weights = WEIGHTS(), ThreadPool* pool = 0, unsigned threads = 0)
+        : weights(weights)
+    {
+        this->graph = g;
+        this->pool = pool;
+        this->threads = threads;
+    }
+
+    std::vector<SourceStats<EDATA> > get()
+    {
+        ThreadPool* p = pool;
+        std::unique_ptr<ThreadPool> own;
+        if (!p)
+        {
+            own.reset(new ThreadPool(threads));
+            p = own.get();
+        }
+
+        std::vector<SourceStats<EDATA> > stats(graph->num_vertices());
+        std::vector<Search> searches(p->size());
+        p->for_each(0, graph->num_vertices(), [&](unsigned source, unsigned worker) {
+            stats[source] = summarize(searches[worker], source);
+        });
+        return stats;
+    }
+
+    // Source minimizing the criterion, lowest index on ties; NONE for an empty graph.
+    unsigned pivot(PivotCriterion criterion = TREE_WEIGHT)
+    {
+        return pivot(get(), criterion);
+    }
+
+    static unsigned pivot(const std::vector<SourceStats<EDATA> >& stats, PivotCriterion criterion = TREE_WEIGHT)
+    {
+        unsigned best = CompactGraph<EDATA>::NONE;
+        for (unsigned v = 0; v < stats.size(); v++)
+        {
+            if (best == CompactGraph<EDATA>::NONE || criterion_value(stats[v], criterion) < criterion_value(stats[best], criterion))
+            {
+                best = v;
+            }
+        }
+        return best;
+    }
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+
+
+// Bump-pointer arena of T: objects are placed one after the other in large
+// blocks and destroyed together by clear(). Blocks double in size up to
+// MAX_BLOCK objects, so a pointer to an object stays valid until it is
+// destroyed. An object destroyed alone leaves its slot on a free list, which
+// the next create() takes before bumping, so churn does not grow the arena.
+template<class T>
+class Arena
+{
+
+private:
+    enum { FIRST_BLOCK = 64, MAX_BLOCK = 1 << 20 };
+
+    struct Block
+    {
+        T* data;
+        size_t used;
+        size_t capacity;
+    };
+
+    std::vector<Block> blocks;
+    std::vector<T*> free;       // slots of objects destroyed alone
+    size_t count;
+
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    void add_block(size_t capacity)
+    {
+        Block b;
+        b.data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        b.used = 0;
+        b.capacity = capacity;
+        blocks.push_back(b);
+    }
+
+public:
+    Arena() { count = 0; }
+    ~Arena() { clear(); }
+
+    Arena(Arena&& o) : blocks(std::move(o.blocks)), free(std::move(o.free))
+    {
+        count = o.count;
+        o.blocks.clear();
+        o.free.clear();
+        o.count = 0;
+    }
+
+    Arena& operator=(Arena&& o)
+    {
+        swap(o);
+        return *this;
+    }
+
+    void swap(Arena& o)
+    {
+        blocks.swap(o.blocks);
+        free.swap(o.free);
+        std::swap(count, o.count);
+    }
+
+    size_t size() const { return count; }
+
+    // bytes taken from the system allocator
+    size_t capacity_bytes() const
+    {
+        size_t bytes = 0;
+        for (size_t i = 0; i < blocks.size(); i++)
+            bytes += blocks[i].capacity * sizeof(T);
+        return bytes;
+    }
+
+    // makes room for n more objects in a single block
+    void reserve(size_t n)
+    {
+        if (n == 0)
+            return;
+        if (blocks.empty() || blocks.back().capacity - blocks.back().used < n)
+            add_block(n);
+    }
+
+    template<class... ARGS>
+    T* create(ARGS&&... args)
+    {
+        if (!free.empty())
+        {
+            T* p = new (free.back()) T(std::forward<ARGS>(args)...);
+            free.pop_back();
+            count ++;
+            return p;
+        }
+        if (blocks.empty() || blocks.back().used == blocks.back().capacity)
+        {
+            // a block from reserve() may be smaller than the first one
+            size_t size = blocks.empty() ? 0 : blocks.back().capacity * 2;
+            if (size < (size_t) FIRST_BLOCK)
+                size = FIRST_BLOCK;
+            add_block(size < (size_t) MAX_BLOCK ? size : (size_t) MAX_BLOCK);
+        }
+        Block& b = blocks.back();
+        T* p = new (b.data + b.used) T(std::forward<ARGS>(args)...);
+        b.used ++;
+        count ++;
+        return p;
+    }
+
+    // p must come from this arena's create() and not be destroyed yet
+    void destroy(T* p)
+    {
+        p->~T();
+        free.push_back(p);
+        count --;
+    }
+
+    void clear()
+    {
+        // slots on the free list hold no object any more
+        std::sort(free.begin(), free.end(), std::less<T*>());
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            if (!std::is_trivially_destructible<T>::value)
+            {
+                for (size_t j = 0; j < blocks[i].used; j++)
+                {
+                    if (!std::binary_search(free.begin(), free.end(), blocks[i].data + j, std::less<T*>()))
+                        blocks[i].data[j].~T();
+                }
+            }
+            ::operator delete(blocks[i].data);
+        }
+        blocks.clear();
+        free.clear();
+        count = 0;
+    }
+};
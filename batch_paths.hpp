@@ -0,0 +1,171 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+#include "compact_graph.hpp"
+#include "thread_pool.hpp"
+#include "tree_cache.hpp"
+
+
+// Answers many (source, target) queries with as few shortest-path trees as it
+// can. A tree rooted at the source answers a query, and so does one rooted at
+// the target: on the graph itself when undirected, on the reverse graph when
+// directed. Cached trees are used first; the remaining queries are covered
+// greedily by the root shared with the most of them, and the new trees are
+// grown in parallel, one Search per worker.
+//
+// Trees are keyed by root * 2, plus 1 when grown on the reverse graph. Every
+// path is listed from the target back to the source, like Search::path_to.
+template<class EDATA, class QUEUE = DaryHeap<>, class WEIGHTS = DefaultWeights<EDATA> >
+class BatchPathBuilder
+{
+
+public:
+    typedef typename CompactGraph<EDATA>::ShortestPathTree Tree;
+    typedef LruCache<unsigned long, Tree> TreeCache;
+
+private:
+    typedef typename CompactGraph<EDATA>::template Search<QUEUE> Search;
+
+    const CompactGraph<EDATA>* graph;
+    const CompactGraph<EDATA>* reverse;
+    WEIGHTS weights;
+    TreeCache* cache;
+    unsigned threads;
+
+    unsigned long forward_key(unsigned source) const { return (unsigned long) source * 2; }
+    unsigned long backward_key(unsigned target) const { return (unsigned long) target * 2 + (graph->is_directed() ? 1 : 0); }
+
+    // the tree is rooted at the source when key is its forward key, at the target otherwise
+    std::vector<unsigned> extract(const std::vector<unsigned>& parent, unsigned long key, unsigned source, unsigned target) const
+    {
+        const unsigned NONE = CompactGraph<EDATA>::NONE;
+        bool from_source = key == forward_key(source);
+        std::vector<unsigned> path;
+        for (unsigned v = from_source ? target : source; parent[v] != NONE; v = graph->opposite(parent[v], v))
+        {
+            path.push_back(parent[v]);
+        }
+        if (!from_source)
+        {
+            std::reverse(path.begin(), path.end());
+        }
+        return path;
+    }
+
+public:
+    // reverse is the reversed graph when g is directed and g itself otherwise; cache may be null
+    BatchPathBuilder(const CompactGraph<EDATA>* g, const CompactGraph<EDATA>* reverse, const WEIGHTS& weights = WEIGHTS(), TreeCache* cache = 0, unsigned threads = 0)
+        : weights(weights)
+    {
+        this->graph = g;
+        this->reverse = reverse;
+        this->cache = cache;
+        this->threads = threads;
+    }
+
+    std::vector<std::vector<unsigned> > get(const std::vector<std::pair<unsigned, unsigned> >& queries)
+    {
+        std::vector<std::vector<unsigned> > paths(queries.size());
+        std::vector<unsigned long> assigned(queries.size(), ~0ul);
+        std::unordered_map<unsigned long, std::vector<unsigned> > candidates;
+
+        for (unsigned i = 0; i < queries.size(); i++)
+        {
+            unsigned s = queries[i].first;
+            unsigned t = queries[i].second;
+            if (s == t)
+                continue;
+
+            unsigned long keys[2] = { forward_key(s), backward_key(t) };
+            std::shared_ptr<const Tree> tree;
+            for (unsigned k = 0; k < 2 && cache && !tree; k++)
+            {
+                tree = cache->get(keys[k]);
+                if (tree)
+                    paths[i] = extract(tree->parent, keys[k], s, t);
+            }
+            if (tree)
+                continue;
+
+            candidates[keys[0]].push_back(i);
+            candidates[keys[1]].push_back(i);
+        }
+
+        // greedy cover: take the root with the most unanswered queries, lazily re-ranked
+        std::unordered_map<unsigned long, unsigned> pending;
+        std::priority_queue<std::pair<unsigned, unsigned long> > ranking;
+        for (auto c = candidates.begin(); c != candidates.end(); ++c)
+        {
+            pending[c->first] = c->second.size();
+            ranking.push(std::make_pair((unsigned) c->second.size(), c->first));
+        }
+
+        std::vector<unsigned long> roots;
+        while (!ranking.empty())
+        {
+            std::pair<unsigned, unsigned long> top = ranking.top();
+            ranking.pop();
+            unsigned count = pending[top.second];
+            if (count == 0)
+                continue;
+            if (count != top.first)
+            {
+                ranking.push(std::make_pair(count, top.second));
+                continue;
+            }
+
+            roots.push_back(top.second);
+            const std::vector<unsigned>& covered = candidates[top.second];
+            for (unsigned j = 0; j < covered.size(); j++)
+            {
+                unsigned i = covered[j];
+                if (assigned[i] != ~0ul)
+                    continue;
+                assigned[i] = top.second;
+                unsigned long keys[2] = { forward_key(queries[i].first), backward_key(queries[i].second) };
+                pending[keys[0]] --;
+                pending[keys[1]] --;
+            }
+        }
+
+        ThreadPool pool(std::min<unsigned>(threads ? threads : default_threads(), std::max<size_t>(roots.size(), 1)));
+        std::vector<Search> searches(pool.size());
+        std::vector<std::shared_ptr<const Tree> > grown(roots.size());
+        bool keep = cache && cache->get_capacity() > 0;
+
+        pool.for_each(0, roots.size(), [&](unsigned r, unsigned worker) {
+            unsigned long key = roots[r];
+            Search& search = searches[worker];
+            const CompactGraph<EDATA>* g = key % 2 ? reverse : graph;
+            g->shortest_path_tree(key / 2, weights, search);
+
+            const std::vector<unsigned>& covered = candidates.find(key)->second;
+            for (unsigned j = 0; j < covered.size(); j++)
+            {
+                unsigned i = covered[j];
+                if (assigned[i] == key)
+                    paths[i] = extract(search.parent, key, queries[i].first, queries[i].second);
+            }
+
+            if (keep)
+            {
+                std::shared_ptr<Tree> tree(new Tree());
+                tree->distance = search.distance;
+                tree->parent = search.parent;
+                grown[r] = tree;
+            }
+        });
+
+        for (unsigned r = 0; keep && r < roots.size(); r++)
+        {
+            cache->put(roots[r], grown[r]);
+        }
+        return paths;
+    }
+};
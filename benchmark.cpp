@@ -0,0 +1,634 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "graph.hpp"
+#include "dot_reader.hpp"
+#include "parallel_loader.hpp"
+#include "generator.hpp"
+
+// Times the main graph operations on a generated graph and prints one JSON
+// object per operation on stdout:
+//
+//     benchmark [random|grid|rmat|dense] [size] [options]
+//
+//     size            vertices (random, dense), side (grid) or scale (rmat):
+//                     an rmat graph has 2^size vertices, so size must be below 31
+//     --degree D      edges per vertex for random and rmat (default 8)
+//     --weights A-B   weight range (default 1-100)
+//     --seed S        generator and query seed (default 1)
+//     --reps R        timed runs per operation (default 10)
+//     --directed      directed graph
+//     --only a,b      operations to run, among load pload mst sssp p2p bfs dfs pivot ch
+//     --stats FILE    also write the engine counters of every operation, as
+//                     CSV, or as JSON when FILE ends in .json
+//     --verify        check the engines against each other instead of timing
+//                     them, see Verifier below
+//
+// The counters are only filled in when built with ALGO_STATS defined, see
+// instrumentation.hpp; they are then added to each line as "stats".
+//
+// pivot grows one tree per vertex, so it is only run by default up to
+// PIVOT_LIMIT vertices, and once. ch answers the p2p queries from a
+// contraction hierarchy, whose preprocessing is reported once as ch_build; it
+// only runs when asked for with --only.
+
+typedef Graph<PooledLabel, int> BenchGraph;
+
+#define PIVOT_LIMIT 5000
+#define MAX_RMAT_SCALE 30
+#define VERIFY_QUERIES 200
+#define VERIFY_MATRIX_LIMIT 2000
+#define VERIFY_HIERARCHY_LIMIT 1000
+#define VERIFY_UPDATES 500
+
+struct Options
+{
+    std::string kind;
+    unsigned size;
+    unsigned degree;
+    int min_weight;
+    int max_weight;
+    unsigned long seed;
+    unsigned reps;
+    bool directed;
+    std::string only;
+    std::string stats;
+    bool verify;
+};
+
+struct Loader
+{
+    BenchGraph* g;
+
+    BenchGraph::Vertex* get_vertex(const char* data, size_t size)
+    {
+        PooledLabel name = g->intern_label(data, size);
+        BenchGraph::Vertex* vertex = g->get_vertex_data(name);
+        return vertex ? vertex : g->add_vertex(name);
+    }
+
+    void vertex(const char* data, size_t size) { get_vertex(data, size); }
+
+    void edge(const char* src, size_t srclen, const char* dst, size_t dstlen, double weight)
+    {
+        BenchGraph::Vertex* v1 = get_vertex(src, srclen);
+        BenchGraph::Vertex* v2 = get_vertex(dst, dstlen);
+        g->add_edge((int) weight, v1, v2);
+    }
+};
+
+// peak resident set in kilobytes, 0 when unknown
+long peak_rss_kb()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
+
+// nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, double p)
+{
+    unsigned rank = (unsigned) (p / 100 * sorted.size() + 0.999999);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+class Bench
+{
+
+private:
+    const Options& options;
+    const BenchGraph& g;
+    unsigned long state;
+    StatsLog* log;
+
+public:
+    Bench(const Options& options, const BenchGraph& g, StatsLog* log) : options(options), g(g)
+    {
+        this->state = options.seed;
+        this->log = log;
+    }
+
+    bool enabled(const char* name) const
+    {
+        if (options.only.empty())
+            return true;
+        std::string list = "," + options.only + ",";
+        return list.find("," + std::string(name) + ",") != std::string::npos;
+    }
+
+    // seeded query vertex
+    BenchGraph::Vertex* pick()
+    {
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+        return g.get_vertex((unsigned) ((state >> 33) % g.num_vertices()));
+    }
+
+    // op() returns the number of items it produced, reported as "items"
+    template<class OP>
+    void run(const char* name, unsigned reps, OP op)
+    {
+        if (!enabled(name))
+            return;
+
+        std::vector<double> seconds;
+        unsigned long items = 0;
+        QueryStats stats;
+        for (unsigned r = 0; r < reps; r++)
+        {
+            thread_query_stats().clear();
+            auto t0 = std::chrono::steady_clock::now();
+            items += op();
+            auto t1 = std::chrono::steady_clock::now();
+            seconds.push_back(std::chrono::duration<double>(t1 - t0).count());
+            stats += thread_query_stats();
+        }
+        log->record(name, stats);
+        report(name, seconds, items, stats);
+    }
+
+    void report(const char* name, std::vector<double> seconds, unsigned long items, const QueryStats& stats)
+    {
+        std::sort(seconds.begin(), seconds.end());
+        double total = 0;
+        for (unsigned i = 0; i < seconds.size(); i++)
+            total += seconds[i];
+        double mean = total / seconds.size();
+
+        char line[1024];
+        std::snprintf(line, sizeof(line),
+            "{\"op\":\"%s\",\"graph\":\"%s\",\"directed\":%s,\"vertices\":%u,\"edges\":%u,\"seed\":%lu,"
+            "\"reps\":%u,\"items\":%lu,\"mean_ms\":%.3f,\"min_ms\":%.3f,\"p50_ms\":%.3f,\"p90_ms\":%.3f,"
+            "\"p99_ms\":%.3f,\"max_ms\":%.3f,\"edges_per_sec\":%.0f,\"peak_rss_kb\":%ld",
+            name, options.kind.c_str(), g.is_directed() ? "true" : "false", g.num_vertices(), g.num_edges(), options.seed,
+            (unsigned) seconds.size(), items, mean * 1e3, seconds.front() * 1e3, percentile(seconds, 50) * 1e3,
+            percentile(seconds, 90) * 1e3, percentile(seconds, 99) * 1e3, seconds.back() * 1e3,
+            mean > 0 ? g.num_edges() / mean : 0.0, peak_rss_kb());
+#ifdef ALGO_STATS
+        std::cout << line << ",\"stats\":" << stats.json() << "}" << std::endl;
+#else
+        (void) stats;
+        std::cout << line << "}" << std::endl;
+#endif
+    }
+};
+
+// Answers every engine should agree on, one JSON line per check with the
+// number of cases and of mismatches:
+//  - mst: Prim, Kruskal and Boruvka give forests of the same size and weight,
+//    one edge short of a tree per component, and the tree of the first
+//    vertex spans its component, on the graph and on a copy with a separate
+//    component and an isolated vertex added (undirected only);
+//  - paths: seeded pairs get paths of the same weight, or none, from Dijkstra
+//    with each queue policy, the bidirectional search and A* with a zero
+//    heuristic;
+//  - matrix: on graphs of up to VERIFY_MATRIX_LIMIT vertices, the all-pairs
+//    distances and paths of seeded pairs match Dijkstra;
+//  - ch: on graphs of up to VERIFY_HIERARCHY_LIMIT vertices, since contraction
+//    is slow on dense cores, contraction hierarchy paths match Dijkstra;
+//  - dynamic: on a copy under random insertions, removals and weight changes,
+//    a DynamicShortestPathTree keeps the distances of a tree grown from
+//    scratch and a DynamicSpanningForest the weight of Kruskal's forest.
+class Verifier
+{
+
+private:
+    const Options& options;
+    unsigned long state;
+    bool ok;
+
+    unsigned random(unsigned n)
+    {
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+        return (unsigned) ((state >> 33) % n);
+    }
+
+    void report(const char* check, unsigned long cases, unsigned long mismatches)
+    {
+        std::cout << "{\"op\":\"verify\",\"check\":\"" << check << "\",\"graph\":\"" << options.kind
+                  << "\",\"seed\":" << options.seed << ",\"cases\":" << cases << ",\"mismatches\":" << mismatches
+                  << "}" << std::endl;
+        ok = ok && mismatches == 0;
+    }
+
+    // edges and total weight
+    template<class ITERATOR>
+    static std::pair<unsigned, long> measure(ITERATOR it)
+    {
+        std::pair<unsigned, long> m(0, 0);
+        for (; it.has_next(); it.next())
+        {
+            m.first ++;
+            m.second += it.current()->get_weight();
+        }
+        return m;
+    }
+
+    template<class ITERATOR>
+    static bool same_path(const BenchGraph& g, ITERATOR it, BenchGraph::Vertex* start, BenchGraph::Vertex* end, long expected)
+    {
+        std::vector<BenchGraph::Edge*> path;
+        for (; it.has_next(); it.next())
+            path.push_back(it.current());
+        if (path.empty())
+            return expected < 0 || start == end;
+
+        // leads from start to end with the expected weight; the edges may
+        // come in either order, so walk them from whichever end is start
+        bool forward = path.front()->get_source() == start || path.front()->get_destination() == start;
+        BenchGraph::Vertex* v = start;
+        long weight = 0;
+        for (unsigned i = 0; i < path.size(); i++)
+        {
+            BenchGraph::Edge* e = forward ? path[i] : path[path.size() - 1 - i];
+            if (e->get_source() == v)
+                v = e->get_destination();
+            else if (!g.is_directed() && e->get_destination() == v)
+                v = e->get_source();
+            else
+                return false;
+            weight += e->get_weight();
+        }
+        return v == end && weight == expected;
+    }
+
+    unsigned long check_forests(const BenchGraph& g)
+    {
+        std::pair<unsigned, long> prim = measure(g.min_spanning_tree_iterator(BenchGraph::PRIM));
+        std::pair<unsigned, long> kruskal = measure(g.min_spanning_tree_iterator(BenchGraph::KRUSKAL));
+        std::pair<unsigned, long> boruvka = measure(g.min_spanning_tree_iterator(BenchGraph::BORUVKA));
+        std::pair<unsigned, long> plain = measure(g.min_spanning_tree_iterator());
+        unsigned expected = g.num_vertices() - g.components().num_components();
+        unsigned first = measure(g.component_spanning_tree_iterator(g.get_vertex(0))).first;
+        return (prim != kruskal) + (boruvka != kruskal) + (plain != kruskal) + (kruskal.first != expected)
+            + (first + 1 != g.components().component_size(0));
+    }
+
+    // weight of the Dijkstra path, -1 when there is none
+    static long reference_weight(const BenchGraph& g, BenchGraph::Vertex* start, BenchGraph::Vertex* end)
+    {
+        if (start == end)
+            return 0;
+        auto reference = g.shortest_path_iterator(start, end);
+        return reference.has_next() ? measure(reference).second : -1;
+    }
+
+public:
+    Verifier(const Options& options) : options(options)
+    {
+        this->state = options.seed;
+        this->ok = true;
+    }
+
+    bool passed() const { return ok; }
+
+    void spanning_trees(const BenchGraph& g)
+    {
+        if (g.is_directed())
+            return;
+
+        BenchGraph split = g.clone();
+        BenchGraph::Vertex* a = split.add_vertex(split.intern_label("verify_a"));
+        BenchGraph::Vertex* b = split.add_vertex(split.intern_label("verify_b"));
+        BenchGraph::Vertex* c = split.add_vertex(split.intern_label("verify_c"));
+        split.add_vertex(split.intern_label("verify_d"));
+        split.add_edge(1, a, b);
+        split.add_edge(2, b, c);
+        split.add_edge(3, a, c);
+        report("mst", 2, check_forests(g) + check_forests(split));
+    }
+
+    void paths(const BenchGraph& g, unsigned queries)
+    {
+        unsigned long mismatches = 0;
+        for (unsigned q = 0; q < queries; q++)
+        {
+            BenchGraph::Vertex* start = g.get_vertex(random(g.num_vertices()));
+            BenchGraph::Vertex* end = g.get_vertex(random(g.num_vertices()));
+            long expected = reference_weight(g, start, end);
+
+            mismatches += !same_path(g, g.shortest_path_iterator<BucketQueue>(start, end), start, end, expected);
+            mismatches += !same_path(g, g.shortest_path_iterator<RadixHeap>(start, end), start, end, expected);
+            mismatches += !same_path(g, g.bidirectional_shortest_path_iterator(start, end), start, end, expected);
+            mismatches += !same_path(g, g.astar_path_iterator(start, end, [](BenchGraph::Vertex*) { return 0; }), start, end, expected);
+        }
+        report("paths", queries, mismatches);
+    }
+
+    void matrix(const BenchGraph& g, unsigned queries)
+    {
+        if (g.num_vertices() > VERIFY_MATRIX_LIMIT)
+            return;
+
+        DistanceMatrix<int> matrix = g.all_pairs_distances();
+        unsigned long mismatches = 0;
+        for (unsigned q = 0; q < queries; q++)
+        {
+            BenchGraph::Vertex* start = g.get_vertex(random(g.num_vertices()));
+            BenchGraph::Vertex* end = g.get_vertex(random(g.num_vertices()));
+            long expected = reference_weight(g, start, end);
+            unsigned u = start->get_index();
+            unsigned v = end->get_index();
+
+            if (expected < 0)
+                mismatches += matrix.is_reachable(u, v);
+            else
+                mismatches += !matrix.is_reachable(u, v) || matrix.distance(u, v) != expected;
+            mismatches += !same_path(g, g.all_pairs_path_iterator(matrix, start, end), start, end, expected);
+        }
+        report("matrix", queries, mismatches);
+    }
+
+    void hierarchy(const BenchGraph& g, unsigned queries)
+    {
+        if (g.num_vertices() > VERIFY_HIERARCHY_LIMIT)
+            return;
+
+        ContractionHierarchy<int> hierarchy = g.contraction_hierarchy();
+        unsigned long mismatches = 0;
+        for (unsigned q = 0; q < queries; q++)
+        {
+            BenchGraph::Vertex* start = g.get_vertex(random(g.num_vertices()));
+            BenchGraph::Vertex* end = g.get_vertex(random(g.num_vertices()));
+            long expected = reference_weight(g, start, end);
+            mismatches += !same_path(g, g.hierarchy_path_iterator(hierarchy, start, end), start, end, expected);
+        }
+        report("ch", queries, mismatches);
+    }
+
+    void dynamic(const BenchGraph& g, unsigned updates)
+    {
+        BenchGraph h = g.clone();
+        DynamicShortestPathTree<BenchGraph> tree(h, h.get_vertex(0));
+        DynamicSpanningForest<BenchGraph> forest(h);
+
+        unsigned long mismatches = 0;
+        unsigned checks = 0;
+        for (unsigned u = 0; u < updates; u++)
+        {
+            unsigned kind = random(3);
+            if (kind == 0 || h.num_edges() == 0)
+            {
+                int weight = options.min_weight + random(options.max_weight - options.min_weight + 1);
+                h.add_edge(weight, h.get_vertex(random(h.num_vertices())), h.get_vertex(random(h.num_vertices())));
+            }
+            else if (kind == 1)
+                h.remove_edge(h.get_edge(random(h.num_edges())));
+            else
+                h.get_edge(random(h.num_edges()))->set_weight(options.min_weight + random(options.max_weight - options.min_weight + 1));
+
+            if (u % 50 != 49 && u + 1 != updates)
+                continue;
+
+            DynamicShortestPathTree<BenchGraph> scratch(h, h.get_vertex(0));
+            for (unsigned v = 0; v < h.num_vertices(); v++)
+            {
+                BenchGraph::Vertex* vertex = h.get_vertex(v);
+                mismatches += tree.is_reachable(vertex) != scratch.is_reachable(vertex)
+                    || (scratch.is_reachable(vertex) && tree.get_distance(vertex) != scratch.get_distance(vertex));
+            }
+            h.remove_listener(&scratch);
+            std::pair<unsigned, long> kruskal = measure(h.min_spanning_tree_iterator(BenchGraph::KRUSKAL));
+            mismatches += forest.size() != kruskal.first || forest.get_weight() != kruskal.second;
+            checks ++;
+        }
+        h.remove_listener(&forest);
+        h.remove_listener(&tree);
+        report("dynamic", checks, mismatches);
+    }
+};
+
+void load(const std::string& filename, BenchGraph& g)
+{
+    DotReader reader(filename);
+    BenchGraph loaded(reader.is_directed());
+    loaded.set_vertex_index(true);
+    Loader loader = { &loaded };
+    reader.read(loader);
+    g = std::move(loaded);
+}
+
+void parallel_load(const std::string& filename, BenchGraph& g)
+{
+    ParallelDotLoader loader(filename);
+    BenchGraph loaded(loader.is_directed());
+    loaded.set_vertex_index(true);
+    loader.build(loaded);
+    g = std::move(loaded);
+}
+
+bool parse(int argc, char** argv, Options& o)
+{
+    o.kind = "random";
+    o.size = 10000;
+    o.degree = 8;
+    o.min_weight = 1;
+    o.max_weight = 100;
+    o.seed = 1;
+    o.reps = 10;
+    o.directed = false;
+    o.verify = false;
+
+    unsigned positional = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--degree" && has_value)
+            o.degree = std::atoi(argv[++i]);
+        else if (arg == "--weights" && has_value && std::sscanf(argv[++i], "%d-%d", &o.min_weight, &o.max_weight) == 2)
+            continue;
+        else if (arg == "--seed" && has_value)
+            o.seed = std::strtoul(argv[++i], 0, 10);
+        else if (arg == "--reps" && has_value)
+            o.reps = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--directed")
+            o.directed = true;
+        else if (arg == "--only" && has_value)
+            o.only = argv[++i];
+        else if (arg == "--stats" && has_value)
+            o.stats = argv[++i];
+        else if (arg == "--verify")
+            o.verify = true;
+        else if (arg[0] != '-' && positional == 0)
+        {
+            o.kind = arg;
+            positional ++;
+        }
+        else if (arg[0] != '-' && positional == 1)
+        {
+            o.size = std::atoi(arg.c_str());
+            positional ++;
+        }
+        else
+            return false;
+    }
+    if (o.kind == "rmat" && o.size > MAX_RMAT_SCALE)
+        return false;
+    return o.kind == "random" || o.kind == "grid" || o.kind == "rmat" || o.kind == "dense";
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse(argc, argv, options))
+    {
+        std::cerr << "usage: benchmark [random|grid|rmat|dense] [size] [--degree D] [--weights A-B]"
+                  << " [--seed S] [--reps R] [--directed] [--only a,b] [--stats FILE] [--verify]" << std::endl;
+        std::cerr << "rmat takes a scale, 2^scale vertices, of at most " << MAX_RMAT_SCALE << std::endl;
+        return 1;
+    }
+
+    GraphGenerator generator(options.seed, options.min_weight, options.max_weight, options.directed);
+    GeneratedGraph generated;
+    if (options.kind == "grid")
+        generated = generator.grid(options.size, options.size);
+    else if (options.kind == "rmat")
+        generated = generator.rmat(options.size, options.degree);
+    else if (options.kind == "dense")
+        generated = generator.dense(options.size);
+    else
+        generated = generator.random(options.size, (unsigned long) options.size * options.degree);
+
+    std::string filename = "benchmark_input.dot";
+    if (generated.nvertices == 0 || !generated.write_dot(filename))
+    {
+        std::cerr << "could not write " << filename << std::endl;
+        return 1;
+    }
+
+    // every run loads the file afresh; the last copy is kept for the queries
+    StatsLog log;
+    BenchGraph g(options.directed);
+    if (options.verify)
+    {
+        load(filename, g);
+        std::remove(filename.c_str());
+        Verifier verifier(options);
+        verifier.spanning_trees(g);
+        verifier.paths(g, VERIFY_QUERIES);
+        verifier.matrix(g, VERIFY_QUERIES);
+        verifier.hierarchy(g, VERIFY_QUERIES);
+        verifier.dynamic(g, VERIFY_UPDATES);
+        return verifier.passed() ? 0 : 1;
+    }
+    Bench loading(options, g, &log);
+    loading.run("load", options.reps, [&]() -> unsigned long {
+        load(filename, g);
+        return g.num_edges();
+    });
+    loading.run("pload", options.reps, [&]() -> unsigned long {
+        parallel_load(filename, g);
+        return g.num_edges();
+    });
+    if (g.num_vertices() == 0)
+    {
+        load(filename, g);
+    }
+    std::remove(filename.c_str());
+
+    // trees must be grown on every run, not served from the cache
+    g.set_tree_cache_capacity(0);
+    g.freeze();
+
+    // where the bytes of the loaded graph go
+    BenchGraph::MemoryUsage usage = g.memory_usage();
+    std::cout << "{\"op\":\"memory\",\"vertices\":" << g.num_vertices() << ",\"edges\":" << g.num_edges()
+              << ",\"vertex_bytes\":" << usage.vertices << ",\"label_bytes\":" << usage.labels
+              << ",\"adjacency_bytes\":" << usage.adjacency << ",\"edge_bytes\":" << usage.edges
+              << ",\"table_bytes\":" << usage.tables << ",\"index_bytes\":" << usage.index
+              << ",\"compact_bytes\":" << usage.compact << ",\"total_bytes\":" << usage.total() << "}" << std::endl;
+
+    const BenchGraph& graph = g;
+    Bench bench(options, graph, &log);
+
+    bench.run("mst", options.reps, [&]() -> unsigned long {
+        unsigned long n = 0;
+        for (auto it = graph.min_spanning_tree_iterator(); it.has_next(); it.next())
+            n ++;
+        return n;
+    });
+
+    bench.run("sssp", options.reps, [&]() -> unsigned long {
+        unsigned long n = 0;
+        for (auto it = graph.shortest_path_tree_iterator(bench.pick()); it.has_next(); it.next())
+            n ++;
+        return n;
+    });
+
+    bench.run("p2p", options.reps, [&]() -> unsigned long {
+        unsigned long n = 0;
+        BenchGraph::Vertex* start = bench.pick();
+        for (auto it = graph.shortest_path_iterator(start, bench.pick()); it.has_next(); it.next())
+            n ++;
+        return n;
+    });
+
+    bench.run("bfs", options.reps, [&]() -> unsigned long {
+        unsigned long n = 0;
+        for (auto it = graph.breadth_first_iterator(bench.pick()); it.has_next(); it.next())
+            n ++;
+        return n;
+    });
+
+    bench.run("dfs", options.reps, [&]() -> unsigned long {
+        unsigned long n = 0;
+        for (auto it = graph.depth_first_iterator(bench.pick()); it.has_next(); it.next())
+            n ++;
+        return n;
+    });
+
+    if (!options.only.empty() || graph.num_vertices() <= PIVOT_LIMIT)
+    {
+        bench.run("pivot", options.only.empty() ? 1 : options.reps, [&]() -> unsigned long {
+            return graph.pivot_vertex() ? graph.num_vertices() : 0;
+        });
+    }
+
+    if (!options.only.empty() && bench.enabled("ch"))
+    {
+        thread_query_stats().clear();
+        auto t0 = std::chrono::steady_clock::now();
+        ContractionHierarchy<int> hierarchy = graph.contraction_hierarchy();
+        auto t1 = std::chrono::steady_clock::now();
+        log.record("ch_build", thread_query_stats());
+        bench.report("ch_build", std::vector<double>(1, std::chrono::duration<double>(t1 - t0).count()), hierarchy.num_shortcuts(), thread_query_stats());
+
+        bench.run("ch", options.reps, [&]() -> unsigned long {
+            unsigned long n = 0;
+            BenchGraph::Vertex* start = bench.pick();
+            for (auto it = graph.hierarchy_path_iterator(hierarchy, start, bench.pick()); it.has_next(); it.next())
+                n ++;
+            return n;
+        });
+    }
+
+    if (!options.stats.empty())
+    {
+        bool json = options.stats.size() > 5 && options.stats.compare(options.stats.size() - 5, 5, ".json") == 0;
+        if (!(json ? log.write_json(options.stats) : log.write_csv(options.stats)))
+        {
+            std::cerr << "could not write " << options.stats << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
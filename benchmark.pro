@@ -0,0 +1,41 @@
+TEMPLATE = app
+TARGET = benchmark
+CONFIG += console c++11 thread release
+CONFIG -= app_bundle
+CONFIG -= qt
+
+SOURCES += benchmark.cpp
+
+HEADERS += \
+    graph.hpp \
+    compact_graph.hpp \
+    weights.hpp \
+    dot_reader.hpp \
+    parallel_loader.hpp \
+    string_pool.hpp \
+    graph_snapshot.hpp \
+    priority_queues.hpp \
+    parallel.hpp \
+    disjoint_set.hpp \
+    label_index.hpp \
+    pooled_label.hpp \
+    components.hpp \
+    spanning_forest.hpp \
+    thread_pool.hpp \
+    all_sources.hpp \
+    distance_matrix.hpp \
+    contraction_hierarchy.hpp \
+    tree_cache.hpp \
+    batch_paths.hpp \
+    traversal.hpp \
+    parallel_bfs.hpp \
+    arena.hpp \
+    overlay.hpp \
+    dot_writer.hpp \
+    subgraph_mask.hpp \
+    generator.hpp \
+    instrumentation.hpp \
+    dynamic_sssp.hpp \
+    dynamic_msf.hpp
+
+# DEFINES += ALGO_STATS to report the engine counters, see instrumentation.hpp
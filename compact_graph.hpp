@@ -0,0 +1,828 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <utility>
+
+#include "priority_queues.hpp"
+#include "weights.hpp"
+#include "instrumentation.hpp"
+
+
+// Subgraph filter of the engines: vertex(v) and edge(e) tell whether a vertex
+// and an edge take part, and an arc is only followed when both its edge and
+// its target do. WholeGraph keeps everything, so the tests compile away; see
+// SubgraphMask for a restriction.
+struct WholeGraph
+{
+    bool vertex(unsigned) const { return true; }
+    bool edge(unsigned) const { return true; }
+};
+
+
+// Frozen, compressed sparse row form of a graph. Vertices and edges are
+// addressed by their index in the originating Graph; the adjacency of vertex v
+// is the contiguous range of arcs [begin(v), end(v)). The arrays are either
+// owned or borrowed from external memory such as a mapped GraphSnapshot.
+template<class EDATA>
+class CompactGraph
+{
+
+public:
+    static const unsigned NONE = ~0u;
+
+    struct ShortestPathTree
+    {
+        std::vector<EDATA> distance;
+        std::vector<unsigned> parent;   // edge reaching each vertex, NONE for roots and unreached vertices
+    };
+
+    // One direction of a Dijkstra or A* search. Between two searches only the
+    // vertices touched by the previous one are reset, so a Search kept around
+    // makes short point-to-point queries independent of the graph size.
+    template<class QUEUE>
+    class Search
+    {
+
+    private:
+        enum { UNSEEN, LABELED, SETTLED };
+
+        QUEUE queue;
+        std::vector<unsigned char> state;
+        std::vector<unsigned> touched;
+        EDATA infinity;
+
+    public:
+        struct NoVisit
+        {
+            void operator()(Search&, unsigned, unsigned, EDATA, unsigned) {}
+        };
+
+        std::vector<EDATA> distance;
+        std::vector<unsigned> parent;
+
+        void start(unsigned n, unsigned source, EDATA zero, EDATA infinity, uint64_t key)
+        {
+            if (state.size() != n || this->infinity != infinity || distance.size() != n)
+            {
+                state.assign(n, UNSEEN);
+                distance.assign(n, infinity);
+                parent.assign(n, NONE);
+                touched.clear();
+                queue.reset(n);
+            }
+            else
+            {
+                for (unsigned i = 0; i < touched.size(); i++)
+                {
+                    unsigned v = touched[i];
+                    state[v] = UNSEEN;
+                    distance[v] = infinity;
+                    parent[v] = NONE;
+                }
+                touched.clear();
+                while (!queue.empty())
+                    queue.pop();
+            }
+            this->infinity = infinity;
+            label(source, zero, NONE, key);
+        }
+
+        Search() { infinity = EDATA(); }
+
+        bool empty() const { return queue.empty(); }
+        bool is_reached(unsigned v) const { return state[v] != UNSEEN; }
+        bool is_settled(unsigned v) const { return state[v] == SETTLED; }
+        const std::vector<unsigned>& touched_vertices() const { return touched; }
+
+        void label(unsigned v, EDATA total, unsigned edge, uint64_t key)
+        {
+            if (state[v] == UNSEEN)
+                touched.push_back(v);
+            else if (state[v] == LABELED)
+                STATS_COUNT(decrease_keys);
+            STATS_COUNT(queue_pushes);
+            state[v] = LABELED;
+            distance[v] = total;
+            parent[v] = edge;
+            queue.push(v, key);
+        }
+
+        // Pops the closest labeled vertex, relaxes its arcs and returns it.
+        // reopen lets an improved settled vertex back in (inconsistent A* heuristics);
+        // visit sees every scanned arc as (search, vertex, target, weight, edge);
+        // arcs the filter leaves out are skipped.
+        template<class KEY, class VISIT, class FILTER>
+        unsigned settle(const CompactGraph& g, KEY& key, bool reopen, VISIT& visit, const FILTER& filter)
+        {
+            unsigned v = queue.pop();
+            state[v] = SETTLED;
+            EDATA vtotal = distance[v];
+            STATS_COUNT(queue_pops);
+            STATS_COUNT(settled);
+            STATS_ADD(relaxations, g.end(v) - g.begin(v));
+
+            for (unsigned a = g.begin(v); a < g.end(v); a++)
+            {
+                unsigned t = g.target(a);
+                if (!filter.edge(g.edge(a)) || !filter.vertex(t))
+                    continue;
+                EDATA w = g.weight(a);
+                visit(*this, v, t, w, g.edge(a));
+
+                if (!reopen && state[t] == SETTLED)
+                    continue;
+                EDATA newtotal = vtotal + w;
+                if (newtotal < distance[t])
+                    label(t, newtotal, g.edge(a), key(t, newtotal));
+            }
+            return v;
+        }
+
+        template<class KEY, class VISIT>
+        unsigned settle(const CompactGraph& g, KEY& key, bool reopen, VISIT& visit)
+        {
+            return settle(g, key, reopen, visit, WholeGraph());
+        }
+
+        template<class KEY>
+        unsigned settle(const CompactGraph& g, KEY& key, bool reopen)
+        {
+            NoVisit visit;
+            return settle(g, key, reopen, visit);
+        }
+
+        // edges from end back to the source, empty when end was not reached
+        std::vector<unsigned> path_to(const CompactGraph& g, unsigned end) const
+        {
+            std::vector<unsigned> path;
+            for (unsigned v = end; parent[v] != NONE; v = g.opposite(parent[v], v))
+            {
+                path.push_back(parent[v]);
+            }
+            return path;
+        }
+    };
+
+private:
+    struct Storage
+    {
+        std::vector<unsigned> offsets;
+        std::vector<unsigned> targets;
+        std::vector<unsigned> arc_edges;
+        std::vector<EDATA> weights;
+
+        std::vector<unsigned> sources;
+        std::vector<unsigned> destinations;
+        std::vector<EDATA> edge_weights;
+    };
+
+    bool directed;
+    bool owned;
+    unsigned nvertices;
+    unsigned nedges;
+    unsigned narcs;
+    Storage storage;
+
+    const unsigned* offsets;
+    const unsigned* targets;
+    const unsigned* arc_edges;
+    const EDATA* weights;
+
+    const unsigned* sources;
+    const unsigned* destinations;
+    const EDATA* edge_weights;
+
+    void bind_storage()
+    {
+        owned = true;
+        nvertices = storage.offsets.size() - 1;
+        nedges = storage.sources.size();
+        narcs = storage.targets.size();
+        offsets = storage.offsets.data();
+        targets = storage.targets.data();
+        arc_edges = storage.arc_edges.data();
+        weights = storage.weights.data();
+        sources = storage.sources.data();
+        destinations = storage.destinations.data();
+        edge_weights = storage.edge_weights.data();
+    }
+
+    template<class FILTER>
+    class SpanningTreeBuilder
+    {
+
+    private:
+        struct Token
+        {
+            EDATA priority;
+            unsigned edge;
+            Token(EDATA p, unsigned e) { priority = p; edge = e; }
+            bool operator<(const Token &o) const { return priority > o.priority; }
+        };
+
+        const CompactGraph* graph;
+        const FILTER* filter;
+        std::priority_queue<Token> queue;
+        std::vector<bool> missing;
+        unsigned num_missing;
+        unsigned first_missing;
+        unsigned limit;
+        bool whole;             // spanning forest rather than the tree of start
+        std::vector<unsigned> tree;
+
+        void visit_vertex(unsigned v)
+        {
+            for (unsigned a = graph->begin(v); a < graph->end(v); a++)
+            {
+                if (missing[graph->target(a)] && filter->edge(graph->edge(a)))
+                {
+                    queue.push(Token(graph->weight(a), graph->edge(a)));
+                    STATS_COUNT(queue_pushes);
+                }
+            }
+            STATS_COUNT(settled);
+            STATS_ADD(relaxations, graph->end(v) - graph->begin(v));
+            missing[v] = false;
+            num_missing --;
+            limit --;
+        }
+
+        unsigned get_next_vertex()
+        {
+            unsigned v = NONE;
+            unsigned e = queue.top().edge;
+            queue.pop();
+            unsigned s = graph->edge_source(e);
+            unsigned d = graph->edge_destination(e);
+
+            if (missing[s])
+            {
+                v = s;
+                tree.push_back(e);
+            }
+
+            if (missing[d])
+            {
+                v = d;
+                tree.push_back(e);
+            }
+
+            STATS_COUNT(queue_pops);
+            if (v == NONE)
+                STATS_COUNT(stale_pops);
+            return v;
+        }
+
+    public:
+        // Vertices the filter leaves out are never missing. Once limit vertices
+        // are in, or the tree of start is done when limit is not NONE, the
+        // search ends rather than going on to other components.
+        SpanningTreeBuilder(const CompactGraph* g, unsigned start, const FILTER& filter, unsigned limit = NONE)
+        {
+            this->graph = g;
+            this->filter = &filter;
+            this->limit = limit;
+            this->whole = limit == NONE;
+            missing.resize(g->num_vertices());
+            num_missing = 0;
+            for (unsigned v = 0; v < g->num_vertices(); v++)
+            {
+                missing[v] = filter.vertex(v);
+                num_missing += missing[v];
+            }
+            first_missing = 0;
+            if (start < g->num_vertices() && missing[start])
+            {
+                visit_vertex(start);
+            }
+        }
+
+        std::vector<unsigned> get()
+        {
+            while (num_missing && limit)
+            {
+                // an isolated vertex leaves the queue empty, so go on to the
+                // next component unless only the tree of start is wanted
+                if (queue.empty())
+                {
+                    if (!whole)
+                        break;
+                    while (!missing[first_missing])
+                    {
+                        first_missing ++;
+                    }
+                    visit_vertex(first_missing);
+                    continue;
+                }
+
+                unsigned v = get_next_vertex();
+                if (v != NONE)
+                {
+                    visit_vertex(v);
+                }
+            }
+
+            return tree;
+        }
+    };
+
+    template<class WEIGHTS>
+    struct DistanceKey
+    {
+        const WEIGHTS* weights;
+        DistanceKey(const WEIGHTS* w) { weights = w; }
+        uint64_t operator()(unsigned, EDATA total) { return weights->priority(total); }
+    };
+
+    template<class WEIGHTS, class HEURISTIC>
+    struct HeuristicKey
+    {
+        const WEIGHTS* weights;
+        HEURISTIC* heuristic;
+        HeuristicKey(const WEIGHTS* w, HEURISTIC* h) { weights = w; heuristic = h; }
+        uint64_t operator()(unsigned v, EDATA total) { return weights->priority(total + (*heuristic)(v)); }
+    };
+
+    template<class QUEUE, class WEIGHTS, class FILTER>
+    class ShortestPathTreeBuilder
+    {
+
+    private:
+        const CompactGraph* graph;
+        Search<QUEUE>* search;
+        const WEIGHTS* weights;
+        const FILTER* filter;
+
+    public:
+        ShortestPathTreeBuilder(const CompactGraph* g, Search<QUEUE>* search, unsigned start, const WEIGHTS& weights, const FILTER& filter)
+        {
+            this->graph = g;
+            this->search = search;
+            this->weights = &weights;
+            this->filter = &filter;
+            EDATA zero = weights.zero();
+            search->start(g->num_vertices(), start, zero, weights.infinity(), weights.priority(zero));
+        }
+
+        // stops as soon as end is settled when end != NONE
+        void run(unsigned end = NONE)
+        {
+            DistanceKey<WEIGHTS> key(weights);
+            typename Search<QUEUE>::NoVisit visit;
+            while (!search->empty())
+            {
+                if (search->settle(*graph, key, false, visit, *filter) == end)
+                    break;
+            }
+        }
+    };
+
+    template<class QUEUE, class WEIGHTS, class FILTER>
+    class BidirectionalBuilder
+    {
+
+    private:
+        struct Best
+        {
+            EDATA cost;
+            unsigned edge;
+            unsigned forward_vertex;
+            unsigned backward_vertex;
+        };
+
+        // records the cheapest arc joining both search frontiers
+        struct Meeting
+        {
+            Search<QUEUE>* other;
+            Best* best;
+            bool forward;
+
+            void operator()(Search<QUEUE>& self, unsigned v, unsigned t, EDATA w, unsigned e)
+            {
+                if (!other->is_reached(t))
+                    return;
+                EDATA cost = self.distance[v] + w + other->distance[t];
+                if (cost < best->cost)
+                {
+                    best->cost = cost;
+                    best->edge = e;
+                    best->forward_vertex = forward ? v : t;
+                    best->backward_vertex = forward ? t : v;
+                }
+            }
+        };
+
+        const CompactGraph* graph;
+        const CompactGraph* reverse;
+        Search<QUEUE>* forward;
+        Search<QUEUE>* backward;
+        const WEIGHTS* weights;
+        const FILTER* filter;
+        unsigned start;
+        unsigned end;
+
+    public:
+        BidirectionalBuilder(const CompactGraph* g, const CompactGraph* reverse, Search<QUEUE>* forward, Search<QUEUE>* backward,
+                             unsigned start, unsigned end, const WEIGHTS& weights, const FILTER& filter)
+        {
+            this->graph = g;
+            this->forward = forward;
+            this->backward = backward;
+            this->reverse = reverse;
+            this->weights = &weights;
+            this->filter = &filter;
+            this->start = start;
+            this->end = end;
+            EDATA zero = weights.zero();
+            forward->start(g->num_vertices(), start, zero, weights.infinity(), weights.priority(zero));
+            backward->start(g->num_vertices(), end, zero, weights.infinity(), weights.priority(zero));
+        }
+
+        std::vector<unsigned> get()
+        {
+            std::vector<unsigned> path;
+            if (start == end)
+            {
+                return path;
+            }
+
+            Best best = { weights->infinity(), NONE, NONE, NONE };
+            Meeting fmeet = { backward, &best, true };
+            Meeting bmeet = { forward, &best, false };
+            DistanceKey<WEIGHTS> key(weights);
+
+            // alternate until some vertex is settled from both sides
+            while (!forward->empty() && !backward->empty())
+            {
+                unsigned v = forward->settle(*graph, key, false, fmeet, *filter);
+                if (backward->is_settled(v))
+                    break;
+                v = backward->settle(*reverse, key, false, bmeet, *filter);
+                if (forward->is_settled(v))
+                    break;
+            }
+
+            if (best.edge == NONE)
+            {
+                return path;
+            }
+
+            // edges run from end back to start, as for the one-sided search
+            path = backward->path_to(*graph, best.backward_vertex);
+            std::reverse(path.begin(), path.end());
+            path.push_back(best.edge);
+            std::vector<unsigned> head = forward->path_to(*graph, best.forward_vertex);
+            path.insert(path.end(), head.begin(), head.end());
+            return path;
+        }
+    };
+
+    // A* with a user heuristic giving a lower bound of the distance from a
+    // vertex to end. Settled vertices are reopened if the heuristic turns out
+    // inconsistent, so admissibility is enough for exact results.
+    template<class HEURISTIC, class WEIGHTS, class FILTER>
+    class AStarBuilder
+    {
+
+    private:
+        const CompactGraph* graph;
+        Search<DaryHeap<> >* search;
+        const WEIGHTS* weights;
+        const FILTER* filter;
+        HEURISTIC heuristic;
+        unsigned end;
+
+    public:
+        AStarBuilder(const CompactGraph* g, Search<DaryHeap<> >* search, unsigned start, unsigned end, HEURISTIC heuristic,
+                     const WEIGHTS& weights, const FILTER& filter)
+            : heuristic(heuristic)
+        {
+            this->graph = g;
+            this->search = search;
+            this->weights = &weights;
+            this->filter = &filter;
+            this->end = end;
+            EDATA zero = weights.zero();
+            search->start(g->num_vertices(), start, zero, weights.infinity(), weights.priority(zero + this->heuristic(start)));
+        }
+
+        std::vector<unsigned> get()
+        {
+            HeuristicKey<WEIGHTS, HEURISTIC> key(weights, &heuristic);
+            typename Search<DaryHeap<> >::NoVisit visit;
+            while (!search->empty())
+            {
+                if (search->settle(*graph, key, true, visit, *filter) == end)
+                    break;
+            }
+            return search->path_to(*graph, end);
+        }
+    };
+
+public:
+    CompactGraph()
+    {
+        directed = false;
+        storage.offsets.push_back(0);
+        bind_storage();
+    }
+
+    // Builds the adjacency with a counting sort on the edge list, so every
+    // vertex sees its arcs in edge-index order, just like Vertex::edges.
+    CompactGraph(bool dir, unsigned nvertices, const std::vector<unsigned>& src, const std::vector<unsigned>& dst, const std::vector<EDATA>& w)
+    {
+        directed = dir;
+        Storage& s = storage;
+        s.sources = src;
+        s.destinations = dst;
+        s.edge_weights = w;
+
+        s.offsets.assign(nvertices + 1, 0);
+        for (unsigned e = 0; e < src.size(); e++)
+        {
+            s.offsets[src[e] + 1] ++;
+            if (!directed)
+            {
+                s.offsets[dst[e] + 1] ++;
+            }
+        }
+        for (unsigned v = 0; v < nvertices; v++)
+        {
+            s.offsets[v + 1] += s.offsets[v];
+        }
+
+        unsigned narcs = s.offsets[nvertices];
+        s.targets.resize(narcs);
+        s.arc_edges.resize(narcs);
+        s.weights.resize(narcs);
+
+        std::vector<unsigned> fill(s.offsets.begin(), s.offsets.end() - 1);
+        for (unsigned e = 0; e < src.size(); e++)
+        {
+            unsigned a = fill[src[e]] ++;
+            s.targets[a] = dst[e];
+            s.arc_edges[a] = e;
+            s.weights[a] = w[e];
+
+            if (!directed)
+            {
+                a = fill[dst[e]] ++;
+                s.targets[a] = src[e];
+                s.arc_edges[a] = e;
+                s.weights[a] = w[e];
+            }
+        }
+        bind_storage();
+    }
+
+    // Borrows arrays laid out as above; they must outlive this graph.
+    CompactGraph(bool dir, unsigned nvertices, unsigned nedges, const unsigned* offsets, const unsigned* targets, const unsigned* arc_edges, const EDATA* weights,
+                 const unsigned* sources, const unsigned* destinations, const EDATA* edge_weights)
+    {
+        this->directed = dir;
+        this->owned = false;
+        this->nvertices = nvertices;
+        this->nedges = nedges;
+        this->narcs = offsets[nvertices];
+        this->offsets = offsets;
+        this->targets = targets;
+        this->arc_edges = arc_edges;
+        this->weights = weights;
+        this->sources = sources;
+        this->destinations = destinations;
+        this->edge_weights = edge_weights;
+    }
+
+    CompactGraph(const CompactGraph& o)
+    {
+        *this = o;
+    }
+
+    CompactGraph& operator=(const CompactGraph& o)
+    {
+        directed = o.directed;
+        storage = o.storage;
+        if (o.owned)
+        {
+            bind_storage();
+        }
+        else
+        {
+            owned = false;
+            nvertices = o.nvertices; nedges = o.nedges; narcs = o.narcs;
+            offsets = o.offsets; targets = o.targets; arc_edges = o.arc_edges; weights = o.weights;
+            sources = o.sources; destinations = o.destinations; edge_weights = o.edge_weights;
+        }
+        return *this;
+    }
+
+    CompactGraph(CompactGraph&& o)
+    {
+        *this = std::move(o);
+    }
+
+    // the arrays change hands without being copied
+    CompactGraph& operator=(CompactGraph&& o)
+    {
+        if (!o.owned)
+        {
+            return *this = o;
+        }
+        directed = o.directed;
+        storage = std::move(o.storage);
+        bind_storage();
+
+        o.storage = Storage();
+        o.storage.offsets.push_back(0);
+        o.bind_storage();
+        return *this;
+    }
+
+    bool is_directed() const { return directed; }
+    unsigned num_vertices() const { return nvertices; }
+
+    // bytes of the arrays this graph owns; borrowed ones are not counted
+    size_t memory_usage() const
+    {
+        const Storage& s = storage;
+        return (s.offsets.capacity() + s.targets.capacity() + s.arc_edges.capacity()
+                + s.sources.capacity() + s.destinations.capacity()) * sizeof(unsigned)
+                + (s.weights.capacity() + s.edge_weights.capacity()) * sizeof(EDATA);
+    }
+
+    unsigned num_edges() const { return nedges; }
+    unsigned num_arcs() const { return narcs; }
+
+    unsigned begin(unsigned v) const { return offsets[v]; }
+    unsigned end(unsigned v) const { return offsets[v + 1]; }
+    unsigned get_degree(unsigned v) const { return offsets[v + 1] - offsets[v]; }
+    unsigned target(unsigned a) const { return targets[a]; }
+    unsigned edge(unsigned a) const { return arc_edges[a]; }
+    EDATA weight(unsigned a) const { return weights[a]; }
+
+    unsigned edge_source(unsigned e) const { return sources[e]; }
+    unsigned edge_destination(unsigned e) const { return destinations[e]; }
+    EDATA edge_weight(unsigned e) const { return edge_weights[e]; }
+
+    unsigned edge_destination(unsigned e, unsigned source) const
+    {
+        if (source == sources[e])
+            return destinations[e];
+        if (!directed && source == destinations[e])
+            return sources[e];
+        return NONE;
+    }
+
+    // raw arrays, as laid out in a snapshot
+    const unsigned* offset_data() const { return offsets; }
+    const unsigned* target_data() const { return targets; }
+    const unsigned* arc_edge_data() const { return arc_edges; }
+    const EDATA* weight_data() const { return weights; }
+    const unsigned* source_data() const { return sources; }
+    const unsigned* destination_data() const { return destinations; }
+    const EDATA* edge_weight_data() const { return edge_weights; }
+
+    unsigned opposite(unsigned e, unsigned v) const
+    {
+        return sources[e] == v ? destinations[e] : sources[e];
+    }
+
+    std::vector<unsigned> min_spanning_tree(unsigned start = 0) const
+    {
+        return min_spanning_tree(start, WholeGraph());
+    }
+
+    // Spanning forest of the part the filter keeps, from start when it is kept.
+    template<class FILTER>
+    std::vector<unsigned> min_spanning_tree(unsigned start, const FILTER& filter) const
+    {
+        if (num_vertices() == 0)
+        {
+            return std::vector<unsigned>();
+        }
+        return SpanningTreeBuilder<FILTER>(this, start, filter).get();
+    }
+
+    // Minimum spanning tree of what start reaches alone, which on undirected
+    // graphs is its component; size, the number of its vertices when known
+    // (see Components), ends the search as soon as they are all in.
+    std::vector<unsigned> component_spanning_tree(unsigned start, unsigned size = NONE) const
+    {
+        if (start >= num_vertices())
+        {
+            return std::vector<unsigned>();
+        }
+        return SpanningTreeBuilder<WholeGraph>(this, start, WholeGraph(), size).get();
+    }
+
+    // QUEUE is one of the policies of priority_queues.hpp, WEIGHTS one of weights.hpp
+    template<class QUEUE = DaryHeap<>, class WEIGHTS = DefaultWeights<EDATA> >
+    ShortestPathTree shortest_path_tree(unsigned start, const WEIGHTS& weights = WEIGHTS()) const
+    {
+        Search<QUEUE> search;
+        shortest_path_tree(start, weights, search);
+
+        ShortestPathTree tree;
+        tree.distance.swap(search.distance);
+        tree.parent.swap(search.parent);
+        return tree;
+    }
+
+    // Whole tree into a caller-owned Search, read back from its distance and parent arrays.
+    template<class QUEUE, class WEIGHTS>
+    void shortest_path_tree(unsigned start, const WEIGHTS& weights, Search<QUEUE>& search) const
+    {
+        shortest_path_tree(start, weights, search, WholeGraph());
+    }
+
+    // The same within the part the filter keeps; start itself is not checked.
+    template<class QUEUE, class WEIGHTS, class FILTER>
+    void shortest_path_tree(unsigned start, const WEIGHTS& weights, Search<QUEUE>& search, const FILTER& filter) const
+    {
+        ShortestPathTreeBuilder<QUEUE, WEIGHTS, FILTER>(this, &search, start, weights, filter).run();
+    }
+
+    // Point-to-point query stopping once end is settled; pass a Search to
+    // reuse its memory across queries.
+    template<class QUEUE, class WEIGHTS>
+    std::vector<unsigned> shortest_path(unsigned start, unsigned end, const WEIGHTS& weights, Search<QUEUE>& search) const
+    {
+        return shortest_path(start, end, weights, search, WholeGraph());
+    }
+
+    template<class QUEUE, class WEIGHTS, class FILTER>
+    std::vector<unsigned> shortest_path(unsigned start, unsigned end, const WEIGHTS& weights, Search<QUEUE>& search, const FILTER& filter) const
+    {
+        ShortestPathTreeBuilder<QUEUE, WEIGHTS, FILTER>(this, &search, start, weights, filter).run(end);
+        return search.path_to(*this, end);
+    }
+
+    template<class QUEUE = DaryHeap<>, class WEIGHTS = DefaultWeights<EDATA> >
+    std::vector<unsigned> shortest_path(unsigned start, unsigned end, const WEIGHTS& weights = WEIGHTS()) const
+    {
+        Search<QUEUE> search;
+        return shortest_path(start, end, weights, search);
+    }
+
+    // Meets in the middle; reverse is reversed() for directed graphs and the graph itself otherwise.
+    template<class QUEUE = DaryHeap<>, class WEIGHTS = DefaultWeights<EDATA> >
+    std::vector<unsigned> bidirectional_shortest_path(unsigned start, unsigned end, const CompactGraph& reverse, const WEIGHTS& weights = WEIGHTS()) const
+    {
+        return bidirectional_shortest_path<QUEUE>(start, end, reverse, weights, WholeGraph());
+    }
+
+    template<class QUEUE, class WEIGHTS, class FILTER>
+    std::vector<unsigned> bidirectional_shortest_path(unsigned start, unsigned end, const CompactGraph& reverse, const WEIGHTS& weights, const FILTER& filter) const
+    {
+        Search<QUEUE> forward;
+        Search<QUEUE> backward;
+        return bidirectional_shortest_path(start, end, reverse, weights, forward, backward, filter);
+    }
+
+    // The same with caller-owned searches, whose memory is reused across queries.
+    template<class QUEUE, class WEIGHTS, class FILTER>
+    std::vector<unsigned> bidirectional_shortest_path(unsigned start, unsigned end, const CompactGraph& reverse, const WEIGHTS& weights,
+                                                      Search<QUEUE>& forward, Search<QUEUE>& backward, const FILTER& filter) const
+    {
+        return BidirectionalBuilder<QUEUE, WEIGHTS, FILTER>(this, &reverse, &forward, &backward, start, end, weights, filter).get();
+    }
+
+    // heuristic(v) must never overestimate the distance from v to end
+    template<class HEURISTIC, class WEIGHTS = DefaultWeights<EDATA> >
+    std::vector<unsigned> astar_path(unsigned start, unsigned end, HEURISTIC heuristic, const WEIGHTS& weights = WEIGHTS()) const
+    {
+        return astar_path(start, end, heuristic, weights, WholeGraph());
+    }
+
+    template<class HEURISTIC, class WEIGHTS, class FILTER>
+    std::vector<unsigned> astar_path(unsigned start, unsigned end, HEURISTIC heuristic, const WEIGHTS& weights, const FILTER& filter) const
+    {
+        Search<DaryHeap<> > search;
+        return astar_path(start, end, heuristic, weights, search, filter);
+    }
+
+    // The same with a caller-owned Search, whose memory is reused across queries.
+    template<class HEURISTIC, class WEIGHTS, class FILTER>
+    std::vector<unsigned> astar_path(unsigned start, unsigned end, HEURISTIC heuristic, const WEIGHTS& weights, Search<DaryHeap<> >& search, const FILTER& filter) const
+    {
+        return AStarBuilder<HEURISTIC, WEIGHTS, FILTER>(this, &search, start, end, heuristic, weights, filter).get();
+    }
+
+    // The same edges with every arc turned around; edge indices are kept.
+    CompactGraph reversed() const
+    {
+        if (!directed)
+        {
+            return *this;
+        }
+        std::vector<unsigned> src(destinations, destinations + nedges);
+        std::vector<unsigned> dst(sources, sources + nedges);
+        std::vector<EDATA> w(edge_weights, edge_weights + nedges);
+        return CompactGraph(true, nvertices, src, dst, w);
+    }
+};
+
+template<class EDATA>
+const unsigned CompactGraph<EDATA>::NONE;
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "compact_graph.hpp"
+#include "disjoint_set.hpp"
+
+
+// Connected components of a graph, kept up to date as it grows. Components
+// of undirected graphs, and the weak components of directed ones, come from
+// a union-find fed edge by edge. Directed graphs also get their strongly
+// connected components from an iterative Tarjan, numbered in reverse
+// topological order of the condensation: an edge between two of them always
+// goes to the lower number, so may_reach rules most pairs out in O(1).
+//
+// A new edge only invalidates the strong components when it runs against
+// that order; a removed edge invalidates everything. build() then redoes
+// what is stale.
+template<class EDATA>
+class Components
+{
+
+private:
+    static const unsigned NONE = CompactGraph<EDATA>::NONE;
+
+    bool built;
+    bool directed;
+    DisjointSet sets;
+    std::vector<unsigned> sizes;            // vertices per set, by union-find root
+    bool strong_valid;
+    std::vector<unsigned> strong;           // strong component of each vertex, directed graphs only
+    unsigned nstrong;
+
+    void unite(unsigned a, unsigned b)
+    {
+        unsigned ra = sets.find(a);
+        unsigned rb = sets.find(b);
+        if (ra != rb)
+        {
+            unsigned size = sizes[ra] + sizes[rb];
+            sets.unite(ra, rb);
+            sizes[sets.find(ra)] = size;
+        }
+    }
+
+    // iterative Tarjan; a component is numbered when its root is done
+    void build_strong(const CompactGraph<EDATA>& g)
+    {
+        unsigned n = g.num_vertices();
+        std::vector<unsigned> index(n, NONE);
+        std::vector<unsigned> low(n);
+        std::vector<bool> on_stack(n, false);
+        std::vector<unsigned> stack;
+        std::vector<std::pair<unsigned, unsigned> > calls;   // vertex, next arc
+        unsigned next_index = 0;
+
+        strong.assign(n, NONE);
+        nstrong = 0;
+        for (unsigned root = 0; root < n; root++)
+        {
+            if (index[root] != NONE)
+                continue;
+
+            calls.push_back(std::make_pair(root, g.begin(root)));
+            index[root] = low[root] = next_index ++;
+            stack.push_back(root);
+            on_stack[root] = true;
+
+            while (!calls.empty())
+            {
+                unsigned v = calls.back().first;
+                unsigned& a = calls.back().second;
+                if (a < g.end(v))
+                {
+                    unsigned t = g.target(a ++);
+                    if (index[t] == NONE)
+                    {
+                        index[t] = low[t] = next_index ++;
+                        stack.push_back(t);
+                        on_stack[t] = true;
+                        calls.push_back(std::make_pair(t, g.begin(t)));
+                    }
+                    else if (on_stack[t])
+                    {
+                        low[v] = std::min(low[v], index[t]);
+                    }
+                    continue;
+                }
+
+                calls.pop_back();
+                if (!calls.empty())
+                {
+                    unsigned parent = calls.back().first;
+                    low[parent] = std::min(low[parent], low[v]);
+                }
+                if (low[v] == index[v])
+                {
+                    unsigned w;
+                    do
+                    {
+                        w = stack.back();
+                        stack.pop_back();
+                        on_stack[w] = false;
+                        strong[w] = nstrong;
+                    }
+                    while (w != v);
+                    nstrong ++;
+                }
+            }
+        }
+        strong_valid = true;
+    }
+
+public:
+    Components()
+    {
+        built = false;
+        directed = false;
+        strong_valid = false;
+        nstrong = 0;
+    }
+
+    bool is_built() const { return built; }
+    bool is_current() const { return built && (!directed || strong_valid); }
+
+    // from scratch when nothing is built, otherwise only what is stale
+    void build(const CompactGraph<EDATA>& g)
+    {
+        if (!built)
+        {
+            directed = g.is_directed();
+            sets.reset(g.num_vertices());
+            sizes.assign(g.num_vertices(), 1);
+            for (unsigned e = 0; e < g.num_edges(); e++)
+            {
+                unite(g.edge_source(e), g.edge_destination(e));
+            }
+            strong_valid = false;
+            built = true;
+        }
+        if (directed && !strong_valid)
+        {
+            build_strong(g);
+        }
+    }
+
+    void clear()
+    {
+        built = false;
+        strong_valid = false;
+    }
+
+    // changes of the graph, once built
+
+    void vertex_added()
+    {
+        sets.add();
+        sizes.push_back(1);
+        if (strong_valid)
+            strong.push_back(nstrong ++);
+    }
+
+    void edge_added(unsigned source, unsigned destination)
+    {
+        unite(source, destination);
+        if (strong_valid && strong[source] < strong[destination])
+            strong_valid = false;
+    }
+
+    void edge_removed() { clear(); }
+
+    size_t memory_usage() const
+    {
+        return sets.memory_usage() + (sizes.capacity() + strong.capacity()) * sizeof(unsigned);
+    }
+
+    // queries, by vertex index; a component is named by one of its vertices
+
+    unsigned num_components() const { return sets.num_sets(); }
+    unsigned component(unsigned v) const { return sets.find_root(v); }
+    unsigned component_size(unsigned v) const { return sizes[sets.find_root(v)]; }
+    bool connected(unsigned u, unsigned v) const { return sets.find_root(u) == sets.find_root(v); }
+
+    // the components themselves on undirected graphs
+    unsigned num_strong_components() const { return directed ? nstrong : num_components(); }
+    unsigned strong_component(unsigned v) const { return directed ? strong[v] : component(v); }
+
+    // false only when no path leads from start to end; true is exact on undirected
+    // graphs and within a strong component
+    bool may_reach(unsigned start, unsigned end) const
+    {
+        if (!connected(start, end))
+            return false;
+        return !directed || strong[end] <= strong[start];
+    }
+};
+
+template<class EDATA>
+const unsigned Components<EDATA>::NONE;
@@ -0,0 +1,635 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <cstring>
+#include <stdint.h>
+
+#include "compact_graph.hpp"
+#include "priority_queues.hpp"
+
+
+// Contraction hierarchy of a CompactGraph, for many point-to-point queries
+// on a graph that no longer changes.
+//
+// Vertices are contracted one at a time, cheapest first by edge difference
+// (the shortcuts a contraction adds less the arcs it removes) plus the number
+// of neighbours already contracted, which spreads the contractions out. When
+// a vertex v goes, every u -> v -> x that may be the only shortest way from u
+// to x becomes a shortcut u -> x, unless a bounded witness search finds a way
+// at least as short around v. A query is then two Dijkstra searches that only
+// climb to later contracted vertices, one from each end, and the shortcuts of
+// the meeting path are unpacked back into edges of the graph.
+//
+// It pays off on sparse, low-dimensional graphs such as road networks and
+// grids; random graphs leave a dense core that makes contraction slow.
+//
+// The index can be written to a file and read back for the same graph.
+template<class EDATA>
+class ContractionHierarchy
+{
+
+public:
+    static const unsigned NONE = CompactGraph<EDATA>::NONE;
+    static const uint32_t VERSION = 1;
+
+    typedef typename CompactGraph<EDATA>::template Search<DaryHeap<> > Search;
+
+private:
+    enum { WITNESS_SETTLE_LIMIT = 500 };
+
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t weight_size;
+        uint32_t directed;
+        uint32_t num_vertices;
+        uint32_t num_edges;
+        uint32_t num_arcs;
+        uint32_t num_up;
+        uint32_t num_down;
+    };
+
+    // arcs of the hierarchy: edges of the graph (original) or shortcuts over two earlier arcs
+    struct Arc
+    {
+        unsigned tail;
+        unsigned head;
+        EDATA weight;
+        unsigned original;
+        unsigned first;
+        unsigned second;
+    };
+
+    // one end of an arc in the adjacency being contracted
+    struct Link
+    {
+        unsigned other;
+        EDATA weight;
+        unsigned arc;
+    };
+
+    struct Shortcut
+    {
+        unsigned tail;
+        unsigned head;
+        EDATA weight;
+        unsigned first;
+        unsigned second;
+    };
+
+    template<class WEIGHTS>
+    struct DistanceKey
+    {
+        const WEIGHTS* weights;
+        DistanceKey(const WEIGHTS* w) { weights = w; }
+        uint64_t operator()(unsigned, EDATA total) { return weights->priority(total); }
+    };
+
+    // query workspaces, shared by the copies of a hierarchy
+    struct SearchPool
+    {
+        std::mutex lock;
+        std::vector<std::shared_ptr<std::pair<Search, Search> > > searches;
+    };
+
+    bool directed;
+    unsigned nvertices;
+    unsigned nedges;
+    std::vector<Arc> arcs;
+    std::vector<unsigned> up_arcs;      // tail -> head, head contracted later
+    std::vector<unsigned> down_arcs;    // tail -> head, tail contracted later; searched head -> tail
+
+    CompactGraph<EDATA> up;
+    CompactGraph<EDATA> down;
+    std::shared_ptr<SearchPool> pool;
+
+    // Adjacency and witness searches while contracting.
+    template<class WEIGHTS>
+    class Builder
+    {
+
+    private:
+        ContractionHierarchy* ch;
+        const WEIGHTS* weights;
+        std::vector<std::vector<Link> > out;
+        std::vector<std::vector<Link> > in;
+        std::vector<unsigned> neighbours_contracted;
+
+        DaryHeap<> queue;
+        std::vector<EDATA> distance;
+        std::vector<char> settled;
+        std::vector<unsigned> touched;
+        std::vector<Shortcut> shortcuts;
+
+        void add_arc(unsigned tail, unsigned head, EDATA weight, unsigned original, unsigned first, unsigned second)
+        {
+            if (tail == head || !(weight < weights->infinity()))
+                return;
+
+            Arc arc = { tail, head, weight, original, first, second };
+            std::vector<Link>& links = out[tail];
+            for (unsigned i = 0; i < links.size(); i++)
+            {
+                if (links[i].other != head)
+                    continue;
+                if (!(weight < links[i].weight))
+                    return;
+
+                // a cheaper parallel arc replaces the old one in the adjacency
+                links[i].weight = weight;
+                links[i].arc = ch->arcs.size();
+                for (unsigned j = 0; j < in[head].size(); j++)
+                {
+                    if (in[head][j].other == tail)
+                    {
+                        in[head][j].weight = weight;
+                        in[head][j].arc = ch->arcs.size();
+                    }
+                }
+                ch->arcs.push_back(arc);
+                return;
+            }
+
+            Link forward = { head, weight, (unsigned) ch->arcs.size() };
+            Link backward = { tail, weight, (unsigned) ch->arcs.size() };
+            out[tail].push_back(forward);
+            in[head].push_back(backward);
+            ch->arcs.push_back(arc);
+        }
+
+        // bounded Dijkstra from source around skipped, up to limit
+        void witness_search(unsigned source, unsigned skipped, EDATA limit)
+        {
+            for (unsigned i = 0; i < touched.size(); i++)
+            {
+                distance[touched[i]] = weights->infinity();
+                settled[touched[i]] = 0;
+            }
+            touched.clear();
+            while (!queue.empty())
+                queue.pop();
+
+            distance[source] = weights->zero();
+            touched.push_back(source);
+            queue.push(source, weights->priority(weights->zero()));
+
+            for (unsigned count = 0; !queue.empty() && count < WITNESS_SETTLE_LIMIT; count++)
+            {
+                unsigned v = queue.pop();
+                settled[v] = 1;
+                if (limit < distance[v])
+                    break;
+
+                for (unsigned i = 0; i < out[v].size(); i++)
+                {
+                    const Link& l = out[v][i];
+                    if (l.other == skipped || settled[l.other])
+                        continue;
+                    EDATA total = distance[v] + l.weight;
+                    if (total < distance[l.other])
+                    {
+                        if (!(distance[l.other] < weights->infinity()))
+                            touched.push_back(l.other);
+                        distance[l.other] = total;
+                        queue.push(l.other, weights->priority(total));
+                    }
+                }
+            }
+        }
+
+        // the shortcuts contracting v needs, into shortcuts
+        void find_shortcuts(unsigned v)
+        {
+            shortcuts.clear();
+            for (unsigned i = 0; i < in[v].size(); i++)
+            {
+                const Link& from = in[v][i];
+                EDATA limit = weights->zero();
+                bool any = false;
+                for (unsigned j = 0; j < out[v].size(); j++)
+                {
+                    if (out[v][j].other != from.other && (!any || limit < from.weight + out[v][j].weight))
+                    {
+                        limit = from.weight + out[v][j].weight;
+                        any = true;
+                    }
+                }
+                if (!any)
+                    continue;
+
+                witness_search(from.other, v, limit);
+                for (unsigned j = 0; j < out[v].size(); j++)
+                {
+                    const Link& to = out[v][j];
+                    EDATA total = from.weight + to.weight;
+                    if (to.other != from.other && total < distance[to.other])
+                    {
+                        Shortcut s = { from.other, to.other, total, from.arc, to.arc };
+                        shortcuts.push_back(s);
+                    }
+                }
+            }
+        }
+
+        int importance(unsigned v)
+        {
+            find_shortcuts(v);
+            return (int) shortcuts.size() - (int) (in[v].size() + out[v].size()) + (int) neighbours_contracted[v];
+        }
+
+        static void unlink(std::vector<Link>& links, unsigned v)
+        {
+            for (unsigned i = 0; i < links.size(); )
+            {
+                if (links[i].other == v)
+                {
+                    links[i] = links.back();
+                    links.pop_back();
+                }
+                else
+                    i++;
+            }
+        }
+
+        // with the shortcuts of v just found by importance(v)
+        void contract(unsigned v)
+        {
+            // what is left around v only leads to later vertices
+            for (unsigned i = 0; i < out[v].size(); i++)
+            {
+                ch->up_arcs.push_back(out[v][i].arc);
+                unlink(in[out[v][i].other], v);
+                neighbours_contracted[out[v][i].other] ++;
+            }
+            for (unsigned i = 0; i < in[v].size(); i++)
+            {
+                ch->down_arcs.push_back(in[v][i].arc);
+                unlink(out[in[v][i].other], v);
+                neighbours_contracted[in[v][i].other] ++;
+            }
+            std::vector<Link>().swap(out[v]);
+            std::vector<Link>().swap(in[v]);
+
+            for (unsigned i = 0; i < shortcuts.size(); i++)
+            {
+                const Shortcut& s = shortcuts[i];
+                add_arc(s.tail, s.head, s.weight, NONE, s.first, s.second);
+            }
+        }
+
+    public:
+        Builder(ContractionHierarchy* ch, const CompactGraph<EDATA>& g, const WEIGHTS& weights)
+        {
+            this->ch = ch;
+            this->weights = &weights;
+            unsigned n = g.num_vertices();
+            out.resize(n);
+            in.resize(n);
+            neighbours_contracted.assign(n, 0);
+            queue.reset(n);
+            distance.assign(n, weights.infinity());
+            settled.assign(n, 0);
+
+            for (unsigned e = 0; e < g.num_edges(); e++)
+            {
+                add_arc(g.edge_source(e), g.edge_destination(e), g.edge_weight(e), e, NONE, NONE);
+                if (!g.is_directed())
+                    add_arc(g.edge_destination(e), g.edge_source(e), g.edge_weight(e), e, NONE, NONE);
+            }
+        }
+
+        // lazy updates: a vertex whose importance grew since it was queued goes back in
+        void run()
+        {
+            typedef std::pair<int, unsigned> Entry;
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > order;
+            for (unsigned v = 0; v < out.size(); v++)
+            {
+                order.push(Entry(importance(v), v));
+            }
+
+            while (!order.empty())
+            {
+                unsigned v = order.top().second;
+                order.pop();
+
+                int now = importance(v);
+                if (!order.empty() && now > order.top().first)
+                {
+                    order.push(Entry(now, v));
+                    continue;
+                }
+                contract(v);
+            }
+        }
+    };
+
+    // the two search graphs, whose edge i is up_arcs[i] and down_arcs[i]
+    void bind_searches()
+    {
+        std::vector<unsigned> src(up_arcs.size()), dst(up_arcs.size());
+        std::vector<EDATA> w(up_arcs.size());
+        for (unsigned i = 0; i < up_arcs.size(); i++)
+        {
+            src[i] = arcs[up_arcs[i]].tail;
+            dst[i] = arcs[up_arcs[i]].head;
+            w[i] = arcs[up_arcs[i]].weight;
+        }
+        up = CompactGraph<EDATA>(true, nvertices, src, dst, w);
+
+        src.resize(down_arcs.size());
+        dst.resize(down_arcs.size());
+        w.resize(down_arcs.size());
+        for (unsigned i = 0; i < down_arcs.size(); i++)
+        {
+            src[i] = arcs[down_arcs[i]].head;
+            dst[i] = arcs[down_arcs[i]].tail;
+            w[i] = arcs[down_arcs[i]].weight;
+        }
+        down = CompactGraph<EDATA>(true, nvertices, src, dst, w);
+    }
+
+    std::shared_ptr<std::pair<Search, Search> > acquire_search() const
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        for (unsigned i = 0; i < pool->searches.size(); i++)
+        {
+            if (pool->searches[i].use_count() == 1)
+            {
+                return pool->searches[i];
+            }
+        }
+        pool->searches.push_back(std::make_shared<std::pair<Search, Search> >());
+        return pool->searches.back();
+    }
+
+    // appends the edges of arc a to path, in travel order
+    void unpack(unsigned a, std::vector<unsigned>& path, std::vector<unsigned>& stack) const
+    {
+        stack.assign(1, a);
+        while (!stack.empty())
+        {
+            const Arc& arc = arcs[stack.back()];
+            stack.pop_back();
+            if (arc.original != NONE)
+            {
+                path.push_back(arc.original);
+            }
+            else
+            {
+                stack.push_back(arc.second);
+                stack.push_back(arc.first);
+            }
+        }
+    }
+
+    template<class T>
+    static void write_array(std::ofstream& file, const std::vector<T>& v)
+    {
+        if (!v.empty())
+            file.write((const char*) v.data(), v.size() * sizeof(T));
+    }
+
+    template<class T>
+    static bool read_array(std::ifstream& file, std::vector<T>& v, uint32_t count)
+    {
+        v.resize(count);
+        if (count)
+            file.read((char*) v.data(), (std::streamsize) count * sizeof(T));
+        return (bool) file;
+    }
+
+    // shortcuts only refer to earlier arcs, so unpacking always ends
+    bool validate() const
+    {
+        for (unsigned a = 0; a < arcs.size(); a++)
+        {
+            const Arc& arc = arcs[a];
+            if (arc.tail >= nvertices || arc.head >= nvertices)
+                return false;
+            if (arc.original == NONE ? arc.first >= a || arc.second >= a : arc.original >= nedges)
+                return false;
+        }
+        for (unsigned i = 0; i < up_arcs.size(); i++)
+        {
+            if (up_arcs[i] >= arcs.size())
+                return false;
+        }
+        for (unsigned i = 0; i < down_arcs.size(); i++)
+        {
+            if (down_arcs[i] >= arcs.size())
+                return false;
+        }
+        return true;
+    }
+
+public:
+    ContractionHierarchy() : pool(std::make_shared<SearchPool>())
+    {
+        directed = false;
+        nvertices = 0;
+        nedges = 0;
+    }
+
+    template<class WEIGHTS>
+    ContractionHierarchy(const CompactGraph<EDATA>& g, const WEIGHTS& weights) : pool(std::make_shared<SearchPool>())
+    {
+        directed = g.is_directed();
+        nvertices = g.num_vertices();
+        nedges = g.num_edges();
+        Builder<WEIGHTS>(this, g, weights).run();
+        bind_searches();
+    }
+
+    // empty when the file cannot be read or does not hold an index
+    ContractionHierarchy(const std::string& filename) : pool(std::make_shared<SearchPool>())
+    {
+        directed = false;
+        nvertices = 0;
+        nedges = 0;
+
+        std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+        uint64_t size = file ? (uint64_t) file.tellg() : 0;
+        file.seekg(0);
+        Header h;
+        if (!file.read((char*) &h, sizeof(h)) || std::memcmp(h.magic, "AMPCHIDX", 8) != 0 || h.version != VERSION
+                || h.byte_order != BYTE_ORDER_MARK || h.weight_size != sizeof(EDATA)
+                || size != sizeof(h) + (uint64_t) h.num_arcs * (5 * sizeof(uint32_t) + sizeof(EDATA))
+                          + ((uint64_t) h.num_up + h.num_down) * sizeof(unsigned))
+            return;
+
+        std::vector<uint32_t> tails, heads, originals, firsts, seconds;
+        std::vector<EDATA> weights;
+        if (!read_array(file, tails, h.num_arcs) || !read_array(file, heads, h.num_arcs) || !read_array(file, weights, h.num_arcs)
+                || !read_array(file, originals, h.num_arcs) || !read_array(file, firsts, h.num_arcs) || !read_array(file, seconds, h.num_arcs)
+                || !read_array(file, up_arcs, h.num_up) || !read_array(file, down_arcs, h.num_down))
+        {
+            *this = ContractionHierarchy();
+            return;
+        }
+
+        directed = h.directed != 0;
+        nvertices = h.num_vertices;
+        nedges = h.num_edges;
+        arcs.resize(h.num_arcs);
+        for (unsigned a = 0; a < arcs.size(); a++)
+        {
+            Arc arc = { tails[a], heads[a], weights[a], originals[a], firsts[a], seconds[a] };
+            arcs[a] = arc;
+        }
+
+        if (!validate())
+        {
+            *this = ContractionHierarchy();
+            return;
+        }
+        bind_searches();
+    }
+
+    bool write(const std::string& filename) const
+    {
+        std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        Header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, "AMPCHIDX", 8);
+        h.version = VERSION;
+        h.byte_order = BYTE_ORDER_MARK;
+        h.weight_size = sizeof(EDATA);
+        h.directed = directed;
+        h.num_vertices = nvertices;
+        h.num_edges = nedges;
+        h.num_arcs = arcs.size();
+        h.num_up = up_arcs.size();
+        h.num_down = down_arcs.size();
+        file.write((const char*) &h, sizeof(h));
+
+        std::vector<uint32_t> tails(arcs.size()), heads(arcs.size()), originals(arcs.size()), firsts(arcs.size()), seconds(arcs.size());
+        std::vector<EDATA> weights(arcs.size());
+        for (unsigned a = 0; a < arcs.size(); a++)
+        {
+            tails[a] = arcs[a].tail;
+            heads[a] = arcs[a].head;
+            weights[a] = arcs[a].weight;
+            originals[a] = arcs[a].original;
+            firsts[a] = arcs[a].first;
+            seconds[a] = arcs[a].second;
+        }
+        write_array(file, tails);
+        write_array(file, heads);
+        write_array(file, weights);
+        write_array(file, originals);
+        write_array(file, firsts);
+        write_array(file, seconds);
+        write_array(file, up_arcs);
+        write_array(file, down_arcs);
+        return file.good();
+    }
+
+    bool is_directed() const { return directed; }
+    unsigned num_vertices() const { return nvertices; }
+    unsigned num_edges() const { return nedges; }
+    unsigned num_shortcuts() const
+    {
+        unsigned n = 0;
+        for (unsigned a = 0; a < arcs.size(); a++)
+        {
+            if (arcs[a].original == NONE)
+                n++;
+        }
+        return n;
+    }
+
+    // true when built from, or read back for, a graph of this shape
+    bool fits(const CompactGraph<EDATA>& g) const
+    {
+        return g.is_directed() == directed && g.num_vertices() == nvertices && g.num_edges() == nedges;
+    }
+
+    // Edges of a shortest path from end back to start, as CompactGraph::shortest_path
+    // lists them; empty when start == end or end is unreachable. May run concurrently.
+    template<class WEIGHTS>
+    std::vector<unsigned> shortest_path(unsigned start, unsigned end, const WEIGHTS& weights) const
+    {
+        std::vector<unsigned> path;
+        if (start == end || start >= nvertices || end >= nvertices)
+        {
+            return path;
+        }
+
+        std::shared_ptr<std::pair<Search, Search> > searches = acquire_search();
+        Search& forward = searches->first;
+        Search& backward = searches->second;
+        DistanceKey<WEIGHTS> key(&weights);
+        EDATA zero = weights.zero();
+
+        // the upward space of start is small: search it all, then meet it from end
+        forward.start(nvertices, start, zero, weights.infinity(), weights.priority(zero));
+        while (!forward.empty())
+        {
+            forward.settle(up, key, false);
+        }
+
+        backward.start(nvertices, end, zero, weights.infinity(), weights.priority(zero));
+        EDATA best = weights.infinity();
+        unsigned meeting = NONE;
+        while (!backward.empty())
+        {
+            unsigned v = backward.settle(down, key, false);
+            if (!(backward.distance[v] < best))
+                break;
+            if (forward.is_settled(v) && forward.distance[v] + backward.distance[v] < best)
+            {
+                best = forward.distance[v] + backward.distance[v];
+                meeting = v;
+            }
+        }
+
+        if (meeting == NONE)
+        {
+            return path;
+        }
+
+        // arcs in travel order, then their edges
+        std::vector<unsigned> route = forward.path_to(up, meeting);
+        for (unsigned i = 0; i < route.size(); i++)
+        {
+            route[i] = up_arcs[route[i]];
+        }
+        std::reverse(route.begin(), route.end());
+        std::vector<unsigned> tail = backward.path_to(down, meeting);
+        for (unsigned i = 0; i < tail.size(); i++)
+        {
+            route.push_back(down_arcs[tail[i]]);
+        }
+
+        std::vector<unsigned> stack;
+        for (unsigned i = 0; i < route.size(); i++)
+        {
+            unpack(route[i], path, stack);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+};
+
+template<class EDATA>
+const unsigned ContractionHierarchy<EDATA>::NONE;
+
+template<class EDATA>
+const uint32_t ContractionHierarchy<EDATA>::VERSION;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+
+// Union-find with union by rank and path compression.
+class DisjointSet
+{
+
+private:
+    std::vector<unsigned> parent;
+    std::vector<unsigned char> rank;
+    unsigned sets;
+
+public:
+    DisjointSet(unsigned n = 0) { reset(n); }
+
+    void reset(unsigned n)
+    {
+        parent.resize(n);
+        rank.assign(n, 0);
+        for (unsigned i = 0; i < n; i++)
+        {
+            parent[i] = i;
+        }
+        sets = n;
+    }
+
+    unsigned size() const { return parent.size(); }
+    size_t memory_usage() const { return parent.capacity() * sizeof(unsigned) + rank.capacity(); }
+    unsigned num_sets() const { return sets; }
+
+    // grows the universe by one singleton set and returns it
+    unsigned add()
+    {
+        parent.push_back(parent.size());
+        rank.push_back(0);
+        sets ++;
+        return parent.size() - 1;
+    }
+
+    unsigned find(unsigned v)
+    {
+        unsigned root = v;
+        while (parent[root] != root)
+            root = parent[root];
+        while (parent[v] != root)
+        {
+            unsigned next = parent[v];
+            parent[v] = root;
+            v = next;
+        }
+        return root;
+    }
+
+    // no compression, safe for concurrent readers
+    unsigned find_root(unsigned v) const
+    {
+        while (parent[v] != v)
+            v = parent[v];
+        return v;
+    }
+
+    bool same(unsigned a, unsigned b) { return find(a) == find(b); }
+
+    // false when a and b were already in the same set
+    bool unite(unsigned a, unsigned b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return false;
+
+        if (rank[a] < rank[b])
+            std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b])
+            rank[a] ++;
+        sets --;
+        return true;
+    }
+};
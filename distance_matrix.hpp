@@ -0,0 +1,256 @@
+#pragma once
+
+#include <vector>
+
+#include "compact_graph.hpp"
+#include "thread_pool.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DISTANCE_MATRIX_AVX2
+#endif
+
+
+// d[j] = min(d[j], dik + dk[j]) over count entries, next[j] following the
+// minimum; count is always a multiple of 8.
+template<class EDATA>
+inline void min_plus_row(EDATA* d, unsigned* next, EDATA dik, unsigned nik, const EDATA* dk, unsigned count)
+{
+    for (unsigned j = 0; j < count; j++)
+    {
+        EDATA candidate = dik + dk[j];
+        if (candidate < d[j])
+        {
+            d[j] = candidate;
+            next[j] = nik;
+        }
+    }
+}
+
+template<class EDATA>
+struct MinPlusRow
+{
+    static void relax(EDATA* d, unsigned* next, EDATA dik, unsigned nik, const EDATA* dk, unsigned count)
+    {
+        min_plus_row(d, next, dik, nik, dk, count);
+    }
+};
+
+#ifdef DISTANCE_MATRIX_AVX2
+// Compiled for AVX2 whatever the build flags, and only called on a CPU that
+// has it, so the default build gets the vector kernel too.
+__attribute__((target("avx2")))
+inline void min_plus_row_avx2(int* d, unsigned* next, int dik, unsigned nik, const int* dk, unsigned count)
+{
+    __m256i vik = _mm256_set1_epi32(dik);
+    __m256i vnik = _mm256_set1_epi32((int) nik);
+    for (unsigned j = 0; j < count; j += 8)
+    {
+        __m256i current = _mm256_loadu_si256((const __m256i*) (d + j));
+        __m256i candidate = _mm256_add_epi32(vik, _mm256_loadu_si256((const __m256i*) (dk + j)));
+        __m256i better = _mm256_cmpgt_epi32(current, candidate);
+        _mm256_storeu_si256((__m256i*) (d + j), _mm256_min_epi32(current, candidate));
+
+        __m256i n = _mm256_loadu_si256((const __m256i*) (next + j));
+        _mm256_storeu_si256((__m256i*) (next + j), _mm256_blendv_epi8(n, vnik, better));
+    }
+}
+
+inline bool cpu_has_avx2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+template<>
+struct MinPlusRow<int>
+{
+    static void relax(int* d, unsigned* next, int dik, unsigned nik, const int* dk, unsigned count)
+    {
+        if (cpu_has_avx2())
+            min_plus_row_avx2(d, next, dik, nik, dk, count);
+        else
+            min_plus_row(d, next, dik, nik, dk, count);
+    }
+};
+#endif
+
+
+// All-pairs distances of a CompactGraph by tiled Floyd–Warshall on a dense
+// matrix padded to whole tiles and stored tile by tile, so that a tile never
+// strides across memory. Each cell keeps the distance and the first edge of
+// a shortest path, so distances and next hops are O(1) lookups.
+// Distances that do not stay below weights.infinity() count as unreachable,
+// as in Dijkstra; infinity plus any finite distance must fit in EDATA.
+template<class EDATA>
+class DistanceMatrix
+{
+
+public:
+    enum { BLOCK = 64 };
+
+private:
+    unsigned n;
+    unsigned padded;
+    EDATA infinity;
+    std::vector<EDATA> dist;
+    std::vector<unsigned> next;
+
+    // tiles are stored one after the other, rows contiguous inside a tile
+    size_t cell(unsigned u, unsigned v) const
+    {
+        return ((size_t) (u / BLOCK) * (padded / BLOCK) + v / BLOCK) * BLOCK * BLOCK + (u % BLOCK) * BLOCK + v % BLOCK;
+    }
+
+    void block(unsigned ib, unsigned jb, unsigned kb)
+    {
+        size_t ij = cell(ib * BLOCK, jb * BLOCK);
+        size_t ik = cell(ib * BLOCK, kb * BLOCK);
+        size_t kj = cell(kb * BLOCK, jb * BLOCK);
+        for (unsigned k = 0; k < BLOCK; k++)
+        {
+            const EDATA* dk = &dist[kj + k * BLOCK];
+            for (unsigned i = 0; i < BLOCK; i++)
+            {
+                EDATA dik = dist[ik + i * BLOCK + k];
+                if (!(dik < infinity))
+                    continue;
+                MinPlusRow<EDATA>::relax(&dist[ij + i * BLOCK], &next[ij + i * BLOCK], dik, next[ik + i * BLOCK + k], dk, BLOCK);
+            }
+        }
+    }
+
+    void run(unsigned threads)
+    {
+        unsigned nb = padded / BLOCK;
+        ThreadPool pool(threads);
+
+        for (unsigned kb = 0; kb < nb; kb++)
+        {
+            block(kb, kb, kb);
+
+            // the row and the column of the pivot tile, then everything else
+            pool.for_each(0, 2 * nb, [&](unsigned item, unsigned) {
+                unsigned b = item / 2;
+                if (b == kb)
+                    return;
+                if (item % 2)
+                    block(b, kb, kb);
+                else
+                    block(kb, b, kb);
+            });
+
+            pool.for_each(0, nb * nb, [&](unsigned item, unsigned) {
+                unsigned ib = item / nb;
+                unsigned jb = item % nb;
+                if (ib != kb && jb != kb)
+                    block(ib, jb, kb);
+            });
+        }
+    }
+
+    // Tiling reorders the relaxations, so ties among zero-weight cycles can
+    // leave next hops that go round in circles. Rebuild them per target from
+    // a breadth-first search over the arcs that are tight in the final matrix.
+    void repair_next(const CompactGraph<EDATA>& g, unsigned threads)
+    {
+        CompactGraph<EDATA> reverse = g.reversed();
+        ThreadPool pool(threads);
+        std::vector<std::vector<unsigned> > queues(pool.size());
+        std::vector<std::vector<unsigned> > seen(pool.size(), std::vector<unsigned>(n, CompactGraph<EDATA>::NONE));
+
+        pool.for_each(0, n, [&](unsigned v, unsigned worker) {
+            std::vector<unsigned>& queue = queues[worker];
+            std::vector<unsigned>& mark = seen[worker];
+            queue.assign(1, v);
+            mark[v] = v;
+            for (unsigned head = 0; head < queue.size(); head++)
+            {
+                unsigned y = queue[head];
+                EDATA dy = distance(y, v);
+                for (unsigned a = reverse.begin(y); a < reverse.end(y); a++)
+                {
+                    unsigned x = reverse.target(a);
+                    if (mark[x] == v || !is_reachable(x, v) || !(reverse.weight(a) + dy == distance(x, v)))
+                        continue;
+                    mark[x] = v;
+                    next[cell(x, v)] = reverse.edge(a);
+                    queue.push_back(x);
+                }
+            }
+        });
+    }
+
+public:
+    DistanceMatrix()
+    {
+        n = 0;
+        padded = 0;
+        infinity = EDATA();
+    }
+
+    // threads = 0 uses every core
+    template<class WEIGHTS>
+    DistanceMatrix(const CompactGraph<EDATA>& g, const WEIGHTS& weights, unsigned threads = 0)
+    {
+        n = g.num_vertices();
+        padded = (n + BLOCK - 1) / BLOCK * BLOCK;
+        infinity = weights.infinity();
+        dist.assign((size_t) padded * padded, infinity);
+        next.assign((size_t) padded * padded, CompactGraph<EDATA>::NONE);
+
+        EDATA zero = weights.zero();
+        bool ties = false;
+        for (unsigned v = 0; v < padded; v++)
+        {
+            dist[cell(v, v)] = zero;
+        }
+        for (unsigned v = 0; v < n; v++)
+        {
+            for (unsigned a = g.begin(v); a < g.end(v); a++)
+            {
+                size_t c = cell(v, g.target(a));
+                ties = ties || !(zero < g.weight(a));
+                if (g.weight(a) < dist[c])
+                {
+                    dist[c] = g.weight(a);
+                    next[c] = g.edge(a);
+                }
+            }
+        }
+
+        if (n)
+        {
+            run(threads);
+        }
+        if (ties)
+        {
+            repair_next(g, threads);
+        }
+    }
+
+    unsigned num_vertices() const { return n; }
+
+    EDATA distance(unsigned u, unsigned v) const { return dist[cell(u, v)]; }
+    bool is_reachable(unsigned u, unsigned v) const { return dist[cell(u, v)] < infinity; }
+
+    // first edge of a shortest path from u to v, NONE when u == v or v is unreachable
+    unsigned next_edge(unsigned u, unsigned v) const { return next[cell(u, v)]; }
+
+    // edges from u to v; g is the graph the matrix was computed from
+    std::vector<unsigned> path(const CompactGraph<EDATA>& g, unsigned u, unsigned v) const
+    {
+        std::vector<unsigned> edges;
+        if (!is_reachable(u, v))
+        {
+            return edges;
+        }
+        while (u != v)
+        {
+            unsigned e = next_edge(u, v);
+            edges.push_back(e);
+            u = g.opposite(e, u);
+        }
+        return edges;
+    }
+};
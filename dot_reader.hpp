@@ -0,0 +1,573 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <iterator>
+#include <memory>
+#include <algorithm>
+
+#include "instrumentation.hpp"
+#include "thread_pool.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define DOT_READER_MMAP
+#endif
+
+
+// Hand-written reader for the DOT subset written by Graph::save_graph and for
+// plain "a -- b [label=N]" / "a -> b [label=N]" edge lists. The file is mapped
+// into memory when possible, read in large chunks otherwise, and tokenized in
+// place: names are handed out as (pointer, length) pairs into the buffer.
+//
+// The handler receives
+//     handler.vertex(const char* name, size_t len)
+//     handler.edge(const char* src, size_t srclen, const char* dst, size_t dstlen, double weight)
+// Edges without a label or weight attribute get a weight of 1.
+//
+// read_parallel parses chunks of the input on several cores, one handler per
+// chunk; see parallel_loader.hpp for a graph built that way.
+class DotReader
+{
+
+private:
+    struct Token
+    {
+        const char* data;
+        size_t size;
+    };
+
+    class Cursor
+    {
+
+    private:
+        const char* p;
+        const char* end;
+        bool last;
+
+    public:
+        bool truncated;
+
+        Cursor(const char* begin, const char* end, bool last)
+        {
+            this->p = begin;
+            this->end = end;
+            this->last = last;
+            truncated = false;
+        }
+
+        const char* position() { return p; }
+        bool at_end() { return p >= end; }
+        char peek() { return p < end ? *p : 0; }
+        char peek(unsigned offset) { return p + offset < end ? p[offset] : 0; }
+        void skip(unsigned n = 1) { p += n; }
+
+        void skip_space()
+        {
+            while (p < end)
+            {
+                char c = *p;
+                if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+                {
+                    p ++;
+                }
+                else if (c == '/' && p + 1 == end && !last)
+                {
+                    truncated = true;
+                    return;
+                }
+                else if (c == '#' || (c == '/' && peek(1) == '/'))
+                {
+                    while (p < end && *p != '\n')
+                        p ++;
+                    if (p == end)
+                        truncated = !last;
+                }
+                else if (c == '/' && peek(1) == '*')
+                {
+                    const char* close = p + 2;
+                    while (close + 1 < end && !(close[0] == '*' && close[1] == '/'))
+                        close ++;
+                    if (close + 1 >= end)
+                    {
+                        truncated = !last;
+                        p = end;
+                        return;
+                    }
+                    p = close + 2;
+                }
+                else
+                {
+                    return;
+                }
+            }
+        }
+
+        static bool is_id_char(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                    || c == '_' || c == '.' || c == '-' || (unsigned char) c >= 0x80;
+        }
+
+        // identifier, numeral or quoted string; quotes are stripped
+        bool read_id(Token& token)
+        {
+            skip_space();
+            if (p >= end)
+            {
+                truncated = !last;
+                return false;
+            }
+
+            if (*p == '"')
+            {
+                const char* q = p + 1;
+                while (q < end && *q != '"')
+                {
+                    q += (*q == '\\' && q + 1 < end) ? 2 : 1;
+                }
+                if (q >= end)
+                {
+                    truncated = !last;
+                    return false;
+                }
+                token.data = p + 1;
+                token.size = q - p - 1;
+                p = q + 1;
+                return true;
+            }
+
+            const char* q = p;
+            // '-' only starts a numeral, never an edge operator
+            if (*q == '-' && (q + 1 >= end || q[1] == '-' || q[1] == '>'))
+            {
+                truncated = q + 1 >= end && !last;
+                return false;
+            }
+            while (q < end && is_id_char(*q) && !(*q == '-' && q + 1 < end && (q[1] == '-' || q[1] == '>')))
+                q ++;
+            if (q == p)
+                return false;
+            if (q == end && !last)
+            {
+                truncated = true;
+                return false;
+            }
+            token.data = p;
+            token.size = q - p;
+            p = q;
+            return true;
+        }
+
+        // "--" or "->"
+        bool read_edge_op()
+        {
+            skip_space();
+            if (p + 1 < end && p[0] == '-' && (p[1] == '-' || p[1] == '>'))
+            {
+                p += 2;
+                return true;
+            }
+            if (p + 1 >= end && !last)
+                truncated = true;
+            return false;
+        }
+    };
+
+    static bool equals(const Token& t, const char* word)
+    {
+        size_t n = std::strlen(word);
+        return t.size == n && std::memcmp(t.data, word, n) == 0;
+    }
+
+    static double to_number(const Token& t)
+    {
+        const char* p = t.data;
+        const char* end = t.data + t.size;
+        bool negative = p < end && *p == '-';
+        if (negative)
+            p ++;
+
+        double value = 0;
+        while (p < end && *p >= '0' && *p <= '9')
+            value = value * 10 + (*p ++ - '0');
+
+        if (p < end && *p == '.')
+        {
+            double scale = 0.1;
+            for (p ++; p < end && *p >= '0' && *p <= '9'; p ++, scale /= 10)
+                value += (*p - '0') * scale;
+        }
+        return negative ? -value : value;
+    }
+
+    std::vector<std::pair<std::string, std::string> > attributes;
+    bool directed;
+    bool open;
+
+    const char* mapped;
+    size_t mapped_size;
+    std::ifstream stream;
+    size_t chunk_size;
+    std::vector<char> contents;     // the whole stream, when it cannot be mapped and is read in parallel
+
+    // parser state of one chunk in read_parallel
+    struct Scratch { };
+    DotReader(Scratch)
+    {
+        directed = false;
+        open = true;
+        mapped = 0;
+        mapped_size = 0;
+        chunk_size = 0;
+    }
+
+    DotReader(const DotReader&);
+    DotReader& operator=(const DotReader&);
+
+    // "[k=v, k=v]"; returns false when the list runs past the buffer
+    bool read_attribute_list(Cursor& c, double* weight, bool graph_level)
+    {
+        c.skip(); // '['
+        for (;;)
+        {
+            c.skip_space();
+            if (c.at_end())
+            {
+                c.truncated = true;
+                return false;
+            }
+            char ch = c.peek();
+            if (ch == ']')
+            {
+                c.skip();
+                return true;
+            }
+            if (ch == ',' || ch == ';')
+            {
+                c.skip();
+                continue;
+            }
+
+            Token key, value;
+            if (!c.read_id(key))
+            {
+                if (c.truncated)
+                    return false;
+                c.skip();
+                continue;
+            }
+
+            c.skip_space();
+            if (c.peek() != '=')
+                continue;
+            c.skip();
+            if (!c.read_id(value))
+            {
+                if (c.truncated)
+                    return false;
+                continue;
+            }
+
+            if (weight && (equals(key, "label") || equals(key, "weight")))
+                *weight = to_number(value);
+            if (graph_level)
+                attributes.push_back(std::make_pair(std::string(key.data, key.size), std::string(value.data, value.size)));
+        }
+    }
+
+    // Parses one statement; returns false when it needs more input.
+    template<class HANDLER>
+    bool read_statement(Cursor& c, HANDLER& handler)
+    {
+        c.skip_space();
+        char ch = c.peek();
+        if (ch == '{' || ch == '}' || ch == ';' || ch == ',')
+        {
+            c.skip();
+            return true;
+        }
+
+        Token first;
+        if (!c.read_id(first))
+        {
+            if (c.truncated)
+                return false;
+            c.skip();
+            return true;
+        }
+
+        if (equals(first, "strict"))
+            return true;
+
+        if (equals(first, "graph") || equals(first, "digraph") || equals(first, "node") || equals(first, "edge"))
+        {
+            if (equals(first, "digraph"))
+                directed = true;
+
+            c.skip_space();
+            if (c.peek() == '[')
+                return read_attribute_list(c, 0, equals(first, "graph"));
+            if (c.peek() != '{' && c.peek() != '=')
+            {
+                Token name;
+                c.read_id(name);
+                return !c.truncated;
+            }
+            if (c.peek() == '{')
+                return true;
+        }
+
+        c.skip_space();
+        if (c.peek() == '=')
+        {
+            Token value;
+            c.skip();
+            if (!c.read_id(value))
+                return !c.truncated;
+            attributes.push_back(std::make_pair(std::string(first.data, first.size), std::string(value.data, value.size)));
+            return true;
+        }
+
+        Token chain[2] = { first, first };
+        bool is_edge = false;
+        double weight = 1;
+        const char* chain_start = c.position();
+
+        // resolve the weight first: it follows the last vertex of a chain
+        while (c.read_edge_op())
+        {
+            is_edge = true;
+            if (!c.read_id(chain[1]))
+                return !c.truncated;
+        }
+        if (c.truncated)
+            return false;
+
+        c.skip_space();
+        if (c.peek() == '[' && !read_attribute_list(c, &weight, false))
+            return false;
+        if (c.truncated)
+            return false;
+
+        if (!is_edge)
+        {
+            handler.vertex(first.data, first.size);
+            return true;
+        }
+
+        // replay the chain from its start, now that the weight is known
+        Cursor replay(chain_start, c.position(), true);
+        chain[0] = first;
+        while (replay.read_edge_op())
+        {
+            replay.read_id(chain[1]);
+            handler.edge(chain[0].data, chain[0].size, chain[1].data, chain[1].size, weight);
+            chain[0] = chain[1];
+        }
+        return true;
+    }
+
+    void read_header(const char* begin, const char* end)
+    {
+        Cursor c(begin, end, true);
+        Token word;
+        while (c.read_id(word))
+        {
+            if (equals(word, "strict"))
+                continue;
+            if (equals(word, "digraph"))
+                directed = true;
+            if (equals(word, "graph") || equals(word, "digraph"))
+                return;
+            break;
+        }
+
+        // bare edge list: the first operator decides
+        for (const char* p = begin; p + 1 < end; p ++)
+        {
+            if (p[0] == '-' && p[1] == '>')
+            {
+                directed = true;
+                return;
+            }
+            if (p[0] == '-' && p[1] == '-')
+                return;
+        }
+    }
+
+public:
+    DotReader(const std::string& filename, size_t chunk_size = 1 << 22)
+    {
+        directed = false;
+        open = false;
+        mapped = 0;
+        mapped_size = 0;
+        this->chunk_size = chunk_size;
+
+#ifdef DOT_READER_MMAP
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0)
+            {
+                void* p = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED)
+                {
+                    madvise(p, st.st_size, MADV_SEQUENTIAL);
+                    mapped = (const char*) p;
+                    mapped_size = st.st_size;
+                }
+            }
+            ::close(fd);
+        }
+#endif
+
+        if (mapped)
+        {
+            open = true;
+            read_header(mapped, mapped + mapped_size);
+        }
+        else
+        {
+            stream.open(filename.c_str(), std::ios::binary);
+            open = stream.is_open();
+            if (open)
+            {
+                std::vector<char> head(4096);
+                stream.read(&head[0], head.size());
+                read_header(&head[0], &head[0] + stream.gcount());
+                stream.clear();
+                stream.seekg(0);
+            }
+        }
+    }
+
+    ~DotReader()
+    {
+#ifdef DOT_READER_MMAP
+        if (mapped)
+        {
+            munmap((void*) mapped, mapped_size);
+        }
+#endif
+    }
+
+    bool is_open() const { return open; }
+    bool is_directed() const { return directed; }
+
+    // graph-level "key=value" statements, e.g. the label line of test.dot
+    const std::vector<std::pair<std::string, std::string> >& get_attributes() const { return attributes; }
+
+    // Tokenizes [begin, end) and returns where parsing stopped: end, or the
+    // start of a statement that continues past the buffer when !last.
+    template<class HANDLER>
+    const char* parse(const char* begin, const char* end, HANDLER& handler, bool last = true)
+    {
+        Cursor c(begin, end, last);
+        for (;;)
+        {
+            const char* start = c.position();
+            c.skip_space();
+            if (c.truncated)
+                return start;
+            if (c.at_end())
+                return end;
+            if (!read_statement(c, handler))
+                return start;
+        }
+    }
+
+    // Splits the input at line boundaries into handlers.size() chunks of about
+    // the same size and parses chunk i into handlers[i] on threads cores
+    // (0 = all of them). A statement must not run across a line boundary that
+    // ends a chunk, which holds for edge lists and for save_graph output.
+    template<class HANDLER>
+    void read_parallel(std::vector<HANDLER>& handlers, unsigned threads = 0)
+    {
+        STATS_PHASE(load_ms);
+        attributes.clear();
+        if (!open || handlers.empty())
+        {
+            return;
+        }
+
+        const char* begin = mapped;
+        size_t size = mapped_size;
+        if (!mapped)
+        {
+            stream.clear();
+            stream.seekg(0);
+            contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+            begin = contents.empty() ? 0 : &contents[0];
+            size = contents.size();
+        }
+
+        unsigned n = handlers.size();
+        std::vector<const char*> bounds(n + 1, begin + size);
+        bounds[0] = begin;
+        for (unsigned i = 1; i < n; i++)
+        {
+            const char* p = std::max(begin + size * i / n, bounds[i - 1]);
+            const char* newline = p < begin + size ? (const char*) std::memchr(p, '\n', begin + size - p) : 0;
+            bounds[i] = newline ? newline + 1 : begin + size;
+        }
+
+        std::vector<std::unique_ptr<DotReader> > readers(n);
+        ThreadPool pool(std::min(threads ? threads : default_threads(), n));
+        pool.for_each(0, n, [&](unsigned i, unsigned) {
+            readers[i].reset(new DotReader(Scratch()));
+            readers[i]->parse(bounds[i], bounds[i + 1], handlers[i]);
+        });
+
+        for (unsigned i = 0; i < n; i++)
+        {
+            directed = directed || readers[i]->directed;
+            attributes.insert(attributes.end(), readers[i]->attributes.begin(), readers[i]->attributes.end());
+        }
+    }
+
+    template<class HANDLER>
+    void read(HANDLER& handler)
+    {
+        STATS_PHASE(load_ms);
+        attributes.clear();
+
+        if (mapped)
+        {
+            parse(mapped, mapped + mapped_size, handler);
+            return;
+        }
+
+        if (!open)
+        {
+            return;
+        }
+
+        std::vector<char> buffer(chunk_size);
+        size_t pending = 0;
+        while (stream)
+        {
+            if (pending == buffer.size())
+            {
+                buffer.resize(buffer.size() * 2);
+            }
+            stream.read(&buffer[pending], buffer.size() - pending);
+            size_t size = pending + stream.gcount();
+            bool last = !stream;
+
+            const char* begin = &buffer[0];
+            const char* stop = parse(begin, begin + size, handler, last);
+            pending = begin + size - stop;
+            std::memmove(&buffer[0], stop, pending);
+        }
+    }
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "overlay.hpp"
+#include "pooled_label.hpp"
+#include "thread_pool.hpp"
+#include "instrumentation.hpp"
+
+
+// DOT export in the layout of Graph::save_graph for any number of overlays.
+// Every edge line is serialized once, up to its attributes, into one buffer;
+// each output is then assembled from those pieces in memory and written with
+// a single call, never flushing line by line.
+class DotWriter
+{
+
+public:
+    // one rendering of the graph: overlay edges are highlighted, or are the
+    // only edges written when highlighted_only is set
+    struct Output
+    {
+        std::string filename;       // ignored by write_multi
+        std::string name;           // graph name, for write_multi
+        const EdgeOverlay* overlay; // may be null
+        std::string label;
+
+        Output() { overlay = 0; }
+    };
+
+private:
+    std::string lines;              // "\tsrc -- dst [label=w" per edge, back to back
+    std::vector<size_t> offsets;    // edge i is lines[offsets[i], offsets[i + 1])
+    bool highlighted_only;
+
+    void append_edge(std::string& out, unsigned e, bool red) const
+    {
+        out.append(lines, offsets[e], offsets[e + 1] - offsets[e]);
+        if (red)
+            out += ", penwidth=3, color=\"red\"";
+        out += "]\n";
+    }
+
+    static bool write_file(const std::string& filename, const std::string& text)
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file.write(text.data(), text.size());
+        return (bool) file;
+    }
+
+    static std::string to_text(const std::string& s) { return s; }
+    static std::string to_text(const char* s) { return s; }
+    static std::string to_text(const PooledLabel& s) { return s.str(); }
+
+    template<class T>
+    static std::string to_text(const T& value)
+    {
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    }
+
+public:
+    DotWriter() { offsets.push_back(0); highlighted_only = false; }
+
+    void reserve(size_t edges, size_t bytes)
+    {
+        offsets.reserve(edges + 1);
+        lines.reserve(bytes);
+    }
+
+    // edges must be added in index order
+    template<class SOURCE, class DESTINATION, class WEIGHT>
+    void add_edge(const SOURCE& source, const DESTINATION& destination, const WEIGHT& weight)
+    {
+        lines += "\t";
+        lines += to_text(source);
+        lines += " -- ";
+        lines += to_text(destination);
+        lines += " [label=";
+        lines += to_text(weight);
+        offsets.push_back(lines.size());
+    }
+
+    unsigned num_edges() const { return (unsigned) offsets.size() - 1; }
+
+    void set_highlighted_only(bool only) { highlighted_only = only; }
+
+    // appends the whole graph to out, named when name is not empty
+    void render(std::string& out, const EdgeOverlay* overlay, std::string label, std::string name = "") const
+    {
+        out += name.empty() ? "graph { \n" : "graph \"" + name + "\" { \n";
+        out += label;
+        out += "\n";
+
+        if (highlighted_only)
+        {
+            std::vector<unsigned> edges;
+            if (overlay)
+                edges = overlay->edges();
+            std::sort(edges.begin(), edges.end());
+            for (unsigned i = 0; i < edges.size(); i++)
+            {
+                if (edges[i] < num_edges())
+                    append_edge(out, edges[i], true);
+            }
+        }
+        else
+        {
+            for (unsigned e = 0; e < num_edges(); e++)
+            {
+                append_edge(out, e, overlay && overlay->contains(e));
+            }
+        }
+        out += "}\n";
+    }
+
+    bool write(std::string filename, const EdgeOverlay* overlay, std::string label = "") const
+    {
+        STATS_PHASE(save_ms);
+        std::string text;
+        text.reserve(lines.size() + num_edges() * 4 + label.size() + 16);
+        render(text, overlay, label);
+        return write_file(filename, text);
+    }
+
+    // one file per output, rendered and written on threads cores (0 = all of them)
+    bool write_all(const std::vector<Output>& outputs, unsigned threads = 0) const
+    {
+        STATS_PHASE(save_ms);
+        ThreadPool pool(std::min<unsigned>(threads ? threads : default_threads(), std::max<size_t>(outputs.size(), 1)));
+        std::vector<std::string> buffers(pool.size());
+        std::vector<char> written(outputs.size(), 0);
+
+        pool.for_each(0, outputs.size(), [&](unsigned i, unsigned worker) {
+            std::string& text = buffers[worker];
+            text.clear();
+            render(text, outputs[i].overlay, outputs[i].label);
+            written[i] = write_file(outputs[i].filename, text);
+        });
+        return std::find(written.begin(), written.end(), 0) == written.end();
+    }
+
+    // all outputs as successive named graphs of one file, which dot renders page by page
+    bool write_multi(std::string filename, const std::vector<Output>& outputs) const
+    {
+        STATS_PHASE(save_ms);
+        std::string text;
+        for (unsigned i = 0; i < outputs.size(); i++)
+        {
+            render(text, outputs[i].overlay, outputs[i].label, outputs[i].name);
+        }
+        return write_file(filename, text);
+    }
+};
@@ -0,0 +1,432 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+#include "traversal.hpp"
+#include "overlay.hpp"
+
+
+// Minimum spanning forest of a GRAPH such as Graph<VDATA, EDATA, WEIGHTS>,
+// kept up to date as a listener of the graph; edge directions are ignored.
+//
+// The forest is held in a link-cut tree where each tree edge is a node of
+// its own between its two endpoints, so the heaviest edge on the path
+// between two vertices is an O(log n) amortized query. Then
+//  - a new edge, or a non-tree edge made lighter, replaces the heaviest edge
+//    on the cycle it closes when it is lighter than it;
+//  - a tree edge removed or made heavier is cut, and the lightest edge
+//    across the cut, if any, joins the two halves again. Both halves are
+//    walked in lockstep until the smaller one is complete, and only the
+//    edges around that one are tried, so this step costs the size of the
+//    smaller half and its incident edges.
+// Other updates only touch the edge itself. The tree edges and their total
+// weight are read back without any recomputation.
+//
+// The forest must be destroyed before its graph is.
+template<class GRAPH>
+class DynamicSpanningForest : public GRAPH::Listener
+{
+
+public:
+    typedef typename GRAPH::Vertex Vertex;
+    typedef typename GRAPH::Edge Edge;
+    typedef typename GRAPH::EdgeData EDATA;
+
+private:
+    enum { NONE = ~0u };
+
+    struct Node
+    {
+        unsigned child[2];
+        unsigned parent;
+        bool flip;
+        Edge* edge;         // null for vertex nodes
+        unsigned heaviest;  // edge node of largest weight in the splay subtree, NONE without any
+        unsigned position;  // in tree_edges, NONE for non-tree edges
+    };
+
+    std::vector<Node> nodes;
+    std::vector<unsigned> vertex_node;  // by vertex index
+    std::vector<unsigned> free_nodes;   // edge nodes to reuse
+    std::vector<unsigned> pending;      // splay scratch
+    std::unordered_map<Edge*, unsigned> edge_node;
+    std::vector<std::vector<Edge*> > incident;  // by vertex index, both ways, without self loops
+    std::vector<Edge*> tree_edges;
+    EDATA total;
+
+    // the two halves of a cut tree
+    VisitedSet seen[2];
+    std::vector<unsigned> half[2];
+
+    DynamicSpanningForest(const DynamicSpanningForest&);
+    DynamicSpanningForest& operator=(const DynamicSpanningForest&);
+
+    // link-cut tree over nodes
+
+    bool is_root(unsigned x) const
+    {
+        unsigned p = nodes[x].parent;
+        return p == NONE || (nodes[p].child[0] != x && nodes[p].child[1] != x);
+    }
+
+    unsigned heavier(unsigned a, unsigned b) const
+    {
+        if (a == NONE)
+            return b;
+        if (b == NONE)
+            return a;
+        return nodes[b].edge->get_weight() > nodes[a].edge->get_weight() ? b : a;
+    }
+
+    void pull(unsigned x)
+    {
+        Node& n = nodes[x];
+        n.heaviest = n.edge ? x : NONE;
+        for (unsigned i = 0; i < 2; i++)
+        {
+            if (n.child[i] != NONE)
+                n.heaviest = heavier(n.heaviest, nodes[n.child[i]].heaviest);
+        }
+    }
+
+    void push(unsigned x)
+    {
+        Node& n = nodes[x];
+        if (n.flip)
+        {
+            std::swap(n.child[0], n.child[1]);
+            for (unsigned i = 0; i < 2; i++)
+            {
+                if (n.child[i] != NONE)
+                    nodes[n.child[i]].flip = !nodes[n.child[i]].flip;
+            }
+            n.flip = false;
+        }
+    }
+
+    void rotate(unsigned x)
+    {
+        unsigned p = nodes[x].parent;
+        unsigned g = nodes[p].parent;
+        unsigned side = nodes[p].child[1] == x;
+
+        if (!is_root(p))
+            nodes[g].child[nodes[g].child[1] == p] = x;
+        nodes[x].parent = g;
+
+        nodes[p].child[side] = nodes[x].child[!side];
+        if (nodes[x].child[!side] != NONE)
+            nodes[nodes[x].child[!side]].parent = p;
+
+        nodes[x].child[!side] = p;
+        nodes[p].parent = x;
+        pull(p);
+        pull(x);
+    }
+
+    void splay(unsigned x)
+    {
+        pending.assign(1, x);
+        for (unsigned y = x; !is_root(y); y = nodes[y].parent)
+            pending.push_back(nodes[y].parent);
+        for (unsigned i = pending.size(); i-- > 0; )
+            push(pending[i]);
+
+        while (!is_root(x))
+        {
+            unsigned p = nodes[x].parent;
+            if (!is_root(p))
+                rotate((nodes[p].child[1] == x) == (nodes[nodes[p].parent].child[1] == p) ? p : x);
+            rotate(x);
+        }
+    }
+
+    void access(unsigned x)
+    {
+        unsigned last = NONE;
+        for (unsigned y = x; y != NONE; y = nodes[y].parent)
+        {
+            splay(y);
+            nodes[y].child[1] = last;
+            pull(y);
+            last = y;
+        }
+        splay(x);
+    }
+
+    void make_root(unsigned x)
+    {
+        access(x);
+        nodes[x].flip = !nodes[x].flip;
+    }
+
+    unsigned find_root(unsigned x)
+    {
+        access(x);
+        for (push(x); nodes[x].child[0] != NONE; push(x))
+            x = nodes[x].child[0];
+        splay(x);
+        return x;
+    }
+
+    void link(unsigned x, unsigned y)
+    {
+        make_root(x);
+        nodes[x].parent = y;
+    }
+
+    // x and y must be adjacent
+    void cut(unsigned x, unsigned y)
+    {
+        make_root(x);
+        access(y);
+        nodes[y].child[0] = NONE;
+        nodes[x].parent = NONE;
+        pull(y);
+    }
+
+    unsigned new_node(Edge* edge)
+    {
+        Node n = { { NONE, NONE }, NONE, false, edge, NONE, NONE };
+        unsigned x;
+        if (!free_nodes.empty())
+        {
+            x = free_nodes.back();
+            free_nodes.pop_back();
+            nodes[x] = n;
+        }
+        else
+        {
+            x = nodes.size();
+            nodes.push_back(n);
+        }
+        pull(x);
+        return x;
+    }
+
+    // forest bookkeeping
+
+    unsigned source(Edge* e) const { return vertex_node[e->get_source_index()]; }
+    unsigned destination(Edge* e) const { return vertex_node[e->get_destination_index()]; }
+
+    bool in_forest(Edge* e) const { return nodes[edge_node.find(e)->second].position != (unsigned) NONE; }
+
+    static unsigned other_end(Edge* e, unsigned v)
+    {
+        unsigned s = e->get_source_index();
+        return s == v ? e->get_destination_index() : s;
+    }
+
+    void add_tree_edge(Edge* e)
+    {
+        unsigned x = edge_node[e];
+        nodes[x].position = tree_edges.size();
+        tree_edges.push_back(e);
+        total = total + e->get_weight();
+        link(source(e), x);
+        link(x, destination(e));
+    }
+
+    void remove_tree_edge(Edge* e, EDATA weight)
+    {
+        unsigned x = edge_node[e];
+        cut(source(e), x);
+        cut(x, destination(e));
+
+        unsigned pos = nodes[x].position;
+        tree_edges[pos] = tree_edges.back();
+        nodes[edge_node[tree_edges[pos]]].position = pos;
+        tree_edges.pop_back();
+        nodes[x].position = NONE;
+        total = total - weight;
+    }
+
+    // e, not in the forest, joins it if it connects two trees or beats the
+    // heaviest edge of the cycle it closes
+    void offer(Edge* e)
+    {
+        unsigned u = source(e), v = destination(e);
+        if (u == v)
+            return;
+        if (find_root(u) != find_root(v))
+        {
+            add_tree_edge(e);
+            return;
+        }
+
+        make_root(u);
+        access(v);
+        Edge* worst = nodes[nodes[v].heaviest].edge;
+        if (e->get_weight() < worst->get_weight())
+        {
+            remove_tree_edge(worst, worst->get_weight());
+            add_tree_edge(e);
+        }
+    }
+
+    // After the tree edge between vertices a and b was cut, joins the two
+    // halves with the lightest edge between them, if there is one.
+    void reconnect(unsigned a, unsigned b)
+    {
+        unsigned ends[2] = { a, b };
+        unsigned head[2] = { 0, 0 };
+        for (unsigned k = 0; k < 2; k++)
+        {
+            seen[k].clear(incident.size());
+            seen[k].insert(ends[k]);
+            half[k].assign(1, ends[k]);
+        }
+
+        // one vertex from each half in turn, until a half has no more
+        unsigned k = 0;
+        for (;;)
+        {
+            unsigned v = half[k][head[k] ++];
+            for (unsigned i = 0; i < incident[v].size(); i++)
+            {
+                Edge* f = incident[v][i];
+                unsigned t = other_end(f, v);
+                if (in_forest(f) && seen[k].insert(t))
+                    half[k].push_back(t);
+            }
+            if (head[k] == half[k].size())
+                break;
+            k = !k;
+        }
+
+        Edge* best = 0;
+        for (unsigned j = 0; j < half[k].size(); j++)
+        {
+            unsigned v = half[k][j];
+            for (unsigned i = 0; i < incident[v].size(); i++)
+            {
+                Edge* f = incident[v][i];
+                if (!seen[k].contains(other_end(f, v)) && (!best || f->get_weight() < best->get_weight()))
+                    best = f;
+            }
+        }
+        if (best)
+            add_tree_edge(best);
+    }
+
+    void unlink_incident(Edge* e, unsigned v)
+    {
+        std::vector<Edge*>& edges = incident[v];
+        edges.erase(std::find(edges.begin(), edges.end(), e));
+    }
+
+public:
+    // Kruskal on the current edges, then kept up to date
+    DynamicSpanningForest(GRAPH& g) : total()
+    {
+        for (unsigned v = 0; v < g.num_vertices(); v++)
+        {
+            vertex_node.push_back(new_node(0));
+        }
+        incident.resize(g.num_vertices());
+
+        std::vector<std::pair<EDATA, Edge*> > sorted;
+        sorted.reserve(g.num_edges());
+        for (unsigned i = 0; i < g.num_edges(); i++)
+        {
+            Edge* e = g.get_edge(i);
+            edge_node[e] = new_node(e);
+            sorted.push_back(std::make_pair(e->get_weight(), e));
+            if (e->get_source() != e->get_destination())
+            {
+                incident[e->get_source_index()].push_back(e);
+                incident[e->get_destination_index()].push_back(e);
+            }
+        }
+        std::stable_sort(sorted.begin(), sorted.end(),
+            [](const std::pair<EDATA, Edge*>& a, const std::pair<EDATA, Edge*>& b) { return a.first < b.first; });
+
+        for (unsigned i = 0; i < sorted.size(); i++)
+        {
+            Edge* e = sorted[i].second;
+            if (source(e) != destination(e) && find_root(source(e)) != find_root(destination(e)))
+                add_tree_edge(e);
+        }
+        g.add_listener(this);
+    }
+
+    // in no particular order
+    const std::vector<Edge*>& edges() const { return tree_edges; }
+    unsigned size() const { return tree_edges.size(); }
+    EDATA get_weight() const { return total; }
+
+    bool contains(Edge* e) const { return edge_node.count(e) && in_forest(e); }
+
+    bool is_connected(Vertex* u, Vertex* v) { return find_root(vertex_node[u->get_index()]) == find_root(vertex_node[v->get_index()]); }
+
+    // the tree edges, for save_graph
+    EdgeOverlay overlay() const
+    {
+        EdgeOverlay forest;
+        for (unsigned i = 0; i < tree_edges.size(); i++)
+        {
+            forest.insert(tree_edges[i]->get_index());
+        }
+        return forest;
+    }
+
+    void vertex_added(Vertex*)
+    {
+        vertex_node.push_back(new_node(0));
+        incident.resize(vertex_node.size());
+    }
+
+    void edge_added(Edge* e)
+    {
+        edge_node[e] = new_node(e);
+        if (e->get_source() != e->get_destination())
+        {
+            incident[e->get_source_index()].push_back(e);
+            incident[e->get_destination_index()].push_back(e);
+        }
+        offer(e);
+    }
+
+    void edge_removing(Edge* e)
+    {
+        unsigned a = e->get_source_index();
+        unsigned b = e->get_destination_index();
+        if (a != b)
+        {
+            unlink_incident(e, a);
+            unlink_incident(e, b);
+        }
+
+        unsigned x = edge_node[e];
+        if (in_forest(e))
+        {
+            remove_tree_edge(e, e->get_weight());
+            reconnect(a, b);
+        }
+        edge_node.erase(e);
+        nodes[x].edge = 0;
+        free_nodes.push_back(x);
+    }
+
+    void weight_changed(Edge* e, EDATA old_weight)
+    {
+        if (!in_forest(e))
+        {
+            offer(e);
+            return;
+        }
+
+        total = total - old_weight + e->get_weight();
+        unsigned x = edge_node[e];
+        access(x);
+        pull(x);
+        if (old_weight < e->get_weight())
+        {
+            remove_tree_edge(e, e->get_weight());
+            reconnect(e->get_source_index(), e->get_destination_index());
+        }
+    }
+};
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "priority_queues.hpp"
+#include "traversal.hpp"
+#include "overlay.hpp"
+#include "instrumentation.hpp"
+
+
+// Shortest-path tree of one root kept up to date as the graph changes, for a
+// GRAPH such as Graph<VDATA, EDATA, WEIGHTS>. Listening to the graph, it
+// repairs only what a change affects:
+//  - a new edge or a lower weight relabels the vertices it brings closer and
+//    carries on, Dijkstra-like, from those alone;
+//  - a removed tree edge or a higher tree weight empties the subtree below
+//    it, labels each of its vertices from its best incoming edge outside the
+//    subtree and settles the subtree again from there.
+// Other changes cost nothing beyond a comparison, so the work follows the
+// number of vertices whose distance or parent changes and their arcs.
+//
+// Weights must not be negative. The tree must be destroyed before its graph
+// is; it stays valid when the graph is moved.
+template<class GRAPH>
+class DynamicShortestPathTree : public GRAPH::Listener
+{
+
+public:
+    typedef typename GRAPH::Vertex Vertex;
+    typedef typename GRAPH::Edge Edge;
+    typedef typename GRAPH::EdgeData EDATA;
+    typedef typename GRAPH::Weights WEIGHTS;
+
+private:
+    WEIGHTS weights;
+    bool directed;
+    Vertex* root;
+
+    std::vector<Vertex*> vertices;
+    std::vector<EDATA> distance;
+    std::vector<Edge*> parent;                  // null for the root and unreached vertices
+    std::vector<std::vector<Edge*> > incoming;  // directed graphs only; undirected use the adjacency
+
+    DaryHeap<> queue;
+    unsigned capacity;
+    VisitedSet subtree;
+    std::vector<Vertex*> stack;
+    Edge* removed;                              // the edge being removed, no longer to be used
+
+    DynamicShortestPathTree(const DynamicShortestPathTree&);
+    DynamicShortestPathTree& operator=(const DynamicShortestPathTree&);
+
+    unsigned in_degree(Vertex* v) const { return directed ? incoming[v->get_index()].size() : v->get_degree(); }
+    Edge* in_edge(Vertex* v, unsigned i) const { return directed ? incoming[v->get_index()][i] : v->get_edge(i); }
+
+    Vertex* other_end(Edge* e, Vertex* v) const { return e->get_source() == v ? e->get_destination() : e->get_source(); }
+
+    bool reached(unsigned v) const { return distance[v] < weights.infinity(); }
+
+    void label(Vertex* v, EDATA total, Edge* edge)
+    {
+        distance[v->get_index()] = total;
+        parent[v->get_index()] = edge;
+        queue.push(v->get_index(), weights.priority(total));
+        STATS_COUNT(queue_pushes);
+    }
+
+    // relaxes e from u, when it is usable in that direction
+    void relax(Edge* e, Vertex* u)
+    {
+        if (e == removed)
+            return;
+        Vertex* t = e->get_destination(u);
+        if (!t || !reached(u->get_index()))
+            return;
+        EDATA total = distance[u->get_index()] + e->get_weight();
+        if (total < distance[t->get_index()])
+            label(t, total, e);
+    }
+
+    // Dijkstra from the labeled vertices, all others being final
+    void propagate()
+    {
+        while (!queue.empty())
+        {
+            Vertex* u = vertices[queue.pop()];
+            STATS_COUNT(queue_pops);
+            STATS_COUNT(settled);
+            STATS_ADD(relaxations, u->get_degree());
+            for (unsigned i = 0; i < u->get_degree(); i++)
+            {
+                relax(u->get_edge(i), u);
+            }
+        }
+    }
+
+    // e got cheaper or appeared
+    void improve(Edge* e)
+    {
+        relax(e, e->get_source());
+        if (!directed)
+            relax(e, e->get_destination());
+        propagate();
+    }
+
+    // e got dearer or is going away
+    void repair(Edge* e)
+    {
+        Vertex* child = parent[e->get_destination_index()] == e ? e->get_destination()
+                      : parent[e->get_source_index()] == e ? e->get_source() : 0;
+        if (!child)
+            return;
+
+        // the subtree below e, found through the parent edges
+        subtree.clear(vertices.size());
+        subtree.insert(child->get_index());
+        stack.assign(1, child);
+        for (unsigned k = 0; k < stack.size(); k++)
+        {
+            Vertex* x = stack[k];
+            for (unsigned i = 0; i < x->get_degree(); i++)
+            {
+                Edge* f = x->get_edge(i);
+                Vertex* t = f->get_destination(x);
+                if (t && parent[t->get_index()] == f && subtree.insert(t->get_index()))
+                    stack.push_back(t);
+            }
+        }
+
+        for (unsigned k = 0; k < stack.size(); k++)
+        {
+            distance[stack[k]->get_index()] = weights.infinity();
+            parent[stack[k]->get_index()] = 0;
+        }
+
+        // best way into each subtree vertex from the rest of the tree
+        for (unsigned k = 0; k < stack.size(); k++)
+        {
+            Vertex* x = stack[k];
+            for (unsigned i = 0; i < in_degree(x); i++)
+            {
+                Edge* f = in_edge(x, i);
+                Vertex* s = other_end(f, x);
+                if (f == removed || subtree.contains(s->get_index()) || !reached(s->get_index()))
+                    continue;
+                EDATA total = distance[s->get_index()] + f->get_weight();
+                if (total < distance[x->get_index()])
+                    label(x, total, f);
+            }
+        }
+        propagate();
+    }
+
+    void grow(unsigned n)
+    {
+        if (n > capacity)
+        {
+            capacity = std::max(n, capacity * 2);
+            queue.reset(capacity);
+        }
+    }
+
+public:
+    DynamicShortestPathTree(GRAPH& g, Vertex* root) : weights(g.get_weights())
+    {
+        this->directed = g.is_directed();
+        this->root = root;
+        this->removed = 0;
+        this->capacity = 0;
+
+        unsigned n = g.num_vertices();
+        vertices.reserve(n);
+        for (unsigned v = 0; v < n; v++)
+        {
+            vertices.push_back(g.get_vertex(v));
+        }
+        distance.assign(n, weights.infinity());
+        parent.assign(n, 0);
+        if (directed)
+        {
+            incoming.resize(n);
+            for (unsigned e = 0; e < g.num_edges(); e++)
+            {
+                incoming[g.get_edge(e)->get_destination_index()].push_back(g.get_edge(e));
+            }
+        }
+        grow(n);
+
+        label(root, weights.zero(), 0);
+        propagate();
+        g.add_listener(this);
+    }
+
+    Vertex* get_root() const { return root; }
+
+    bool is_reachable(Vertex* v) const { return reached(v->get_index()); }
+    EDATA get_distance(Vertex* v) const { return distance[v->get_index()]; }
+    Edge* get_parent_edge(Vertex* v) const { return parent[v->get_index()]; }
+
+    // edges from end back to the root, empty when end is not reached
+    std::vector<Edge*> path(Vertex* end) const
+    {
+        std::vector<Edge*> edges;
+        for (Vertex* v = end; parent[v->get_index()]; v = other_end(parent[v->get_index()], v))
+        {
+            edges.push_back(parent[v->get_index()]);
+        }
+        return edges;
+    }
+
+    // every tree edge, for save_graph
+    EdgeOverlay overlay() const
+    {
+        EdgeOverlay tree;
+        for (unsigned v = 0; v < parent.size(); v++)
+        {
+            if (parent[v])
+                tree.insert(parent[v]->get_index());
+        }
+        return tree;
+    }
+
+    void vertex_added(Vertex* v)
+    {
+        vertices.push_back(v);
+        distance.push_back(weights.infinity());
+        parent.push_back(0);
+        if (directed)
+            incoming.resize(vertices.size());
+        grow(vertices.size());
+    }
+
+    void edge_added(Edge* e)
+    {
+        if (directed)
+            incoming[e->get_destination_index()].push_back(e);
+        improve(e);
+    }
+
+    void edge_removing(Edge* e)
+    {
+        removed = e;
+        repair(e);
+        removed = 0;
+
+        if (directed)
+        {
+            std::vector<Edge*>& in = incoming[e->get_destination_index()];
+            in.erase(std::find(in.begin(), in.end(), e));
+        }
+    }
+
+    void weight_changed(Edge* e, EDATA old_weight)
+    {
+        if (e->get_weight() < old_weight)
+            improve(e);
+        else if (old_weight < e->get_weight())
+            repair(e);
+    }
+};
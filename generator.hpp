@@ -0,0 +1,201 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <stdint.h>
+
+
+// Edge list of a synthetic graph; vertices are 0 .. nvertices - 1.
+struct GeneratedGraph
+{
+    std::string kind;
+    bool directed;
+    unsigned nvertices;
+    std::vector<unsigned> sources;
+    std::vector<unsigned> destinations;
+    std::vector<int> weights;
+
+    unsigned num_edges() const { return sources.size(); }
+
+    static std::string vertex_name(unsigned v) { return "v" + std::to_string(v); }
+
+    // DOT in the layout of Graph::save_graph, readable by DotReader
+    bool write_dot(std::string filename, std::string label = "") const
+    {
+        std::ofstream file(filename);
+        if (!file)
+            return false;
+
+        const char* arrow = directed ? " -> " : " -- ";
+        file << (directed ? "digraph {" : "graph {") << "\n";
+        file << "\tlabelloc=\"t\";labeljust=\"l\";label=\"" << kind << " np=" << nvertices << " " << label << "\"\n";
+        for (unsigned v = 0; v < nvertices; v++)
+        {
+            file << "\t" << vertex_name(v) << "\n";
+        }
+        for (unsigned i = 0; i < sources.size(); i++)
+        {
+            file << "\t" << vertex_name(sources[i]) << arrow << vertex_name(destinations[i])
+                 << " [label=" << weights[i] << "]\n";
+        }
+        file << "}\n";
+        return (bool) file;
+    }
+
+    // name(v) gives the value of vertex v
+    template<class GRAPH, class NAME>
+    void build(GRAPH& g, NAME name) const
+    {
+        g.reserve(nvertices, sources.size());
+        unsigned first = g.num_vertices();
+        for (unsigned v = 0; v < nvertices; v++)
+        {
+            g.add_vertex(name(v));
+        }
+        for (unsigned i = 0; i < sources.size(); i++)
+        {
+            g.add_edge(weights[i], g.get_vertex(first + sources[i]), g.get_vertex(first + destinations[i]));
+        }
+    }
+};
+
+
+// Seeded generator of random, grid, power-law (R-MAT) and dense graphs with
+// weights drawn uniformly from [min_weight, max_weight]. It draws from its own
+// xorshift stream, so a seed gives the same graph on every platform.
+class GraphGenerator
+{
+
+private:
+    uint64_t state;
+    int min_weight;
+    int max_weight;
+    bool directed;
+
+    uint64_t next()
+    {
+        // xorshift64*
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ull;
+    }
+
+    // uniform in [0, n), n > 0
+    unsigned below(unsigned n) { return (unsigned) (((next() >> 32) * n) >> 32); }
+
+    // uniform in [0, 1)
+    double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    int weight() { return min_weight + (int) below((unsigned) (max_weight - min_weight) + 1); }
+
+    GeneratedGraph start(std::string kind, unsigned n, unsigned long m)
+    {
+        GeneratedGraph g;
+        g.kind = kind;
+        g.directed = directed;
+        g.nvertices = n;
+        g.sources.reserve(m);
+        g.destinations.reserve(m);
+        g.weights.reserve(m);
+        return g;
+    }
+
+    void add(GeneratedGraph& g, unsigned u, unsigned v)
+    {
+        g.sources.push_back(u);
+        g.destinations.push_back(v);
+        g.weights.push_back(weight());
+    }
+
+public:
+    GraphGenerator(unsigned long seed, int min_weight = 1, int max_weight = 100, bool directed = false)
+    {
+        this->state = seed * 0x9E3779B97F4A7C15ull + 1;
+        this->min_weight = min_weight;
+        this->max_weight = max_weight < min_weight ? min_weight : max_weight;
+        this->directed = directed;
+    }
+
+    // m edges between uniformly drawn distinct endpoints (parallel edges possible)
+    GeneratedGraph random(unsigned n, unsigned long m)
+    {
+        GeneratedGraph g = start("random", n, m);
+        for (unsigned long i = 0; n > 1 && i < m; i++)
+        {
+            unsigned u = below(n);
+            unsigned v = below(n - 1);
+            add(g, u, v < u ? v : v + 1);
+        }
+        return g;
+    }
+
+    // rows x cols lattice, each vertex joined to its right and lower neighbours
+    GeneratedGraph grid(unsigned rows, unsigned cols)
+    {
+        GeneratedGraph g = start("grid", rows * cols, 2ul * rows * cols);
+        for (unsigned r = 0; r < rows; r++)
+        {
+            for (unsigned c = 0; c < cols; c++)
+            {
+                unsigned v = r * cols + c;
+                if (c + 1 < cols)
+                    add(g, v, v + 1);
+                if (r + 1 < rows)
+                    add(g, v, v + cols);
+            }
+        }
+        return g;
+    }
+
+    // 2^scale vertices, so scale must be below 31, and edge_factor edges per
+    // vertex, each placed by descending the adjacency matrix quadrants with
+    // probabilities a, b, c and 1 - a - b - c (Chakrabarti et al.); self
+    // loops are dropped.
+    GeneratedGraph rmat(unsigned scale, unsigned edge_factor, double a = 0.57, double b = 0.19, double c = 0.19)
+    {
+        unsigned n = 1u << scale;
+        unsigned long m = (unsigned long) edge_factor * n;
+        GeneratedGraph g = start("rmat", n, m);
+        for (unsigned long i = 0; i < m; i++)
+        {
+            unsigned u = 0, v = 0;
+            for (unsigned bit = 0; bit < scale; bit++)
+            {
+                double p = unit();
+                u <<= 1;
+                v <<= 1;
+                if (p < a)
+                    continue;
+                else if (p < a + b)
+                    v |= 1;
+                else if (p < a + b + c)
+                    u |= 1;
+                else
+                {
+                    u |= 1;
+                    v |= 1;
+                }
+            }
+            if (u != v)
+                add(g, u, v);
+        }
+        return g;
+    }
+
+    // every pair once, both ways when directed
+    GeneratedGraph dense(unsigned n)
+    {
+        GeneratedGraph g = start("dense", n, (unsigned long) n * (n - (n > 0)) / (directed ? 1 : 2));
+        for (unsigned u = 0; u < n; u++)
+        {
+            for (unsigned v = directed ? 0 : u + 1; v < n; v++)
+            {
+                if (u != v)
+                    add(g, u, v);
+            }
+        }
+        return g;
+    }
+};
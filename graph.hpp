@@ -1,16 +1,37 @@
 #pragma once
 
 #include <vector>
-#include <set>
+#include <algorithm>
 #include <queue>
 #include <stack>
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <functional>
-
-
-template<class VDATA, class EDATA>
+#include <memory>
+#include <mutex>
+
+#include "arena.hpp"
+#include "compact_graph.hpp"
+#include "components.hpp"
+#include "label_index.hpp"
+#include "pooled_label.hpp"
+#include "graph_snapshot.hpp"
+#include "spanning_forest.hpp"
+#include "all_sources.hpp"
+#include "distance_matrix.hpp"
+#include "contraction_hierarchy.hpp"
+#include "batch_paths.hpp"
+#include "traversal.hpp"
+#include "parallel_bfs.hpp"
+#include "overlay.hpp"
+#include "subgraph_mask.hpp"
+#include "dot_writer.hpp"
+#include "dynamic_sssp.hpp"
+#include "dynamic_msf.hpp"
+
+
+template<class VDATA, class EDATA, class WEIGHTS = DefaultWeights<EDATA> >
 class Graph
 {
 
@@ -31,10 +52,10 @@ public:
 
     private:
         unsigned pos;
-        std::vector<ELEMP>* array;
+        const std::vector<ELEMP>* array;
 
     public:
-        ArrayIterator(std::vector<ELEMP>* p) { pos = 0; this->array = p; }
+        ArrayIterator(const std::vector<ELEMP>* p) { pos = 0; this->array = p; }
         bool has_next() { return pos < array->size(); }
         void next() { pos ++; }
         ELEMP current() { return has_next() ? (*array)[pos] : 0; }
@@ -61,29 +82,70 @@ public:
         void push(unsigned prio, ELEMP elem) { queue.push(Token(prio, elem)); }
     };
 
+    typedef VDATA VertexData;
+    typedef EDATA EdgeData;
+    typedef WEIGHTS Weights;
+
+    class Vertex;
     class Edge;
+    class Listener;
+
+    // Change counter shared by the graph and its edges, with the listeners to
+    // tell; also where edges find the vertices their indices refer to.
+    struct Revision
+    {
+        unsigned long count;
+        std::vector<Listener*> listeners;
+        const std::vector<Vertex*>* vertices;
+        bool directed;
+
+        Revision(const std::vector<Vertex*>* vertices, bool directed)
+        {
+            count = 1;
+            this->vertices = vertices;
+            this->directed = directed;
+        }
+
+        void remove(Listener* listener)
+        {
+            listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+        }
+    };
 
     class Vertex {
     private:
         VDATA value;
-        unsigned index;
         std::vector<Edge*> edges;
-        unsigned mark;
+        unsigned index;
 
     public:
         Vertex(VDATA value, unsigned index) { this->value = value; this->index = index; }
-        unsigned get_degree() { return edges.size(); }
-        unsigned get_index() { return index; }
+        unsigned get_degree() const { return edges.size(); }
+        unsigned get_capacity() const { return edges.capacity(); }
+        unsigned get_index() const { return index; }
         VDATA& get_value() { return value; }
+        const VDATA& get_value() const { return value; }
+        // bypasses the vertex index, use Graph::set_vertex_value on indexed graphs
         void set_value(VDATA v) { value = v; }
         void add_neighbor(Edge* neighbor) { edges.push_back(neighbor); }
-        Edge* get_edge(unsigned i) { return edges[i]; }
-        ArrayIterator<Edge*> neighbor_iterator() { return ArrayIterator<Edge*>(&edges); }
+        void reserve(unsigned degree) { edges.reserve(degree); }
+
+        void remove_neighbor(Edge* neighbor)
+        {
+            auto found = std::find(edges.begin(), edges.end(), neighbor);
+            if (found != edges.end())
+            {
+                edges.erase(found);
+            }
+        }
+        Edge* get_edge(unsigned i) const { return edges[i]; }
+        ArrayIterator<Edge*> neighbor_iterator() const { return ArrayIterator<Edge*>(&edges); }
 
         Edge* find_edge(Vertex* destination)
         {
             for (unsigned int i=0; i<edges.size(); i++)
             {
+                STATS_COUNT(find_edge_scans);
                 Vertex* dest = edges[i]->get_destination(this);
                 if (dest == destination)
                 {
@@ -94,40 +156,57 @@ public:
         }
     };
 
+    // Ends are kept as 32-bit vertex indices rather than pointers, the
+    // direction with the graph and the red mark in the top bit of the index,
+    // which keeps an edge at 24 bytes for int weights.
     class Edge
     {
+        friend class Graph;
 
     private:
         EDATA weight;
-        Vertex* source;
-        Vertex* destination;
-        bool directed;
-        unsigned int index;
-        bool red;
+        unsigned source;
+        unsigned destination;
+        unsigned int index : 31;
+        unsigned int red : 1;
+        Revision* revision;
 
     public:
-        Edge(EDATA weight, Vertex* source, Vertex* destination, unsigned index, bool directed = false)
+        Edge(EDATA weight, Vertex* source, Vertex* destination, unsigned index, Revision* revision)
         {
             this->weight = weight;
-            this->source = source;
-            this->destination = destination;
-            this->directed = directed;
+            this->source = source->get_index();
+            this->destination = destination->get_index();
             this->index = index;
             this->red = false;
+            this->revision = revision;
         }
 
-        EDATA get_weight() { return weight; }
-        void set_weight(EDATA w) { weight = w; }
-        unsigned get_index() { return index; }
-        Vertex* get_source() { return source; }
-        Vertex* get_destination() { return destination; }
+        EDATA get_weight() const { return weight; }
 
-        Vertex* get_destination(Vertex* source)
+        void set_weight(EDATA w)
         {
-            if (source == this->source)
-                return destination;
-            if (!directed && source == this->destination)
-                return this->source;
+            EDATA old = weight;
+            weight = w;
+            revision->count ++;
+            for (unsigned int i=0; i<revision->listeners.size(); i++)
+            {
+                revision->listeners[i]->weight_changed(this, old);
+            }
+        }
+
+        unsigned get_index() const { return index; }
+        Vertex* get_source() const { return (*revision->vertices)[source]; }
+        Vertex* get_destination() const { return (*revision->vertices)[destination]; }
+        unsigned get_source_index() const { return source; }
+        unsigned get_destination_index() const { return destination; }
+
+        Vertex* get_destination(Vertex* source) const
+        {
+            if (source->get_index() == this->source)
+                return get_destination();
+            if (!revision->directed && source->get_index() == this->destination)
+                return get_source();
             return 0;
         }
 
@@ -141,40 +220,90 @@ public:
             this->red = false;
         }
 
-        bool is_red()
+        bool is_red() const
         {
             return this->red;
         }
     };
 
-    void save_graph(std::string filename, std::string label = "")
+    // Told of every change once registered with add_listener, see
+    // dynamic_sssp.hpp. Callbacks must not add or remove listeners; a listener
+    // destroyed first unregisters itself, a graph destroyed first lets its
+    // listeners go.
+    class Listener
     {
-        std::ofstream file(filename);
+        friend class Graph;
 
-        file << "graph { " << std::endl;
-        file << label << std::endl;
+    private:
+        Revision* observed;
 
-        for(unsigned int i = 0; i < this->edges.size(); i++)
-        {
-            file << "\t" << this->edges[i]->get_source()->get_value()
-                 << " -- " << this->edges[i]->get_destination()->get_value()
-                 << " [label=" << this->edges[i]->get_weight();
+        Listener(const Listener&);
+        Listener& operator=(const Listener&);
 
-            if(this->edges[i]->is_red())
+    public:
+        Listener() { observed = 0; }
+
+        virtual ~Listener()
+        {
+            if (observed)
             {
-                file << ", penwidth=3, color=\"red\"";
+                observed->remove(this);
             }
-
-            file << "]" << std::endl;
         }
 
-        file << "}" << std::endl;
+        virtual void vertex_added(Vertex*) { }
+        virtual void edge_added(Edge*) { }
+        // still in the graph when called
+        virtual void edge_removing(Edge*) { }
+        // with the weight the edge had before
+        virtual void weight_changed(Edge*, EDATA) { }
+        // edge moved from old_index into the index of a removed edge
+        virtual void edge_reindexed(Edge*, unsigned) { }
+    };
 
-        file.close();
+    // edges marked red are highlighted
+    void save_graph(std::string filename, std::string label = "") const
+    {
+        write_dot(filename, label, 0);
     }
 
-    Vertex* get_vertex_data(VDATA data)
+    // edges of the overlay are highlighted, whatever their marks
+    void save_graph(std::string filename, const EdgeOverlay& overlay, std::string label = "") const
     {
+        write_dot(filename, label, &overlay);
+    }
+
+    // The edge lines serialized once, to write any number of overlays without
+    // going through the graph again. Reflects the graph as it is now.
+    DotWriter dot_writer() const
+    {
+        DotWriter writer;
+        writer.reserve(edges.size(), edges.size() * 24);
+        for(unsigned int i = 0; i < this->edges.size(); i++)
+        {
+            writer.add_edge(edges[i]->get_source()->get_value(), edges[i]->get_destination()->get_value(), edges[i]->get_weight());
+        }
+        return writer;
+    }
+
+    // A vertex value from characters, which need not end in a null: interned
+    // in the graph's pool when VDATA is PooledLabel, built through a std::string
+    // otherwise. Any number of threads may call it at once.
+    VDATA intern_label(const char* data, size_t size) const
+    {
+        return make_label<VDATA>(labels.get(), data, size);
+    }
+
+    VDATA intern_label(const std::string& s) const { return intern_label(s.data(), s.size()); }
+
+    Vertex* get_vertex_data(VDATA data) const
+    {
+        if (indexed)
+        {
+            unsigned found = vertex_index.find(data, vertex_values());
+            return found != LabelIndex<VDATA>::NONE ? vertices[found] : nullptr;
+        }
+
         for(unsigned int i = 0; i < this->vertices.size(); i++)
         {
             if(vertices[i]->get_value() == data)
@@ -188,77 +317,147 @@ public:
 
 private:
 
-    std::function<int(EDATA&)> maxWeight;
-    std::function<int(EDATA&)> minWeight;
-    std::function<int(EDATA&)> priorityWeight;
-
-    class DepthFirstIterator : public QueueIterator<Vertex*>
+    void write_dot(std::string filename, std::string label, const EdgeOverlay* overlay) const
     {
+        if (overlay)
+        {
+            dot_writer().write(filename, overlay, label);
+            return;
+        }
 
-    private:
-        std::set<unsigned> visited;
-        unsigned counter;
-
-        void visit(Vertex* v)
+        EdgeOverlay red;
+        for(unsigned int i = 0; i < this->edges.size(); i++)
         {
-            unsigned index = v->get_index();
-            if (visited.count(index) > 0)
+            if(this->edges[i]->is_red())
             {
-                return;
+                red.insert(i);
             }
-            this->push(counter ++, v);
-            visited.insert(index);
+        }
+        dot_writer().write(filename, &red, label);
+    }
 
-            for (auto ne = v->neighbor_iterator(); ne.has_next(); ne.next())
+    // zero, infinity and queue key of distances, see weights.hpp
+    WEIGHTS weights;
+
+    // Traversals run lazily on the compact form with a workspace borrowed from
+    // the graph; a copy carries on independently from the same position.
+    // FILTER restricts them to a subgraph, see View.
+    template<class TRAVERSAL, class FILTER = WholeGraph>
+    class TraversalIterator : public Iterator<Vertex*>
+    {
+
+    private:
+        const Graph* graph;
+        std::shared_ptr<TraversalWorkspace> work;
+        TRAVERSAL traversal;
+        FILTER filter;
+        // frozen once, and again only when the graph has changed since
+        const CompactGraph<EDATA>* compact;
+        unsigned long frozen_revision;
+
+        const CompactGraph<EDATA>& frozen()
+        {
+            if (frozen_revision != graph->revision->count)
             {
-                Edge* edge = ne.current();
-                Vertex* neighbor = edge->get_destination(v);
-                visit(neighbor);
+                compact = &graph->freeze();
+                frozen_revision = graph->revision->count;
             }
+            return *compact;
         }
 
     public:
-        DepthFirstIterator(Vertex* start) { counter = 0; visit(start); }
+        TraversalIterator(const Graph* g, Vertex* start, FILTER filter = FILTER()) : graph(g), work(g->acquire_workspace()),
+            traversal(work.get(), g->vertices.size(), start->get_index()), filter(filter), compact(0), frozen_revision(0) { }
+
+        TraversalIterator(const TraversalIterator& src) : graph(src.graph), work(src.graph->acquire_workspace()),
+            traversal(src.traversal), filter(src.filter), compact(src.compact), frozen_revision(src.frozen_revision)
+        {
+            *work = *src.work;
+            traversal.rebind(work.get());
+        }
+
+        bool has_next() { return traversal.has_next(); }
+        void next() { if (traversal.has_next()) traversal.next(frozen(), filter); }
+        Vertex* current() { return traversal.has_next() ? graph->vertices[traversal.current()] : 0; }
+
+        // edges from the start vertex to the current one
+        unsigned depth() { return traversal.depth(); }
     };
 
-    class BreadthFirstIterator : public QueueIterator<Vertex*>
-    {
+    typedef TraversalIterator<DepthFirstTraversal<EDATA> > DepthFirstIterator;
+    typedef TraversalIterator<BreadthFirstTraversal<EDATA> > BreadthFirstIterator;
 
-    private:
-        std::set<unsigned> visited;
+    // workspaces not held by a live traversal are handed out again
+    mutable std::vector<std::shared_ptr<TraversalWorkspace> > workspaces;
 
-    public:
-        BreadthFirstIterator(Vertex* start) {
-            this->push(0, start);
-            visited.insert(start->get_index());
+    std::shared_ptr<TraversalWorkspace> acquire_workspace() const
+    {
+        std::lock_guard<std::mutex> lock(cache_lock);
+        for (unsigned int i=0; i<workspaces.size(); i++)
+        {
+            if (workspaces[i].use_count() == 1)
+            {
+                return workspaces[i];
+            }
         }
+        workspaces.push_back(std::make_shared<TraversalWorkspace>());
+        return workspaces.back();
+    }
 
-        void next()
+    // Dijkstra searches of the point-to-point queries, kept with their arrays
+    // between queries and handed out again like the traversal workspaces, one
+    // kind per queue policy; one-sided queries use forward alone.
+    template<class QUEUE>
+    struct SearchPair
+    {
+        typename CompactGraph<EDATA>::template Search<QUEUE> forward;
+        typename CompactGraph<EDATA>::template Search<QUEUE> backward;
+    };
+
+    mutable std::vector<std::pair<const void*, std::shared_ptr<void> > > searches;    // (queue policy tag, SearchPair)
+
+    template<class QUEUE>
+    std::shared_ptr<SearchPair<QUEUE> > acquire_search() const
+    {
+        static const char tag = 0;
+        std::lock_guard<std::mutex> lock(cache_lock);
+        for (unsigned int i=0; i<searches.size(); i++)
         {
-            if (this->queue.size() == 0)
+            if (searches[i].first == &tag && searches[i].second.use_count() == 1)
             {
-                return;
+                return std::static_pointer_cast<SearchPair<QUEUE> >(searches[i].second);
             }
+        }
+        std::shared_ptr<SearchPair<QUEUE> > pair = std::make_shared<SearchPair<QUEUE> >();
+        searches.push_back(std::make_pair((const void*) &tag, std::shared_ptr<void>(pair)));
+        return pair;
+    }
 
-            auto token = this->queue.top();
-            Vertex* v = token.elem;
-            this->queue.pop();
+    // vertices of a BreadthFirstTree level by level
+    class LevelOrderIterator : public Iterator<Vertex*>
+    {
 
-            unsigned depth = token.priority + 1;
+    private:
+        std::vector<Vertex*> order;
+        std::vector<unsigned> depths;
+        unsigned pos;
 
-            for (auto ne = v->neighbor_iterator(); ne.has_next(); ne.next())
+    public:
+        LevelOrderIterator(const Graph* g, const BreadthFirstTree& tree)
+        {
+            std::vector<unsigned> indices = tree.order();
+            for (unsigned int i=0; i<indices.size(); i++)
             {
-                Edge* edge = ne.current();
-                Vertex* neighbor = edge->get_destination(v);
-                unsigned index = neighbor->get_index();
-                if (visited.count(index) == 0)
-                {
-                    this->push(depth, neighbor);
-                    visited.insert(index);
-                }
-
+                order.push_back(g->vertices[indices[i]]);
+                depths.push_back(tree.depth[indices[i]]);
             }
+            pos = 0;
         }
+
+        bool has_next() { return pos < order.size(); }
+        void next() { pos ++; }
+        Vertex* current() { return has_next() ? order[pos] : 0; }
+        unsigned depth() { return depths[pos]; }
     };
 
     class EdgeListIterator : public ArrayIterator<Edge*>
@@ -275,334 +474,909 @@ private:
             sarray = src.sarray;
         }
         void push(Edge* edge) {sarray.push_back(edge);}
+
+        // the listed edges, for save_graph
+        EdgeOverlay overlay() const
+        {
+            EdgeOverlay edges;
+            for (unsigned int i=0; i<sarray.size(); i++)
+            {
+                edges.insert(sarray[i]->get_index());
+            }
+            return edges;
+        }
     };
 
-    class SpanningTreeIteratorBuilder
+public:
+    // A subgraph given by a mask, queried in place: the engines skip what the
+    // mask leaves out and nothing is copied. It borrows the graph and the
+    // mask, which must outlive it; the queries start from vertices it keeps.
+    class View
     {
 
     private:
-        QueueIterator<Edge*> queue;
-        std::set<unsigned> missing;
-        EdgeListIterator iter;
-        Graph *graph;
+        const Graph* graph;
+        const SubgraphMask* mask;
 
-        void visit_vertex(Vertex *v)
+    public:
+        View(const Graph* g, const SubgraphMask* mask)
         {
-            for (auto ne = v->neighbor_iterator(); ne.has_next(); ne.next())
-            {
-                Edge* e = ne.current();
-                Vertex* neighbor = e->get_destination(v);
+            this->graph = g;
+            this->mask = mask;
+        }
+
+        // the filter of the engines
+        bool vertex(unsigned v) const { return mask->vertex(v); }
+        bool edge(unsigned e) const { return mask->edge(e); }
+
+        bool contains(Vertex* v) const { return mask->vertex(v->get_index()); }
+        bool contains(Edge* e) const
+        {
+            return mask->edge(e->get_index()) && contains(e->get_source()) && contains(e->get_destination());
+        }
 
-                if (missing.count(neighbor->get_index()))
+        TraversalIterator<DepthFirstTraversal<EDATA>, View> depth_first_iterator(Vertex* start) const
+        {
+            return TraversalIterator<DepthFirstTraversal<EDATA>, View>(graph, start, *this);
+        }
+
+        TraversalIterator<BreadthFirstTraversal<EDATA>, View> breadth_first_iterator(Vertex* start) const
+        {
+            return TraversalIterator<BreadthFirstTraversal<EDATA>, View>(graph, start, *this);
+        }
+
+        // spanning forest of the view, from start when given
+        EdgeListIterator min_spanning_tree_iterator(Vertex* start = 0) const
+        {
+            STATS_PHASE(compute_ms);
+            return graph->edge_list_iterator(graph->freeze().min_spanning_tree(start ? start->get_index() : 0, *this));
+        }
+
+        template<class QUEUE = DaryHeap<> >
+        EdgeListIterator shortest_path_tree_iterator(Vertex* start) const
+        {
+            STATS_PHASE(compute_ms);
+            std::shared_ptr<SearchPair<QUEUE> > pair = graph->template acquire_search<QUEUE>();
+            typename CompactGraph<EDATA>::template Search<QUEUE>& search = pair->forward;
+            std::vector<unsigned> path;
+            if (contains(start))
+            {
+                graph->freeze().shortest_path_tree(start->get_index(), graph->weights, search, *this);
+                for (unsigned int i=0; i<search.parent.size(); i++)
                 {
-                    queue.push((unsigned) e->get_weight(), e);
+                    if (search.parent[i] != CompactGraph<EDATA>::NONE)
+                    {
+                        path.push_back(search.parent[i]);
+                    }
                 }
             }
-            missing.erase(v->get_index());
+            return graph->edge_list_iterator(path);
         }
 
-        Vertex* get_next_vertex()
+        template<class QUEUE = DaryHeap<> >
+        EdgeListIterator shortest_path_iterator(Vertex* start, Vertex* end) const
         {
-            Vertex *v = 0;
-            Edge* e = queue.current();
-            queue.next();
-            unsigned s = e->get_source()->get_index();
-            unsigned d = e->get_destination()->get_index();
-
-            if (missing.count(s))
+            if (!end)
             {
-                v = e->get_source();
-                iter.push(e);
+                return shortest_path_tree_iterator<QUEUE>(start);
             }
-
-            if (missing.count(d))
+            STATS_PHASE(compute_ms);
+            if (!contains(start) || !contains(end) || !graph->components().may_reach(start->get_index(), end->get_index()))
             {
-                v = e->get_destination();
-                iter.push(e);
+                return EdgeListIterator();
             }
-
-            return v;
+            std::shared_ptr<SearchPair<QUEUE> > search = graph->template acquire_search<QUEUE>();
+            return graph->edge_list_iterator(graph->freeze().shortest_path(start->get_index(), end->get_index(), graph->weights, search->forward, *this));
         }
 
-    public:
-        SpanningTreeIteratorBuilder(Graph* g, Vertex* start)
+        template<class QUEUE = DaryHeap<> >
+        EdgeListIterator bidirectional_shortest_path_iterator(Vertex* start, Vertex* end) const
         {
-            this->graph = g;
+            STATS_PHASE(compute_ms);
+            if (!contains(start) || !contains(end) || !graph->components().may_reach(start->get_index(), end->get_index()))
+            {
+                return EdgeListIterator();
+            }
+            const CompactGraph<EDATA>& g = graph->freeze();
+            const CompactGraph<EDATA>& reverse = graph->directed ? graph->freeze_reverse() : g;
+            std::shared_ptr<SearchPair<QUEUE> > search = graph->template acquire_search<QUEUE>();
+            return graph->edge_list_iterator(g.bidirectional_shortest_path(start->get_index(), end->get_index(), reverse, graph->weights, search->forward, search->backward, *this));
+        }
 
-            for (auto vi = g->vertex_iterator(); vi.has_next(); vi.next())
+        template<class HEURISTIC>
+        EdgeListIterator astar_path_iterator(Vertex* start, Vertex* end, HEURISTIC heuristic) const
+        {
+            STATS_PHASE(compute_ms);
+            if (!contains(start) || !contains(end) || !graph->components().may_reach(start->get_index(), end->get_index()))
             {
-                Vertex* v = vi.current();
-                missing.insert(v->get_index());
+                return EdgeListIterator();
             }
-            visit_vertex(start);
+            VertexHeuristic<HEURISTIC> h = { graph, heuristic };
+            std::shared_ptr<SearchPair<DaryHeap<> > > search = graph->template acquire_search<DaryHeap<> >();
+            return graph->edge_list_iterator(graph->freeze().astar_path(start->get_index(), end->get_index(), h, graph->weights, search->forward, *this));
         }
 
-        EdgeListIterator get()
+        // An owned copy of the view, in time linear in the parent graph. Vertices
+        // and edges keep their relative order but are numbered anew.
+        Graph materialize() const
         {
-            while (queue.has_next())
+            Graph g(graph->directed, graph->weights);
+            g.set_vertex_index(graph->indexed);
+            g.labels = graph->labels;
+
+            std::vector<unsigned> index(graph->vertices.size(), CompactGraph<EDATA>::NONE);
+            for (unsigned int i=0; i<graph->vertices.size(); i++)
             {
-                Vertex* v = get_next_vertex();
-                if (v)
+                if (vertex(i))
                 {
-                    visit_vertex(v);
+                    index[i] = g.add_vertex(graph->vertices[i]->get_value())->get_index();
                 }
-
-                if (!queue.has_next() && missing.size())
+            }
+            for (unsigned int i=0; i<graph->edges.size(); i++)
+            {
+                Edge* e = graph->edges[i];
+                if (contains(e))
                 {
-                    unsigned vi = *missing.begin();
-                    visit_vertex(this->graph->get_vertex(vi));
+                    g.add_edge(e->get_weight(), g.vertices[index[e->get_source_index()]], g.vertices[index[e->get_destination_index()]]);
                 }
             }
-
-            return iter;
+            return g;
         }
     };
 
+private:
+    // global graph attributes
+    std::vector<Vertex*> vertices;
+    std::vector<Edge*> edges;
+    bool directed;
 
-    class ShortestPathTreeIteratorBuilder
-    {
+    // vertices and edges live here rather than in individual allocations
+    Arena<Vertex> vertex_pool;
+    Arena<Edge> edge_pool;
 
-    private:
-        struct SPToken { Vertex* src; Vertex* dst; EDATA total; };
-        QueueIterator<unsigned> queue;
-        std::vector<SPToken> array;
-        Vertex* start;
-        std::function<int(EDATA&)> minWeight;
-        std::function<int(EDATA&)> maxWeight;
-        std::function<int(EDATA&)> priorityWeight;
+    Graph(const Graph&);
+    Graph& operator=(const Graph&);
 
-        void update_token(Vertex* src, Vertex* dst, EDATA total)
-        {
-            int index = dst->get_index();
-            array[index] = {src, dst, total};
-            unsigned prio = this->priorityWeight(total);
-            queue.push(prio, index);
-        }
+    // Any number of threads may read a const Graph at once, as long as none
+    // writes to it; the caches that reads fill in lazily are guarded by cache_lock.
+    mutable std::mutex cache_lock;
 
-    public:
-        ShortestPathTreeIteratorBuilder(Graph* g, Vertex* start, std::function<int(EDATA&)> minWeight, std::function<int(EDATA&)> maxWeight, std::function<int(EDATA&)> priorityWeight)
-        {
-            this->start = start;
-            this->minWeight = minWeight;
-            this->maxWeight = maxWeight;
-            this->priorityWeight = priorityWeight;
+    // compact adjacency, rebuilt by freeze() whenever revision moved on
+    Revision* revision;
+    mutable unsigned long compact_revision;
+    mutable CompactGraph<EDATA> compact;
+    mutable unsigned long reverse_revision;
+    mutable CompactGraph<EDATA> reverse_compact;
 
-            EDATA weight = g->edge_iterator().current()->get_weight();
+    template<class HEURISTIC>
+    struct VertexHeuristic
+    {
+        const Graph* graph;
+        HEURISTIC heuristic;
+        EDATA operator()(unsigned v) { return heuristic(graph->vertices[v]); }
+    };
 
-            int max = this->maxWeight(weight);
-            int min = this->minWeight(weight);
 
-            for (auto vi = g->vertex_iterator(); vi.has_next(); vi.next())
-            {
-                array.push_back({0, 0, 0});
-                Vertex* v = vi.current();
-                EDATA weight = (v == start) ? min : max;
-                update_token(v, v, weight);
-            }
+    const CompactGraph<EDATA>& freeze_reverse() const
+    {
+        const CompactGraph<EDATA>& g = freeze();
+        std::lock_guard<std::mutex> lock(cache_lock);
+        if (reverse_revision != revision->count)
+        {
+            reverse_compact = g.reversed();
+            reverse_revision = revision->count;
         }
+        return reverse_compact;
+    }
 
+    enum { DEFAULT_TREE_CACHE = 4 };
+    typedef typename BatchPathBuilder<EDATA>::Tree ShortestPathTree;
+    typedef typename BatchPathBuilder<EDATA>::TreeCache TreeCache;
 
-        EdgeListIterator get(Vertex* end)
+    // whole shortest-path trees by root, dropped as soon as the graph changes
+    mutable TreeCache tree_cache;
+    mutable unsigned long tree_cache_revision;
+
+    TreeCache& trees() const
+    {
+        std::lock_guard<std::mutex> lock(cache_lock);
+        if (tree_cache_revision != revision->count)
         {
-            while (queue.has_next())
-            {
-                unsigned vindex = queue.current();
-                queue.next();
-                Vertex* v = array[vindex].dst;
-                EDATA vtotal = array[vindex].total;
+            tree_cache.clear();
+            tree_cache_revision = revision->count;
+        }
+        return tree_cache;
+    }
 
-                for (auto ne = v->neighbor_iterator(); ne.has_next(); ne.next())
-                {
-                    Edge* e = ne.current();
-                    Vertex* neighbor = e->get_destination(v);
-                    unsigned nindex = neighbor->get_index();
-                    EDATA newtotal = vtotal + e->get_weight();
-                    if (newtotal < array[nindex].total)
-                        update_token(v, neighbor, newtotal);
-                }
-            }
+    // connected components once asked for, then kept up to date by the changes
+    mutable Components<EDATA> connectivity;
 
-            EdgeListIterator iter;
-            if (end)
-            {
-                Vertex* dst = end;
+    // optional VDATA -> vertex index lookup for get_vertex_data, reading the
+    // values from the vertices rather than keeping copies
+    struct VertexValues
+    {
+        const std::vector<Vertex*>* vertices;
+        const VDATA& operator()(unsigned i) const { return (*vertices)[i]->get_value(); }
+    };
 
-                while (dst != this->start) {
-                    unsigned index = dst->get_index();
-                    Vertex* src = array[index].src;
-                    if (src != dst)
-                    {
-                        Edge* edge = src->find_edge(dst);
-                        iter.push(edge);
-                    }
-                    else
-                    {
-                        break;
-                    }
-                    dst = src;
-                }
-            }
-            else
-            {
-                for (unsigned int i=0; i<array.size(); i++)
-                {
-                    Vertex* src = array[i].src;
-                    Vertex* dst = array[i].dst;
+    bool indexed;
+    LabelIndex<VDATA> vertex_index;
 
-                    if (src != dst)
-                    {
-                        Edge* edge = src->find_edge(dst);
-                        iter.push(edge);
-                    }
-                }
-            }
-            return iter;
-        }
-    };
+    // interned labels when VDATA is PooledLabel, shared with clones and subgraphs
+    std::shared_ptr<LabelPool> labels;
 
+    VertexValues vertex_values() const
+    {
+        VertexValues values = { &vertices };
+        return values;
+    }
 
-    // global graph attributes
-    std::vector<Vertex*> vertices;
-    std::vector<Edge*> edges;
-    bool directed;
+    // called within the queries, so its time is taken out of compute_ms
+    EdgeListIterator edge_list_iterator(const std::vector<unsigned>& indices) const
+    {
+        STATS_NESTED_PHASE(path_ms, compute_ms);
+        EdgeListIterator iter;
+        for (unsigned int i=0; i<indices.size(); i++)
+        {
+            iter.push(edges[indices[i]]);
+        }
+        return iter;
+    }
 
 public:
 
-    ArrayIterator<Vertex*> vertex_iterator() { return ArrayIterator<Vertex*>(&vertices); }
-    ArrayIterator<Edge*> edge_iterator() { return ArrayIterator<Edge*>(&edges); }
+    ArrayIterator<Vertex*> vertex_iterator() const { return ArrayIterator<Vertex*>(&vertices); }
+    ArrayIterator<Edge*> edge_iterator() const { return ArrayIterator<Edge*>(&edges); }
 
-    DepthFirstIterator depth_first_iterator(Vertex* start) { return DepthFirstIterator(start); }
-    BreadthFirstIterator breadth_first_iterator(Vertex* start) { return BreadthFirstIterator(start); }
+    // The read-only queries below are const and may run concurrently.
+    DepthFirstIterator depth_first_iterator(Vertex* start) const { return DepthFirstIterator(this, start); }
+    BreadthFirstIterator breadth_first_iterator(Vertex* start) const { return BreadthFirstIterator(this, start); }
 
-    Graph(bool dir, std::function<int(EDATA&)> max, std::function<int(EDATA&)> min, std::function<unsigned int(EDATA&)> priority)
+    // Depth and parent edge of every vertex reachable from start, level by
+    // level on threads cores (0 = all of them).
+    BreadthFirstTree breadth_first_tree(Vertex* start, unsigned threads = 0) const
     {
-        directed = dir;
-        this->maxWeight = max;
-        this->minWeight = min;
-        this->priorityWeight = priority;
+        STATS_PHASE(compute_ms);
+        const CompactGraph<EDATA>& g = freeze();
+        const CompactGraph<EDATA>& reverse = directed ? freeze_reverse() : g;
+        return ParallelBfsBuilder<EDATA>(&g, &reverse, threads).run(start->get_index());
     }
 
-    ~Graph()
+    // The vertices of breadth_first_tree in depth order, used like breadth_first_iterator.
+    LevelOrderIterator parallel_breadth_first_iterator(Vertex* start, unsigned threads = 0) const
     {
-        for (unsigned int i=0; i<vertices.size(); i++)
+        return LevelOrderIterator(this, breadth_first_tree(start, threads));
+    }
+
+    // whether end can be reached from start, stopping as soon as it is
+    bool is_reachable(Vertex* start, Vertex* end) const
+    {
+        STATS_PHASE(compute_ms);
+        const Components<EDATA>& c = components();
+        if (!c.may_reach(start->get_index(), end->get_index()))
+        {
+            return false;
+        }
+        if (!directed || c.strong_component(start->get_index()) == c.strong_component(end->get_index()))
         {
-            delete vertices[i];
+            return true;
         }
+        const CompactGraph<EDATA>& g = freeze();
+        std::shared_ptr<TraversalWorkspace> work = acquire_workspace();
+        for (BreadthFirstTraversal<EDATA> bfs(work.get(), vertices.size(), start->get_index()); bfs.has_next(); bfs.next(g))
+        {
+            if (bfs.current() == end->get_index())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
 
-        for (unsigned int i=0; i<edges.size(); i++)
+    Graph(bool dir, WEIGHTS weights = WEIGHTS()) : weights(weights)
+    {
+        directed = dir;
+        revision = new Revision(&vertices, directed);
+        compact_revision = 0;
+        reverse_revision = 0;
+        tree_cache.set_capacity(DEFAULT_TREE_CACHE);
+        tree_cache_revision = 0;
+        indexed = false;
+        labels = make_label_pool<VDATA>();
+    }
+
+    ~Graph()
+    {
+        for (unsigned int i=0; i<revision->listeners.size(); i++)
         {
-            delete edges[i];
+            revision->listeners[i]->observed = 0;
         }
+        delete revision;
     }
 
-    Graph(const Graph<VDATA,EDATA>& o)
+    // Moves leave o empty; iterators over o must not outlive the move.
+    Graph(Graph&& o) : weights(o.weights)
     {
         directed = o.directed;
+        revision = new Revision(&vertices, directed);
+        compact_revision = 0;
+        reverse_revision = 0;
+        tree_cache_revision = 0;
+        indexed = false;
+        labels = make_label_pool<VDATA>();
+        swap(o);
+    }
+
+    Graph& operator=(Graph&& o)
+    {
+        swap(o);
+        return *this;
+    }
+
+    void swap(Graph& o)
+    {
+        std::swap(weights, o.weights);
+        std::swap(directed, o.directed);
+        vertices.swap(o.vertices);
+        edges.swap(o.edges);
+        vertex_pool.swap(o.vertex_pool);
+        edge_pool.swap(o.edge_pool);
+        std::swap(revision, o.revision);
+        revision->vertices = &vertices;
+        o.revision->vertices = &o.vertices;
+        std::swap(compact_revision, o.compact_revision);
+        std::swap(compact, o.compact);
+        std::swap(reverse_revision, o.reverse_revision);
+        std::swap(reverse_compact, o.reverse_compact);
+        tree_cache.swap(o.tree_cache);
+        std::swap(tree_cache_revision, o.tree_cache_revision);
+        std::swap(connectivity, o.connectivity);
+        workspaces.swap(o.workspaces);
+        searches.swap(o.searches);
+        std::swap(indexed, o.indexed);
+        std::swap(vertex_index, o.vertex_index);
+        labels.swap(o.labels);
+    }
 
-        for (unsigned int i=0; i<o.vertices.size(); i++)
+    // Deep copy, with the same vertex and edge indices.
+    Graph clone() const
+    {
+        Graph g(directed, weights);
+        g.tree_cache.set_capacity(tree_cache.get_capacity());
+        g.indexed = indexed;
+        g.labels = labels;
+        g.reserve(vertices.size(), edges.size());
+
+        for (unsigned int i=0; i<vertices.size(); i++)
         {
-            add_vertex(o.vertices[i]->get_value());
+            g.add_vertex(vertices[i]->get_value());
         }
-        for (unsigned int i=0; i<o.edges.size(); i++)
+        for (unsigned int i=0; i<edges.size(); i++)
         {
-            unsigned isrc = o.edges[i]->get_source()->get_index();
-            unsigned idst = o.edges[i]->get_destination()->get_index();
-            add_edge(o.edges[i]->get_weight(), vertices[isrc], vertices[idst]);
+            unsigned isrc = edges[i]->get_source_index();
+            unsigned idst = edges[i]->get_destination_index();
+            g.add_edge(edges[i]->get_weight(), g.vertices[isrc], g.vertices[idst]);
         }
+        return g;
+    }
 
-        this->maxWeight = o.maxWeight;
-        this->minWeight = o.minWeight;
-        this->priorityWeight = o.priorityWeight;
+    // Room for that many more vertices and edges, allocated up front.
+    void reserve(unsigned nvertices, unsigned nedges)
+    {
+        vertices.reserve(vertices.size() + nvertices);
+        edges.reserve(edges.size() + nedges);
+        vertex_pool.reserve(nvertices);
+        edge_pool.reserve(nedges);
     }
 
-    unsigned num_vertices() { return vertices.size(); }
-    Vertex* get_vertex(unsigned i) { return vertices[i]; }
-    unsigned num_edges() { return vertices.size(); }
-    Edge* get_edge(unsigned i) { return edges[i]; }
-    bool is_directed() { return directed; }
+    unsigned num_vertices() const { return vertices.size(); }
+    Vertex* get_vertex(unsigned i) const { return vertices[i]; }
+    unsigned num_edges() const { return edges.size(); }
+    Edge* get_edge(unsigned i) const { return edges[i]; }
+    bool is_directed() const { return directed; }
+    const WEIGHTS& get_weights() const { return weights; }
 
     Vertex* add_vertex(VDATA data)
     {
-        Vertex* ret = new Vertex(data, vertices.size());
+        Vertex* ret = vertex_pool.create(data, vertices.size());
         vertices.push_back(ret);
+        revision->count ++;
+
+        if (indexed)
+        {
+            vertex_index.insert(ret->get_index(), vertex_values());
+        }
+        if (connectivity.is_built())
+        {
+            connectivity.vertex_added();
+        }
+        for (unsigned int i=0; i<revision->listeners.size(); i++)
+        {
+            revision->listeners[i]->vertex_added(ret);
+        }
         return ret;
     }
 
+    // Keeps a hash index from vertex values to vertices so that
+    // get_vertex_data no longer scans; duplicate values resolve to the first vertex.
+    void set_vertex_index(bool enable)
+    {
+        indexed = enable;
+        vertex_index.clear();
+
+        if (indexed)
+        {
+            vertex_index.reserve(vertices.size());
+            for (unsigned int i=0; i<vertices.size(); i++)
+            {
+                vertex_index.insert(i, vertex_values());
+            }
+        }
+    }
+
+    bool has_vertex_index() const { return indexed; }
+
+    // renaming is rare, so the index is simply rebuilt
+    void set_vertex_value(Vertex* v, VDATA data)
+    {
+        v->set_value(data);
+        if (indexed)
+        {
+            set_vertex_index(true);
+        }
+    }
+
     Edge* add_edge(EDATA weight, Vertex* source, Vertex* destination)
     {
         if (source && destination)
         {
-            Edge* ret = new Edge(weight, source, destination, edges.size(), is_directed());
+            Edge* ret = edge_pool.create(weight, source, destination, edges.size(), revision);
             edges.push_back(ret);
+            revision->count ++;
             source->add_neighbor(ret);
 
             if (!directed)
             {
                 destination->add_neighbor(ret);
             }
+            if (connectivity.is_built())
+            {
+                connectivity.edge_added(source->get_index(), destination->get_index());
+            }
 
+            for (unsigned int i=0; i<revision->listeners.size(); i++)
+            {
+                revision->listeners[i]->edge_added(ret);
+            }
             return ret;
         }
         return 0;
     }
 
-    Graph subgraph(ArrayIterator<Edge*>* iterp, bool keep_vertices = false)
+    // Bulk add_edge: edge i joins the vertices of indices sources[i] and
+    // destinations[i]. Degrees are counted first so that every adjacency is
+    // allocated once at its final size, then the edges are scattered into
+    // them in order; the result is the same as adding them one at a time.
+    // Returns false, adding nothing, when the arrays differ in size or an
+    // index is out of range.
+    bool add_edges(const std::vector<unsigned>& sources, const std::vector<unsigned>& destinations, const std::vector<EDATA>& weights)
     {
-        Graph subgraph(is_directed());
-        std::map<unsigned,unsigned> vertexmap;
+        unsigned n = sources.size();
+        if (destinations.size() != n || weights.size() != n)
+        {
+            return false;
+        }
 
-        if (keep_vertices)
+        std::vector<unsigned> degree(vertices.size(), 0);
+        for (unsigned int i=0; i<n; i++)
+        {
+            if (sources[i] >= vertices.size() || destinations[i] >= vertices.size())
+            {
+                return false;
+            }
+            degree[sources[i]] ++;
+            if (!directed)
+            {
+                degree[destinations[i]] ++;
+            }
+        }
+        for (unsigned int v=0; v<vertices.size(); v++)
+        {
+            if (degree[v])
+            {
+                vertices[v]->reserve(vertices[v]->get_degree() + degree[v]);
+            }
+        }
+
+        reserve(0, n);
+        for (unsigned int i=0; i<n; i++)
+        {
+            Vertex* source = vertices[sources[i]];
+            Vertex* destination = vertices[destinations[i]];
+            Edge* e = edge_pool.create(weights[i], source, destination, edges.size(), revision);
+            edges.push_back(e);
+            source->add_neighbor(e);
+            if (!directed)
+            {
+                destination->add_neighbor(e);
+            }
+            if (connectivity.is_built())
+            {
+                connectivity.edge_added(sources[i], destinations[i]);
+            }
+        }
+        revision->count ++;
+
+        for (unsigned int l=0; l<revision->listeners.size(); l++)
+        {
+            for (unsigned int i=edges.size()-n; i<edges.size(); i++)
+            {
+                revision->listeners[l]->edge_added(edges[i]);
+            }
+        }
+        return true;
+    }
+
+    // The last edge takes the index of the removed one, which listeners hear
+    // of through edge_reindexed. The removed edge is destroyed and its memory
+    // goes to the next edge added.
+    void remove_edge(Edge* edge)
+    {
+        for (unsigned int i=0; i<revision->listeners.size(); i++)
         {
-            for (int i=0; i<vertices.size(); i++)
+            revision->listeners[i]->edge_removing(edge);
+        }
+
+        edge->get_source()->remove_neighbor(edge);
+        if (!directed)
+        {
+            edge->get_destination()->remove_neighbor(edge);
+        }
+
+        Edge* last = edges.back();
+        unsigned old_index = last->index;
+        edges[edge->index] = last;
+        last->index = edge->index;
+        edges.pop_back();
+        edge_pool.destroy(edge);
+        revision->count ++;
+        connectivity.edge_removed();
+
+        if (last != edge)
+        {
+            for (unsigned int i=0; i<revision->listeners.size(); i++)
             {
-                Vertex* v1 = vertices[i];
-                Vertex* v2 = subgraph.add_vertex(v1->get_value());
-                vertexmap[v1->get_index()] = v2->get_index();
+                revision->listeners[i]->edge_reindexed(last, old_index);
             }
         }
+    }
+
+    // listener is told of every later change, until removed or destroyed
+    void add_listener(Listener* listener)
+    {
+        listener->observed = revision;
+        revision->listeners.push_back(listener);
+    }
+
+    void remove_listener(Listener* listener)
+    {
+        revision->remove(listener);
+        listener->observed = 0;
+    }
+
+    // Sized for this graph, with everything in or nothing; see View.
+    SubgraphMask subgraph_mask(bool all = false) const
+    {
+        return SubgraphMask(vertices.size(), edges.size(), all);
+    }
+
+    // mask must outlive the view
+    View view(const SubgraphMask& mask) const
+    {
+        return View(this, &mask);
+    }
+
+    // Copy of the listed edges with their ends, or with every vertex when
+    // keep_vertices is set.
+    Graph subgraph(ArrayIterator<Edge*>* iterp, bool keep_vertices = false) const
+    {
+        SubgraphMask mask = subgraph_mask();
+        if (keep_vertices)
+        {
+            mask.set_all_vertices();
+        }
 
         while (iterp->has_next())
         {
             Edge* edge = iterp->current();
-            unsigned src = edge->get_source()->get_index();
-            unsigned dst = edge->get_destination()->get_index();
+            mask.set_edge(edge->get_index());
+            mask.set_vertex(edge->get_source_index());
+            mask.set_vertex(edge->get_destination_index());
+            iterp->next();
+        }
+        return view(mask).materialize();
+    }
+
+    // Builds (or refreshes) the compact adjacency used by every algorithm below.
+    const CompactGraph<EDATA>& freeze() const
+    {
+        std::lock_guard<std::mutex> lock(cache_lock);
+        if (compact_revision != revision->count)
+        {
+            std::vector<unsigned> src(edges.size());
+            std::vector<unsigned> dst(edges.size());
+            std::vector<EDATA> weight(edges.size());
 
-            if (!keep_vertices)
+            for (unsigned int i=0; i<edges.size(); i++)
             {
-                if (vertexmap.find(src) == vertexmap.end())
-                {
-                    Vertex* v = subgraph.add_vertex(edge->get_source()->get_value());
-                    vertexmap[src] = v->get_index();
-                }
+                src[i] = edges[i]->get_source_index();
+                dst[i] = edges[i]->get_destination_index();
+                weight[i] = edges[i]->get_weight();
+            }
 
-                if (vertexmap.find(dst) == vertexmap.end())
-                {
-                    Vertex* v = subgraph.add_vertex(edge->get_destination()->get_value());
-                    vertexmap[dst] = v->get_index();
-                }
+            compact = CompactGraph<EDATA>(directed, vertices.size(), src, dst, weight);
+            compact_revision = revision->count;
+        }
+        return compact;
+    }
+
+    bool is_frozen() const { std::lock_guard<std::mutex> lock(cache_lock); return compact_revision == revision->count; }
+
+    // Connected components by vertex index, see components.hpp. Built on first
+    // use, then updated edge by edge as the graph grows; a removed edge, or on
+    // directed graphs an edge against the order of the strong components, has
+    // them built again on the next call.
+    const Components<EDATA>& components() const
+    {
+        {
+            std::lock_guard<std::mutex> lock(cache_lock);
+            if (connectivity.is_current())
+            {
+                return connectivity;
             }
+        }
+        const CompactGraph<EDATA>& g = freeze();
+        std::lock_guard<std::mutex> lock(cache_lock);
+        if (!connectivity.is_current())
+        {
+            connectivity.build(g);
+        }
+        return connectivity;
+    }
 
-            Vertex *ret_src = subgraph.vertices[vertexmap[src]];
-            Vertex *ret_dst = subgraph.vertices[vertexmap[dst]];
-            subgraph.add_edge(edge->get_weight(), ret_src, ret_dst);
-            iterp->next();
+    // Bytes held by the graph, by part.
+    struct MemoryUsage
+    {
+        size_t vertices;        // vertex records, values included
+        size_t labels;          // what vertex values hold outside their records, e.g. long strings,
+                                // or the label pool, which graphs sharing it each count
+        size_t adjacency;       // edge lists of the vertices
+        size_t edges;           // edge records
+        size_t tables;          // vertex and edge tables by index
+        size_t index;           // get_vertex_data lookup
+        size_t compact;         // frozen forms, forward and reversed
+        size_t components;
+
+        size_t total() const { return vertices + labels + adjacency + edges + tables + index + compact + components; }
+    };
+
+    MemoryUsage memory_usage() const
+    {
+        std::lock_guard<std::mutex> lock(cache_lock);
+        MemoryUsage usage;
+        usage.vertices = vertex_pool.capacity_bytes();
+        usage.labels = 0;
+        usage.adjacency = 0;
+        for (unsigned int i=0; i<vertices.size(); i++)
+        {
+            usage.labels += label_heap_bytes(vertices[i]->get_value());
+            usage.adjacency += vertices[i]->get_capacity() * sizeof(Edge*);
         }
-        return subgraph;
+        usage.edges = edge_pool.capacity_bytes();
+        usage.tables = (vertices.capacity() + edges.capacity()) * sizeof(void*);
+        usage.labels += labels ? labels->memory_usage() : 0;
+        usage.index = vertex_index.memory_usage();
+        usage.compact = compact.memory_usage() + reverse_compact.memory_usage();
+        usage.components = connectivity.memory_usage();
+        return usage;
     }
 
-    EdgeListIterator min_spanning_tree_iterator(Vertex* start = 0)
+    // Writes the compact form and the vertex labels as a GraphSnapshot.
+    bool save_snapshot(std::string filename) const
     {
-        return SpanningTreeIteratorBuilder(this, start ? start : vertices[0]).get();
+        std::vector<std::string> labels(vertices.size());
+        for (unsigned int i=0; i<vertices.size(); i++)
+        {
+            labels[i] = snapshot_label(vertices[i]->get_value());
+        }
+        return GraphSnapshot<EDATA>::write(filename, freeze(), labels);
     }
 
-    EdgeListIterator shortest_path_tree_iterator(Vertex* start)
+    enum SpanningTreeEngine { PRIM, KRUSKAL, BORUVKA };
+
+    EdgeListIterator min_spanning_tree_iterator(Vertex* start = 0) const
     {
-        return shortest_path_iterator(start, 0);
+        STATS_PHASE(compute_ms);
+        return edge_list_iterator(freeze().min_spanning_tree(start ? start->get_index() : 0));
     }
 
-    EdgeListIterator shortest_path_iterator(Vertex* start, Vertex* end)
+    // Minimum spanning tree of the component of start alone, rather than a
+    // forest over the whole graph; on directed graphs, of what start reaches.
+    EdgeListIterator component_spanning_tree_iterator(Vertex* start) const
     {
-        return ShortestPathTreeIteratorBuilder(this, start, minWeight, maxWeight, priorityWeight).get(end);
+        STATS_PHASE(compute_ms);
+        unsigned size = directed ? CompactGraph<EDATA>::NONE : components().component_size(start->get_index());
+        return edge_list_iterator(freeze().component_spanning_tree(start->get_index(), size));
+    }
+
+    // Minimum spanning forest with the chosen engine; threads = 0 uses every core.
+    EdgeListIterator min_spanning_tree_iterator(SpanningTreeEngine engine, unsigned threads = 0) const
+    {
+        STATS_PHASE(compute_ms);
+        const CompactGraph<EDATA>& g = freeze();
+        switch (engine)
+        {
+        case KRUSKAL:
+            return edge_list_iterator(KruskalBuilder<EDATA>(&g, threads).get());
+        case BORUVKA:
+            return edge_list_iterator(BoruvkaBuilder<EDATA>(&g, threads).get());
+        default:
+            return edge_list_iterator(g.min_spanning_tree());
+        }
+    }
+
+    // QUEUE selects the priority queue policy, see priority_queues.hpp
+    template<class QUEUE = DaryHeap<> >
+    EdgeListIterator shortest_path_tree_iterator(Vertex* start) const
+    {
+        STATS_PHASE(compute_ms);
+        const CompactGraph<EDATA>& g = freeze();
+        unsigned long key = (unsigned long) start->get_index() * 2;
+        std::shared_ptr<const ShortestPathTree> tree = trees().get(key);
+        if (!tree)
+        {
+            std::shared_ptr<ShortestPathTree> grown(new ShortestPathTree(g.template shortest_path_tree<QUEUE>(start->get_index(), weights)));
+            tree_cache.put(key, grown);
+            tree = grown;
+        }
+
+        std::vector<unsigned> path;
+        for (unsigned int i=0; i<tree->parent.size(); i++)
+        {
+            if (tree->parent[i] != CompactGraph<EDATA>::NONE)
+            {
+                path.push_back(tree->parent[i]);
+            }
+        }
+        return edge_list_iterator(path);
+    }
+
+    // Stops as soon as end is settled; without end this is the whole tree.
+    template<class QUEUE = DaryHeap<> >
+    EdgeListIterator shortest_path_iterator(Vertex* start, Vertex* end) const
+    {
+        if (!end)
+        {
+            return shortest_path_tree_iterator<QUEUE>(start);
+        }
+        STATS_PHASE(compute_ms);
+        if (!components().may_reach(start->get_index(), end->get_index()))
+        {
+            return EdgeListIterator();
+        }
+        const CompactGraph<EDATA>& g = freeze();
+        std::shared_ptr<SearchPair<QUEUE> > search = acquire_search<QUEUE>();
+        return edge_list_iterator(g.shortest_path(start->get_index(), end->get_index(), weights, search->forward));
+    }
+
+    // One path per (start, end) query, each listed like shortest_path_iterator,
+    // from as few shortest-path trees as possible; threads = 0 uses every core.
+    template<class QUEUE = DaryHeap<> >
+    std::vector<EdgeListIterator> shortest_path_iterators(const std::vector<std::pair<Vertex*, Vertex*> >& queries, unsigned threads = 0) const
+    {
+        STATS_PHASE(compute_ms);
+        std::vector<std::pair<unsigned, unsigned> > indices(queries.size());
+        for (unsigned int i=0; i<queries.size(); i++)
+        {
+            indices[i] = std::make_pair(queries[i].first->get_index(), queries[i].second->get_index());
+        }
+
+        const CompactGraph<EDATA>& g = freeze();
+        const CompactGraph<EDATA>& reverse = directed ? freeze_reverse() : g;
+        auto paths = BatchPathBuilder<EDATA, QUEUE, WEIGHTS>(&g, &reverse, weights, &trees(), threads).get(indices);
+
+        std::vector<EdgeListIterator> iters;
+        iters.reserve(paths.size());
+        for (unsigned int i=0; i<paths.size(); i++)
+        {
+            iters.push_back(edge_list_iterator(paths[i]));
+        }
+        return iters;
+    }
+
+    // Number of whole shortest-path trees kept for reuse; 0 disables the cache.
+    void set_tree_cache_capacity(unsigned trees) { tree_cache.set_capacity(trees); }
+    unsigned get_tree_cache_capacity() const { return tree_cache.get_capacity(); }
+
+    template<class QUEUE = DaryHeap<> >
+    EdgeListIterator bidirectional_shortest_path_iterator(Vertex* start, Vertex* end) const
+    {
+        STATS_PHASE(compute_ms);
+        if (!components().may_reach(start->get_index(), end->get_index()))
+        {
+            return EdgeListIterator();
+        }
+        const CompactGraph<EDATA>& g = freeze();
+        const CompactGraph<EDATA>& reverse = directed ? freeze_reverse() : g;
+        std::shared_ptr<SearchPair<QUEUE> > search = acquire_search<QUEUE>();
+        return edge_list_iterator(g.bidirectional_shortest_path(start->get_index(), end->get_index(), reverse, weights, search->forward, search->backward, WholeGraph()));
+    }
+
+    // Shortest-path tree aggregates of every source, indexed like the vertices; threads = 0 uses every core.
+    template<class QUEUE = DaryHeap<> >
+    std::vector<SourceStats<EDATA> > all_sources_stats(unsigned threads = 0) const
+    {
+        STATS_PHASE(compute_ms);
+        return AllSourcesBuilder<EDATA, QUEUE, WEIGHTS>(&freeze(), weights, 0, threads).get();
+    }
+
+    // Vertex whose shortest-path tree is best by the criterion, lowest index on ties.
+    template<class QUEUE = DaryHeap<> >
+    Vertex* pivot_vertex(PivotCriterion criterion = TREE_WEIGHT, unsigned threads = 0) const
+    {
+        STATS_PHASE(compute_ms);
+        unsigned best = AllSourcesBuilder<EDATA, QUEUE, WEIGHTS>(&freeze(), weights, 0, threads).pivot(criterion);
+        return best != CompactGraph<EDATA>::NONE ? vertices[best] : nullptr;
+    }
+
+    // Dense all-pairs distances for small, well connected graphs; read them with
+    // matrix.distance(u->get_index(), v->get_index()). threads = 0 uses every core.
+    DistanceMatrix<EDATA> all_pairs_distances(unsigned threads = 0) const
+    {
+        STATS_PHASE(compute_ms);
+        return DistanceMatrix<EDATA>(freeze(), weights, threads);
+    }
+
+    // matrix must come from all_pairs_distances() on the unchanged graph
+    EdgeListIterator all_pairs_path_iterator(const DistanceMatrix<EDATA>& matrix, Vertex* start, Vertex* end) const
+    {
+        STATS_PHASE(compute_ms);
+        return edge_list_iterator(matrix.path(freeze(), start->get_index(), end->get_index()));
+    }
+
+    // Preprocessing for many point-to-point queries on a graph that no longer
+    // changes; keep it with write() and read it back with its filename constructor.
+    ContractionHierarchy<EDATA> contraction_hierarchy() const
+    {
+        STATS_PHASE(compute_ms);
+        return ContractionHierarchy<EDATA>(freeze(), weights);
+    }
+
+    // Listed like shortest_path_iterator. hierarchy must come from contraction_hierarchy()
+    // on the unchanged graph; when it does not even fit the graph the path is empty.
+    EdgeListIterator hierarchy_path_iterator(const ContractionHierarchy<EDATA>& hierarchy, Vertex* start, Vertex* end) const
+    {
+        STATS_PHASE(compute_ms);
+        const CompactGraph<EDATA>& g = freeze();
+        if (!hierarchy.fits(g) || !components().may_reach(start->get_index(), end->get_index()))
+        {
+            return EdgeListIterator();
+        }
+        return edge_list_iterator(hierarchy.shortest_path(start->get_index(), end->get_index(), weights));
+    }
+
+    // heuristic(Vertex*) must never overestimate the remaining distance to end
+    template<class HEURISTIC>
+    EdgeListIterator astar_path_iterator(Vertex* start, Vertex* end, HEURISTIC heuristic) const
+    {
+        STATS_PHASE(compute_ms);
+        if (!components().may_reach(start->get_index(), end->get_index()))
+        {
+            return EdgeListIterator();
+        }
+        VertexHeuristic<HEURISTIC> h = { this, heuristic };
+        std::shared_ptr<SearchPair<DaryHeap<> > > search = acquire_search<DaryHeap<> >();
+        return edge_list_iterator(freeze().astar_path(start->get_index(), end->get_index(), h, weights, search->forward, WholeGraph()));
     }
 
 };
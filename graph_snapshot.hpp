@@ -0,0 +1,325 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <stdint.h>
+
+#include "compact_graph.hpp"
+#include "pooled_label.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define GRAPH_SNAPSHOT_MMAP
+#endif
+
+
+template<class T>
+std::string snapshot_label(const T& value)
+{
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+inline std::string snapshot_label(const std::string& value) { return value; }
+inline std::string snapshot_label(const PooledLabel& value) { return value.str(); }
+
+
+// Versioned binary image of a CompactGraph plus a vertex name table. Every
+// section is a flat, 64-byte aligned array in native byte order, so opening a
+// snapshot maps the file read-only and points a borrowing CompactGraph at it:
+// nothing is deserialized and concurrent readers share the page cache.
+//
+//   header | offsets | targets | arc edges | arc weights | edge sources
+//          | edge destinations | edge weights | name offsets | names | name order
+template<class EDATA>
+class GraphSnapshot
+{
+
+public:
+    static const uint32_t VERSION = 1;
+
+private:
+    enum Section { OFFSETS, TARGETS, ARC_EDGES, WEIGHTS, SOURCES, DESTINATIONS, EDGE_WEIGHTS, NAME_OFFSETS, NAMES, NAME_ORDER, SECTIONS };
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t weight_size;
+        uint32_t directed;
+        uint32_t num_vertices;
+        uint32_t num_edges;
+        uint64_t size;
+        uint64_t sections[SECTIONS];
+    };
+
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    const char* data;
+    size_t size;
+    bool mapped;
+    std::vector<char> buffer;
+    CompactGraph<EDATA> graph;
+
+    const uint64_t* name_offsets;
+    const char* names;
+    const uint32_t* name_order;
+
+    GraphSnapshot(const GraphSnapshot&);
+    GraphSnapshot& operator=(const GraphSnapshot&);
+
+    static uint64_t align(uint64_t n) { return (n + 63) & ~(uint64_t) 63; }
+
+    static void write_section(std::ofstream& file, uint64_t& pos, uint64_t& section, const void* p, uint64_t bytes)
+    {
+        static const char padding[64] = { 0 };
+        section = pos;
+        if (bytes)
+        {
+            file.write((const char*) p, bytes);
+        }
+        file.write(padding, align(bytes) - bytes);
+        pos += align(bytes);
+    }
+
+    // count values of T at a 64-byte aligned section inside the file, or null
+    template<class T>
+    const T* section(const Header* h, Section s, uint64_t count)
+    {
+        if (h->sections[s] % 64 || h->sections[s] > size || count * sizeof(T) > size - h->sections[s])
+        {
+            return 0;
+        }
+        return (const T*) (data + h->sections[s]);
+    }
+
+    template<class T>
+    static bool increasing(const T* values, uint64_t count)
+    {
+        for (uint64_t i = 1; i < count; i++)
+        {
+            if (values[i] < values[i - 1])
+                return false;
+        }
+        return true;
+    }
+
+    template<class T>
+    static bool below(const T* values, uint64_t count, uint64_t limit)
+    {
+        for (uint64_t i = 0; i < count; i++)
+        {
+            if (values[i] >= limit)
+                return false;
+        }
+        return true;
+    }
+
+    // The section bounds and every index the engines follow, so that a corrupt
+    // file is refused rather than read out of bounds.
+    bool validate()
+    {
+        if (size < sizeof(Header))
+            return false;
+
+        const Header* h = (const Header*) data;
+        if (std::memcmp(h->magic, "AMPGRAPH", 8) != 0 || h->version != VERSION || h->byte_order != BYTE_ORDER_MARK
+                || h->weight_size != sizeof(EDATA) || h->size != size)
+            return false;
+
+        uint64_t nv = h->num_vertices;
+        uint64_t ne = h->num_edges;
+        const unsigned* offsets = section<unsigned>(h, OFFSETS, nv + 1);
+        name_offsets = section<uint64_t>(h, NAME_OFFSETS, nv + 1);
+        if (!offsets || !name_offsets || !increasing(offsets, nv + 1) || !increasing(name_offsets, nv + 1))
+            return false;
+
+        uint64_t na = offsets[nv];
+        const unsigned* targets = section<unsigned>(h, TARGETS, na);
+        const unsigned* arc_edges = section<unsigned>(h, ARC_EDGES, na);
+        const EDATA* weights = section<EDATA>(h, WEIGHTS, na);
+        const unsigned* sources = section<unsigned>(h, SOURCES, ne);
+        const unsigned* destinations = section<unsigned>(h, DESTINATIONS, ne);
+        const EDATA* edge_weights = section<EDATA>(h, EDGE_WEIGHTS, ne);
+        names = section<char>(h, NAMES, name_offsets[nv]);
+        name_order = section<uint32_t>(h, NAME_ORDER, nv);
+        if (!targets || !arc_edges || !weights || !sources || !destinations || !edge_weights || !names || !name_order)
+            return false;
+        if (!below(targets, na, nv) || !below(arc_edges, na, ne) || !below(sources, ne, nv) || !below(destinations, ne, nv)
+                || !below(name_order, nv, nv))
+            return false;
+
+        graph = CompactGraph<EDATA>(h->directed != 0, nv, ne, offsets, targets, arc_edges, weights, sources, destinations, edge_weights);
+        return true;
+    }
+
+    int compare_name(unsigned v, const std::string& name) const
+    {
+        size_t n = name_size(v);
+        int c = std::memcmp(name_data(v), name.data(), std::min(n, name.size()));
+        return c ? c : (n < name.size() ? -1 : (n > name.size() ? 1 : 0));
+    }
+
+public:
+    GraphSnapshot(const std::string& filename)
+    {
+        data = 0;
+        size = 0;
+        mapped = false;
+
+#ifdef GRAPH_SNAPSHOT_MMAP
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0)
+            {
+                void* p = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED)
+                {
+                    data = (const char*) p;
+                    size = st.st_size;
+                    mapped = true;
+                }
+            }
+            ::close(fd);
+        }
+#endif
+
+        if (!mapped)
+        {
+            std::ifstream file(filename.c_str(), std::ios::binary);
+            buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            data = buffer.empty() ? 0 : &buffer[0];
+            size = buffer.size();
+        }
+
+        if (!validate())
+        {
+            close();
+        }
+    }
+
+    ~GraphSnapshot()
+    {
+        close();
+    }
+
+    void close()
+    {
+#ifdef GRAPH_SNAPSHOT_MMAP
+        if (mapped)
+        {
+            munmap((void*) data, size);
+        }
+#endif
+        data = 0;
+        size = 0;
+        mapped = false;
+        buffer.clear();
+        graph = CompactGraph<EDATA>();
+    }
+
+    bool is_open() const { return data != 0; }
+
+    // Usable directly by the MST and shortest-path engines, valid while the snapshot is open.
+    const CompactGraph<EDATA>& get_graph() const { return graph; }
+
+    unsigned num_vertices() const { return graph.num_vertices(); }
+    const char* name_data(unsigned v) const { return names + name_offsets[v]; }
+    size_t name_size(unsigned v) const { return name_offsets[v + 1] - name_offsets[v]; }
+    std::string get_name(unsigned v) const { return std::string(name_data(v), name_size(v)); }
+
+    // binary search over the stored name order; NONE when absent
+    unsigned find_vertex(const std::string& name) const
+    {
+        unsigned lo = 0;
+        unsigned hi = num_vertices();
+        while (lo < hi)
+        {
+            unsigned mid = lo + (hi - lo) / 2;
+            if (compare_name(name_order[mid], name) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo < num_vertices() && compare_name(name_order[lo], name) == 0)
+            return name_order[lo];
+        return CompactGraph<EDATA>::NONE;
+    }
+
+    static bool write(const std::string& filename, const CompactGraph<EDATA>& g, const std::vector<std::string>& labels)
+    {
+        std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || labels.size() != g.num_vertices())
+        {
+            return false;
+        }
+
+        uint64_t nv = g.num_vertices();
+        uint64_t ne = g.num_edges();
+        uint64_t na = g.num_arcs();
+
+        std::vector<uint64_t> name_offsets(nv + 1, 0);
+        for (unsigned v = 0; v < nv; v++)
+        {
+            name_offsets[v + 1] = name_offsets[v] + labels[v].size();
+        }
+        std::string names;
+        names.reserve(name_offsets[nv]);
+        for (unsigned v = 0; v < nv; v++)
+        {
+            names += labels[v];
+        }
+
+        std::vector<uint32_t> order(nv);
+        for (unsigned v = 0; v < nv; v++)
+        {
+            order[v] = v;
+        }
+        std::stable_sort(order.begin(), order.end(), [&labels](uint32_t a, uint32_t b) { return labels[a] < labels[b]; });
+
+        Header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, "AMPGRAPH", 8);
+        h.version = VERSION;
+        h.byte_order = BYTE_ORDER_MARK;
+        h.weight_size = sizeof(EDATA);
+        h.directed = g.is_directed();
+        h.num_vertices = nv;
+        h.num_edges = ne;
+
+        // the header is written twice: once as a placeholder, once with the section table
+        uint64_t pos = 0;
+        uint64_t unused;
+        write_section(file, pos, unused, &h, sizeof(h));
+        write_section(file, pos, h.sections[OFFSETS], g.offset_data(), (nv + 1) * sizeof(unsigned));
+        write_section(file, pos, h.sections[TARGETS], g.target_data(), na * sizeof(unsigned));
+        write_section(file, pos, h.sections[ARC_EDGES], g.arc_edge_data(), na * sizeof(unsigned));
+        write_section(file, pos, h.sections[WEIGHTS], g.weight_data(), na * sizeof(EDATA));
+        write_section(file, pos, h.sections[SOURCES], g.source_data(), ne * sizeof(unsigned));
+        write_section(file, pos, h.sections[DESTINATIONS], g.destination_data(), ne * sizeof(unsigned));
+        write_section(file, pos, h.sections[EDGE_WEIGHTS], g.edge_weight_data(), ne * sizeof(EDATA));
+        write_section(file, pos, h.sections[NAME_OFFSETS], name_offsets.data(), (nv + 1) * sizeof(uint64_t));
+        write_section(file, pos, h.sections[NAMES], names.data(), names.size());
+        write_section(file, pos, h.sections[NAME_ORDER], order.data(), nv * sizeof(uint32_t));
+        h.size = pos;
+
+        file.seekp(0);
+        file.write((const char*) &h, sizeof(h));
+        return file.good();
+    }
+};
+
+template<class EDATA>
+const uint32_t GraphSnapshot<EDATA>::VERSION;
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <mutex>
+#include <utility>
+
+
+// Work counters and phase timings of the engines, compiled in only when
+// ALGO_STATS is defined; otherwise the STATS_ macros expand to nothing and
+// the engines are unchanged.
+//
+// Each thread accumulates into its own QueryStats, thread_query_stats():
+// clear it before a query and read it afterwards. Work done by pool workers
+// for a parallel query stays in the workers' records.
+struct QueryStats
+{
+    unsigned long queue_pushes;     // vertices inserted, decrease-keys included
+    unsigned long queue_pops;
+    unsigned long decrease_keys;    // keys lowered in place by addressable queues
+    unsigned long stale_pops;       // outdated entries popped from lazy queues (Prim)
+    unsigned long relaxations;      // arcs scanned from settled vertices
+    unsigned long settled;
+    unsigned long find_edge_scans;  // adjacency entries compared by Vertex::find_edge
+
+    double load_ms;
+    double compute_ms;
+    double path_ms;                 // turning edge indices back into edges
+    double save_ms;
+
+    QueryStats() { clear(); }
+
+    void clear()
+    {
+        queue_pushes = queue_pops = decrease_keys = stale_pops = 0;
+        relaxations = settled = find_edge_scans = 0;
+        load_ms = compute_ms = path_ms = save_ms = 0;
+    }
+
+    QueryStats& operator+=(const QueryStats& o)
+    {
+        queue_pushes += o.queue_pushes;
+        queue_pops += o.queue_pops;
+        decrease_keys += o.decrease_keys;
+        stale_pops += o.stale_pops;
+        relaxations += o.relaxations;
+        settled += o.settled;
+        find_edge_scans += o.find_edge_scans;
+        load_ms += o.load_ms;
+        compute_ms += o.compute_ms;
+        path_ms += o.path_ms;
+        save_ms += o.save_ms;
+        return *this;
+    }
+
+    std::string json() const
+    {
+        std::ostringstream out;
+        out << "{\"queue_pushes\":" << queue_pushes << ",\"queue_pops\":" << queue_pops
+            << ",\"decrease_keys\":" << decrease_keys << ",\"stale_pops\":" << stale_pops
+            << ",\"relaxations\":" << relaxations << ",\"settled\":" << settled
+            << ",\"find_edge_scans\":" << find_edge_scans << ",\"load_ms\":" << load_ms
+            << ",\"compute_ms\":" << compute_ms << ",\"path_ms\":" << path_ms
+            << ",\"save_ms\":" << save_ms << "}";
+        return out.str();
+    }
+
+    static std::string csv_header()
+    {
+        return "queue_pushes,queue_pops,decrease_keys,stale_pops,relaxations,settled,find_edge_scans,"
+               "load_ms,compute_ms,path_ms,save_ms";
+    }
+
+    std::string csv() const
+    {
+        std::ostringstream out;
+        out << queue_pushes << "," << queue_pops << "," << decrease_keys << "," << stale_pops << ","
+            << relaxations << "," << settled << "," << find_edge_scans << "," << load_ms << ","
+            << compute_ms << "," << path_ms << "," << save_ms;
+        return out.str();
+    }
+};
+
+inline QueryStats& thread_query_stats()
+{
+    static thread_local QueryStats stats;
+    return stats;
+}
+
+// Adds the lifetime of the timer to one phase of the thread's record. A
+// phase nested in another passes the outer one, which then loses that time.
+class PhaseTimer
+{
+
+private:
+    double QueryStats::* phase;
+    double QueryStats::* outer;
+    std::chrono::steady_clock::time_point begin;
+
+    PhaseTimer(const PhaseTimer&);
+    PhaseTimer& operator=(const PhaseTimer&);
+
+public:
+    PhaseTimer(double QueryStats::* phase, double QueryStats::* outer = 0) : begin(std::chrono::steady_clock::now())
+    {
+        this->phase = phase;
+        this->outer = outer;
+    }
+
+    ~PhaseTimer()
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+        thread_query_stats().*phase += elapsed.count();
+        if (outer)
+            thread_query_stats().*outer -= elapsed.count();
+    }
+};
+
+// Named query records from any number of threads, written out as a JSON
+// array or as CSV with a total line.
+class StatsLog
+{
+
+private:
+    mutable std::mutex lock;
+    std::vector<std::pair<std::string, QueryStats> > records;
+
+public:
+    void record(std::string name, const QueryStats& stats)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        records.push_back(std::make_pair(name, stats));
+    }
+
+    QueryStats total() const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        QueryStats sum;
+        for (unsigned i = 0; i < records.size(); i++)
+            sum += records[i].second;
+        return sum;
+    }
+
+    bool write_json(std::string filename) const
+    {
+        QueryStats sum = total();
+        std::lock_guard<std::mutex> guard(lock);
+        std::ofstream file(filename);
+        file << "{\"queries\":[" << std::endl;
+        for (unsigned i = 0; i < records.size(); i++)
+        {
+            file << "\t{\"name\":\"" << records[i].first << "\",\"stats\":" << records[i].second.json() << "}"
+                 << (i + 1 < records.size() ? "," : "") << std::endl;
+        }
+        file << "],\"total\":" << sum.json() << "}" << std::endl;
+        return (bool) file;
+    }
+
+    bool write_csv(std::string filename) const
+    {
+        QueryStats sum = total();
+        std::lock_guard<std::mutex> guard(lock);
+        std::ofstream file(filename);
+        file << "name," << QueryStats::csv_header() << std::endl;
+        for (unsigned i = 0; i < records.size(); i++)
+        {
+            file << records[i].first << "," << records[i].second.csv() << std::endl;
+        }
+        file << "total," << sum.csv() << std::endl;
+        return (bool) file;
+    }
+};
+
+#define STATS_CONCAT_(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_(a, b)
+
+#ifdef ALGO_STATS
+#define STATS_ADD(field, n) (thread_query_stats().field += (n))
+#define STATS_COUNT(field) STATS_ADD(field, 1)
+#define STATS_PHASE(phase) PhaseTimer STATS_CONCAT(phase_timer_, __LINE__)(&QueryStats::phase)
+#define STATS_NESTED_PHASE(phase, outer) PhaseTimer STATS_CONCAT(phase_timer_, __LINE__)(&QueryStats::phase, &QueryStats::outer)
+#else
+#define STATS_ADD(field, n) ((void) 0)
+#define STATS_COUNT(field) ((void) 0)
+#define STATS_PHASE(phase) ((void) 0)
+#define STATS_NESTED_PHASE(phase, outer) ((void) 0)
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <stdint.h>
+
+
+// Hash index from labels to the vertex indices that carry them. Only the
+// indices and a 32-bit hash are stored: the labels themselves are read back
+// through labels(i) from where they already live, rather than copied into the
+// index as a std::unordered_map key would be. Open addressing with linear
+// probing; a label inserted twice keeps its first index.
+template<class LABEL, class HASH = std::hash<LABEL> >
+class LabelIndex
+{
+
+public:
+    static const unsigned NONE = ~0u;
+
+private:
+    struct Slot
+    {
+        uint32_t hash;
+        unsigned index;     // NONE when empty
+    };
+
+    std::vector<Slot> slots;
+    unsigned count;
+    HASH hasher;
+
+    uint32_t hash(const LABEL& label) const
+    {
+        uint64_t h = hasher(label);
+        return (uint32_t) (h ^ (h >> 32));
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old;
+        old.swap(slots);
+        Slot empty = { 0, NONE };
+        slots.assign(old.empty() ? 16 : old.size() * 2, empty);
+        for (unsigned i = 0; i < old.size(); i++)
+        {
+            if (old[i].index != NONE)
+                slots[probe_empty(old[i].hash)] = old[i];
+        }
+    }
+
+    unsigned probe_empty(uint32_t h) const
+    {
+        unsigned mask = slots.size() - 1;
+        unsigned s = h & mask;
+        while (slots[s].index != NONE)
+            s = (s + 1) & mask;
+        return s;
+    }
+
+public:
+    LabelIndex() { count = 0; }
+
+    unsigned size() const { return count; }
+
+    void clear()
+    {
+        slots.clear();
+        count = 0;
+    }
+
+    void reserve(unsigned n)
+    {
+        while ((size_t) n * 2 > slots.size())
+            grow();
+    }
+
+    // index carrying label, or NONE
+    template<class LABELS>
+    unsigned find(const LABEL& label, const LABELS& labels) const
+    {
+        if (slots.empty())
+            return NONE;
+        uint32_t h = hash(label);
+        unsigned mask = slots.size() - 1;
+        for (unsigned s = h & mask; slots[s].index != NONE; s = (s + 1) & mask)
+        {
+            if (slots[s].hash == h && labels(slots[s].index) == label)
+                return slots[s].index;
+        }
+        return NONE;
+    }
+
+    // false when the label already has an index
+    template<class LABELS>
+    bool insert(unsigned index, const LABELS& labels)
+    {
+        const LABEL& label = labels(index);
+        if (find(label, labels) != NONE)
+            return false;
+        if ((size_t) (count + 1) * 2 > slots.size())
+            grow();
+        Slot slot = { hash(label), index };
+        slots[probe_empty(slot.hash)] = slot;
+        count ++;
+        return true;
+    }
+
+    size_t memory_usage() const { return slots.capacity() * sizeof(Slot); }
+};
+
+template<class LABEL, class HASH>
+const unsigned LabelIndex<LABEL, HASH>::NONE;
+
+// Bytes a label holds outside its own object, for memory reports.
+template<class T>
+size_t label_heap_bytes(const T&)
+{
+    return 0;
+}
+
+inline size_t label_heap_bytes(const std::string& s)
+{
+    const char* inline_begin = (const char*) &s;
+    bool inline_buffer = s.data() >= inline_begin && s.data() < inline_begin + sizeof(s);
+    return inline_buffer ? 0 : s.capacity() + 1;
+}
@@ -1,13 +1,24 @@
 #include <iostream>
 #include <string>
 #include <fstream>
-#include <regex>
+#include <vector>
+#include <utility>
 
 #include "graph.hpp"
+#include "parallel_loader.hpp"
 
 #define WEIGHT_MAX 10000
 
-void affiche(Graph<std::string,int>& g)
+struct Weights
+{
+    int zero() const { return 0; }
+    int infinity() const { return WEIGHT_MAX; }
+    unsigned priority(int w) const { return w; }
+};
+
+typedef Graph<PooledLabel, int, Weights> StringGraph;
+
+void affiche(StringGraph& g)
 {
     std::string lien = " -- ";
 
@@ -25,52 +36,16 @@ void affiche(Graph<std::string,int>& g)
     }
 }
 
-Graph<std::string, int> graph_from_file(std::string filename)
+StringGraph graph_from_file(std::string filename)
 {
-    std::function<int(int)> max = [](int i) { return WEIGHT_MAX; };
-    std::function<int(int)> min = [](int i) { return 0; };
-    std::function<int(int)> priority = [](int i) { return i; };
-
-    Graph<std::string, int> g(false, max, min, priority);
+    ParallelDotLoader loader(filename);
 
-    std::ifstream file;
-    std::set<std::string> set_firstnames;
+    StringGraph g(loader.is_directed());
+    g.set_vertex_index(true);
 
-
-    file.open(filename);
-    if(file.is_open())
+    if(loader.is_open())
     {
-        std::string line;
-
-        while(std::getline(file, line))
-        {
-            std::regex re("(\\w+) -- (\\w+) \\[label=(\\d+)\\]");
-            std::smatch match;
-
-            if (std::regex_search(line, match, re) && match.size() > 1)
-            {
-                std::string first_name = match.str(1);
-                Graph<std::string, int>::Vertex* vertex1 = g.get_vertex_data(first_name);
-
-                if(vertex1 == nullptr)
-                {
-                    vertex1 = g.add_vertex(first_name);
-                }
-
-                std::string second_name = match.str(2);
-                Graph<std::string, int>::Vertex* vertex2 = g.get_vertex_data(second_name);
-
-                if(vertex2 == nullptr)
-                {
-                    vertex2 = g.add_vertex(second_name);
-                }
-
-                int weight = std::stoi(match.str(3));
-                g.add_edge(weight, vertex1, vertex2);
-            }
-        }
-
-        file.close();
+        loader.build(g);
     }
     else
     {
@@ -81,84 +56,70 @@ Graph<std::string, int> graph_from_file(std::string filename)
     return g;
 }
 
-void minimum_spanning_tree(Graph<std::string, int> g)
+void minimum_spanning_tree(const StringGraph& g)
 {
-    for(auto i = g.min_spanning_tree_iterator(); i.has_next(); i.next())
-    {
-        i.current()->mark_red();
-    }
     const std::string filename = "min_spanning_tree.dot";
 
-    g.save_graph(filename);
+    g.save_graph(filename, g.min_spanning_tree_iterator().overlay());
     std::cout << "minimum spanning tree printed in " << filename << std::endl;
 }
 
-void shortest_path_from_all(Graph<std::string, int> g)
+void shortest_path_from_all(const StringGraph& g)
 {
-    Graph<std::string, int>::Vertex* end = g.vertex_iterator().current();
+    StringGraph::Vertex* end = g.vertex_iterator().current();
+    std::vector<std::pair<StringGraph::Vertex*, StringGraph::Vertex*> > queries;
 
     for(auto itVertices = g.vertex_iterator(); itVertices.has_next(); itVertices.next())
     {
-        auto start = itVertices.current();
-
-        if(start != end)
+        if(itVertices.current() != end)
         {
-            for(auto itSPI = g.shortest_path_iterator(start, end); itSPI.has_next(); itSPI.next())
-            {
-                itSPI.current()->mark_red();
-            }
+            queries.push_back(std::make_pair(itVertices.current(), end));
+        }
+    }
 
-            const std::string filename = "shortest_path_from_"+ start->get_value() +"_to_"+end->get_value()+".dot";
+    auto paths = g.shortest_path_iterators(queries);
+    std::vector<EdgeOverlay> overlays(queries.size());
+    std::vector<DotWriter::Output> outputs(queries.size());
 
-            g.save_graph(filename);
+    for(unsigned int i = 0; i < queries.size(); i++)
+    {
+        auto start = queries[i].first;
 
-            std::cout << "path from " << start->get_value() << " to " << end->get_value() << " printed in " << filename << std::endl;
+        overlays[i] = paths[i].overlay();
+        outputs[i].filename = "shortest_path_from_"+ start->get_value() +"_to_"+end->get_value()+".dot";
+        outputs[i].overlay = &overlays[i];
+    }
 
-            for(auto itEdge = g.edge_iterator(); itEdge.has_next(); itEdge.next())
-            {
-                itEdge.current()->unmark_red();
-            }
-        }
+    g.dot_writer().write_all(outputs);
 
+    for(unsigned int i = 0; i < queries.size(); i++)
+    {
+        std::cout << "path from " << queries[i].first->get_value() << " to " << end->get_value() << " printed in " << outputs[i].filename << std::endl;
     }
 }
 
-void shortest_path_pivot(Graph<std::string, int> g)
+void shortest_path_pivot(const StringGraph& g)
 {
-    int sumWeight = WEIGHT_MAX;
-    Graph<std::string, int>::Vertex* v;
-
-    for(auto itVertex = g.vertex_iterator(); itVertex.has_next(); itVertex.next())
-    {
-        int sumEdgesCurrentVertex = 0;
-
-        for(auto itSp = g.shortest_path_tree_iterator(itVertex.current()); itSp.has_next(); itSp.next())
-        {
-            sumEdgesCurrentVertex += itSp.current()->get_weight();
-        }
-
-        if(sumEdgesCurrentVertex < sumWeight)
-        {
-            v = itVertex.current();
-            sumWeight = sumEdgesCurrentVertex;
-        }
-    }
+    int sumWeight = 0;
+    StringGraph::Vertex* v = g.pivot_vertex();
+    EdgeOverlay tree;
 
     for(auto itSp = g.shortest_path_tree_iterator(v); itSp.has_next(); itSp.next())
     {
-        itSp.current()->mark_red();
+        sumWeight += itSp.current()->get_weight();
+        tree.insert(itSp.current()->get_index());
     }
 
     const std::string filename = "pivot.dot";
 
-    g.save_graph(filename, "\tlabelloc=\"t\";labeljust=\"l\";label=\"totalweight="+std::to_string(sumWeight)+"\"");
+    g.save_graph(filename, tree, "\tlabelloc=\"t\";labeljust=\"l\";label=\"totalweight="+std::to_string(sumWeight)+"\"");
 
     std::cout << "pivot printed in " << filename << std::endl;
 }
 
 int main()
 {
-    Graph<std::string, int> g3 = graph_from_file("test.dot");
+    StringGraph g3 = graph_from_file("test.dot");
 
     std::cout << std::endl << "---------------------- minimum spanning tree -----------------" << std::endl;
 
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+
+// Set of edges singled out by a query result (a path, a tree, an edge set),
+// held apart from the graph so that any number of results can be kept and
+// rendered without marking the shared edges. Membership is a bitmap over
+// edge indices, next to the list of members in insertion order. Graph::
+// remove_edge moves the last edge into the removed index, so an overlay kept
+// across it names other edges unless a Listener follows edge_reindexed.
+class EdgeOverlay
+{
+
+private:
+    enum { NONE = ~0u };
+
+    std::vector<uint64_t> bits;
+    std::vector<unsigned> members;
+
+public:
+    EdgeOverlay() { }
+
+    // edge indices, such as a path or a parent array; NONE entries are skipped
+    EdgeOverlay(const std::vector<unsigned>& edges)
+    {
+        for (unsigned i = 0; i < edges.size(); i++)
+        {
+            insert(edges[i]);
+        }
+    }
+
+    // false when the edge was already there
+    bool insert(unsigned edge)
+    {
+        if (edge == (unsigned) NONE)
+            return false;
+        if (edge / 64 >= bits.size())
+            bits.resize(edge / 64 + 1, 0);
+
+        uint64_t bit = (uint64_t) 1 << (edge % 64);
+        if (bits[edge / 64] & bit)
+            return false;
+        bits[edge / 64] |= bit;
+        members.push_back(edge);
+        return true;
+    }
+
+    bool contains(unsigned edge) const
+    {
+        return edge / 64 < bits.size() && (bits[edge / 64] >> (edge % 64)) & 1;
+    }
+
+    unsigned size() const { return members.size(); }
+    bool empty() const { return members.empty(); }
+    const std::vector<unsigned>& edges() const { return members; }
+
+    // in time proportional to the members, not the graph
+    void clear()
+    {
+        for (unsigned i = 0; i < members.size(); i++)
+        {
+            bits[members[i] / 64] = 0;
+        }
+        members.clear();
+    }
+};
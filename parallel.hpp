@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+
+inline unsigned default_threads()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+// Splits [begin, end) into one contiguous chunk per thread and runs
+// fn(chunk_begin, chunk_end, thread) on each; the caller works on chunk 0.
+template<class FN>
+void parallel_for(unsigned begin, unsigned end, unsigned threads, FN fn)
+{
+    if (threads == 0)
+        threads = default_threads();
+    unsigned n = end > begin ? end - begin : 0;
+    if (threads > n)
+        threads = n ? n : 1;
+
+    std::vector<std::thread> workers;
+    unsigned chunk = n / threads;
+    unsigned extra = n % threads;
+    unsigned first = begin;
+    unsigned first_end = first + chunk + (extra > 0);
+
+    for (unsigned t = 1, lo = first_end; t < threads; t++)
+    {
+        unsigned hi = lo + chunk + (t < extra);
+        workers.push_back(std::thread(fn, lo, hi, t));
+        lo = hi;
+    }
+    fn(first, first_end, 0);
+
+    for (unsigned t = 0; t < workers.size(); t++)
+    {
+        workers[t].join();
+    }
+}
+
+// Sorts chunks in parallel, then merges neighbouring runs pairwise.
+template<class T, class LESS>
+void parallel_sort(std::vector<T>& data, LESS less, unsigned threads = 0)
+{
+    if (threads == 0)
+        threads = default_threads();
+    if (threads < 2 || data.size() < 1u << 16)
+    {
+        std::sort(data.begin(), data.end(), less);
+        return;
+    }
+
+    unsigned n = data.size();
+    std::vector<unsigned> bounds;
+    for (unsigned t = 0; t <= threads; t++)
+    {
+        bounds.push_back((unsigned long long) n * t / threads);
+    }
+
+    parallel_for(0, threads, threads, [&](unsigned lo, unsigned hi, unsigned) {
+        for (unsigned t = lo; t < hi; t++)
+            std::sort(data.begin() + bounds[t], data.begin() + bounds[t + 1], less);
+    });
+
+    std::vector<T> buffer(n);
+    std::vector<T>* from = &data;
+    std::vector<T>* to = &buffer;
+    while (bounds.size() > 2)
+    {
+        unsigned runs = bounds.size() - 1;
+        std::vector<unsigned> merged;
+        for (unsigned r = 0; r < runs; r += 2)
+        {
+            merged.push_back(bounds[r]);
+        }
+        merged.push_back(n);
+
+        parallel_for(0, (runs + 1) / 2, threads, [&](unsigned lo, unsigned hi, unsigned) {
+            for (unsigned p = lo; p < hi; p++)
+            {
+                unsigned a = bounds[2 * p];
+                unsigned b = bounds[std::min(2 * p + 1, runs)];
+                unsigned c = bounds[std::min(2 * p + 2, runs)];
+                std::merge(from->begin() + a, from->begin() + b, from->begin() + b, from->begin() + c, to->begin() + a, less);
+            }
+        });
+
+        std::swap(from, to);
+        bounds.swap(merged);
+    }
+
+    if (from != &data)
+    {
+        data.swap(buffer);
+    }
+}
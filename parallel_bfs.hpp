@@ -0,0 +1,233 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <stdint.h>
+
+#include "compact_graph.hpp"
+#include "thread_pool.hpp"
+
+
+// Bitmap over vertex indices whose bits can be set from several threads.
+class AtomicBitmap
+{
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+    unsigned nwords;
+
+public:
+    AtomicBitmap() { nwords = 0; }
+
+    void reset(unsigned n)
+    {
+        unsigned w = (n + 63) / 64;
+        if (w != nwords)
+        {
+            words.reset(new std::atomic<uint64_t>[w]);
+            nwords = w;
+        }
+        for (unsigned i = 0; i < nwords; i++)
+            words[i].store(0, std::memory_order_relaxed);
+    }
+
+    bool test(unsigned v) const { return (words[v / 64].load(std::memory_order_relaxed) >> (v % 64)) & 1; }
+
+    // true when this call set the bit
+    bool set(unsigned v)
+    {
+        uint64_t bit = (uint64_t) 1 << (v % 64);
+        if (words[v / 64].load(std::memory_order_relaxed) & bit)
+            return false;
+        return !(words[v / 64].fetch_or(bit, std::memory_order_relaxed) & bit);
+    }
+
+    void swap(AtomicBitmap& o)
+    {
+        words.swap(o.words);
+        std::swap(nwords, o.nwords);
+    }
+};
+
+
+struct BreadthFirstTree
+{
+    std::vector<unsigned> depth;    // NONE for unreached vertices
+    std::vector<unsigned> parent;   // edge from the previous level, NONE for the start and unreached vertices
+
+    // reached vertices level by level, by index within a level
+    std::vector<unsigned> order() const
+    {
+        const unsigned NONE = ~0u;
+        std::vector<unsigned> count;
+        for (unsigned v = 0; v < depth.size(); v++)
+        {
+            if (depth[v] == NONE)
+                continue;
+            if (depth[v] + 1 >= count.size())
+                count.resize(depth[v] + 2, 0);
+            count[depth[v] + 1] ++;
+        }
+        for (unsigned d = 1; d < count.size(); d++)
+            count[d] += count[d - 1];
+
+        std::vector<unsigned> vertices(count.empty() ? 0 : count.back());
+        for (unsigned v = 0; v < depth.size(); v++)
+        {
+            if (depth[v] != NONE)
+                vertices[count[depth[v]] ++] = v;
+        }
+        return vertices;
+    }
+};
+
+
+// Level-synchronous BFS switching between top-down and bottom-up steps
+// (Beamer et al.). Top-down steps expand the frontier list and claim targets
+// with an atomic bit; once the frontier's arcs outweigh a fraction of the
+// unexplored ones, bottom-up steps let every unvisited vertex look for a
+// parent in the frontier bitmap instead, until the frontier shrinks again.
+// Depths are exact; among parents of equal depth the one found first wins.
+template<class EDATA>
+class ParallelBfsBuilder
+{
+
+private:
+    enum { ALPHA = 14, BETA = 24, CHUNK = 1024 };
+
+    const CompactGraph<EDATA>* graph;
+    const CompactGraph<EDATA>* reverse;
+    unsigned threads;
+
+    unsigned chunks(unsigned n) const { return (n + CHUNK - 1) / CHUNK; }
+
+public:
+    // reverse is the reversed graph when g is directed and g itself otherwise
+    ParallelBfsBuilder(const CompactGraph<EDATA>* g, const CompactGraph<EDATA>* reverse, unsigned threads = 0)
+    {
+        this->graph = g;
+        this->reverse = reverse;
+        this->threads = threads;
+    }
+
+    BreadthFirstTree run(unsigned source)
+    {
+        const unsigned NONE = CompactGraph<EDATA>::NONE;
+        unsigned n = graph->num_vertices();
+        BreadthFirstTree tree;
+        tree.depth.assign(n, NONE);
+        tree.parent.assign(n, NONE);
+        if (source >= n)
+            return tree;
+
+        ThreadPool pool(threads);
+        AtomicBitmap visited, front, next;
+        visited.reset(n);
+        std::vector<unsigned> frontier(1, source);
+        std::vector<std::vector<unsigned> > found;
+        tree.depth[source] = 0;
+        visited.set(source);
+
+        unsigned long unexplored = graph->num_arcs();
+        unsigned frontier_size = 1;
+        bool bottom_up = false;
+
+        for (unsigned level = 0; frontier_size > 0; level++)
+        {
+            unsigned long frontier_arcs = 0;
+            if (!bottom_up)
+            {
+                for (unsigned i = 0; i < frontier.size(); i++)
+                    frontier_arcs += graph->get_degree(frontier[i]);
+                if (frontier_arcs > unexplored / ALPHA)
+                {
+                    bottom_up = true;
+                    front.reset(n);
+                    for (unsigned i = 0; i < frontier.size(); i++)
+                        front.set(frontier[i]);
+                }
+            }
+            unexplored -= frontier_arcs < unexplored ? frontier_arcs : unexplored;
+
+            if (bottom_up)
+            {
+                next.reset(n);
+                std::vector<unsigned> counts(chunks(n), 0);
+                pool.for_each(0, chunks(n), [&](unsigned c, unsigned) {
+                    unsigned hi = (c + 1) * CHUNK < n ? (c + 1) * CHUNK : n;
+                    for (unsigned v = c * CHUNK; v < hi; v++)
+                    {
+                        if (visited.test(v))
+                            continue;
+                        for (unsigned a = reverse->begin(v); a < reverse->end(v); a++)
+                        {
+                            if (front.test(reverse->target(a)))
+                            {
+                                tree.depth[v] = level + 1;
+                                tree.parent[v] = reverse->edge(a);
+                                next.set(v);
+                                visited.set(v);
+                                counts[c] ++;
+                                break;
+                            }
+                        }
+                    }
+                });
+                unsigned previous = frontier_size;
+                frontier_size = 0;
+                for (unsigned c = 0; c < counts.size(); c++)
+                    frontier_size += counts[c];
+                front.swap(next);
+
+                if (frontier_size < n / BETA && frontier_size < previous)
+                {
+                    bottom_up = false;
+                    found.resize(chunks(n));
+                    pool.for_each(0, chunks(n), [&](unsigned c, unsigned) {
+                        unsigned hi = (c + 1) * CHUNK < n ? (c + 1) * CHUNK : n;
+                        found[c].clear();
+                        for (unsigned v = c * CHUNK; v < hi; v++)
+                        {
+                            if (front.test(v))
+                                found[c].push_back(v);
+                        }
+                    });
+                    frontier.clear();
+                    for (unsigned c = 0; c < chunks(n); c++)
+                        frontier.insert(frontier.end(), found[c].begin(), found[c].end());
+                }
+            }
+            else
+            {
+                found.resize(chunks(frontier.size()));
+                pool.for_each(0, chunks(frontier.size()), [&](unsigned c, unsigned) {
+                    unsigned hi = (c + 1) * CHUNK < frontier.size() ? (c + 1) * CHUNK : frontier.size();
+                    found[c].clear();
+                    for (unsigned i = c * CHUNK; i < hi; i++)
+                    {
+                        unsigned u = frontier[i];
+                        for (unsigned a = graph->begin(u); a < graph->end(u); a++)
+                        {
+                            unsigned t = graph->target(a);
+                            if (visited.set(t))
+                            {
+                                tree.depth[t] = level + 1;
+                                tree.parent[t] = graph->edge(a);
+                                found[c].push_back(t);
+                            }
+                        }
+                    }
+                });
+
+                unsigned count = chunks(frontier.size());
+                frontier.clear();
+                for (unsigned c = 0; c < count; c++)
+                    frontier.insert(frontier.end(), found[c].begin(), found[c].end());
+                frontier_size = frontier.size();
+            }
+        }
+        return tree;
+    }
+};
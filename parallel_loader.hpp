@@ -0,0 +1,326 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+#include "dot_reader.hpp"
+#include "string_pool.hpp"
+#include "pooled_label.hpp"
+#include "thread_pool.hpp"
+#include "instrumentation.hpp"
+
+
+// Vertex names interned concurrently: 256 shards, each an open-addressed
+// table under its own lock, picked by the low byte of the name's hash. Names
+// stay (pointer, length) pairs into the parsed buffer. An id is
+// (index within the shard << 8) | shard.
+//
+// Every name keeps the first position it was seen at, so that numbering the
+// names by that position afterwards gives the order of a sequential load,
+// however the threads interleaved.
+class NameTable
+{
+
+public:
+    struct Entry
+    {
+        const char* data;
+        size_t size;
+        uint64_t first;         // (chunk << 40) | position within the chunk
+        unsigned number;        // final vertex index, once numbered
+    };
+
+private:
+    static const unsigned SHARDS = 256;
+
+    struct Shard
+    {
+        std::mutex lock;
+        std::vector<Entry> entries;
+        std::vector<uint64_t> hashes;
+        std::vector<unsigned> slots;    // entry index + 1, 0 for empty
+
+        void grow()
+        {
+            std::vector<unsigned> bigger(std::max<size_t>(slots.size() * 2, 64), 0);
+            size_t mask = bigger.size() - 1;
+            for (unsigned i = 0; i < entries.size(); i++)
+            {
+                size_t s = (hashes[i] >> 8) & mask;
+                while (bigger[s])
+                    s = (s + 1) & mask;
+                bigger[s] = i + 1;
+            }
+            slots.swap(bigger);
+        }
+    };
+
+    std::unique_ptr<Shard[]> shards;
+
+    NameTable(const NameTable&);
+    NameTable& operator=(const NameTable&);
+
+public:
+    static uint64_t hash(const char* data, size_t size)
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; i++)
+        {
+            h ^= (unsigned char) data[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    NameTable() : shards(new Shard[SHARDS]) { }
+
+    // id of the name, added when new; position is where it was seen
+    unsigned intern(const char* data, size_t size, uint64_t position)
+    {
+        uint64_t h = hash(data, size);
+        unsigned shard_index = h & (SHARDS - 1);
+        Shard& shard = shards[shard_index];
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        if ((shard.entries.size() + 1) * 2 > shard.slots.size())
+            shard.grow();
+
+        size_t mask = shard.slots.size() - 1;
+        size_t s = (h >> 8) & mask;
+        while (shard.slots[s])
+        {
+            unsigned i = shard.slots[s] - 1;
+            Entry& e = shard.entries[i];
+            if (shard.hashes[i] == h && e.size == size && std::memcmp(e.data, data, size) == 0)
+            {
+                e.first = std::min(e.first, position);
+                return (i << 8) | shard_index;
+            }
+            s = (s + 1) & mask;
+        }
+
+        Entry e;
+        e.data = data;
+        e.size = size;
+        e.first = position;
+        e.number = 0;
+        shard.slots[s] = shard.entries.size() + 1;
+        shard.entries.push_back(e);
+        shard.hashes.push_back(h);
+        return ((shard.entries.size() - 1) << 8) | shard_index;
+    }
+
+    // not locked: for use once interning is over
+    Entry& entry(unsigned id) { return shards[id & (SHARDS - 1)].entries[id >> 8]; }
+
+    unsigned size() const
+    {
+        unsigned n = 0;
+        for (unsigned i = 0; i < SHARDS; i++)
+            n += shards[i].entries.size();
+        return n;
+    }
+};
+
+// Bulk loader for large edge lists in the DotReader format. The input is
+// split at line boundaries into chunks parsed on all cores, names are
+// interned through a NameTable and the edges gathered into flat arrays for
+// Graph::add_edges. Vertices are numbered in order of first appearance in
+// the file, exactly as a sequential load through add_vertex/add_edge does.
+//
+// A statement must not span lines (see DotReader::read_parallel).
+class ParallelDotLoader
+{
+
+private:
+    static const uint64_t CHUNK_SHIFT = 40;
+
+    // handler of one chunk: every name seen, and edges by name id
+    struct Chunk
+    {
+        NameTable* table;
+        uint64_t base;
+        std::vector<unsigned> names;    // ids, one per name token
+        std::vector<unsigned> sources;
+        std::vector<unsigned> destinations;
+        std::vector<double> weights;
+
+        const char* last_data;
+        size_t last_size;
+        unsigned last_id;
+
+        Chunk() { table = 0; base = 0; last_data = 0; last_size = 0; last_id = 0; }
+
+        unsigned name(const char* data, size_t size)
+        {
+            // edge lists repeat a source over consecutive lines
+            if (!(last_data && last_size == size && std::memcmp(last_data, data, size) == 0))
+            {
+                last_id = table->intern(data, size, base | names.size());
+                last_data = data;
+                last_size = size;
+            }
+            names.push_back(last_id);
+            return last_id;
+        }
+
+        void vertex(const char* data, size_t size)
+        {
+            name(data, size);
+        }
+
+        void edge(const char* src, size_t srclen, const char* dst, size_t dstlen, double weight)
+        {
+            sources.push_back(name(src, srclen));
+            destinations.push_back(name(dst, dstlen));
+            weights.push_back(weight);
+        }
+    };
+
+    bool open;
+    bool directed;
+    unsigned threads;
+    std::vector<std::pair<std::string, std::string> > attributes;
+    StringPool names;
+    std::vector<unsigned> sources;
+    std::vector<unsigned> destinations;
+    std::vector<double> weights;
+
+    ParallelDotLoader(const ParallelDotLoader&);
+    ParallelDotLoader& operator=(const ParallelDotLoader&);
+
+public:
+    // threads = 0 uses every core
+    ParallelDotLoader(const std::string& filename, unsigned threads = 0)
+    {
+        if (!threads)
+            threads = default_threads();
+        this->threads = threads;
+
+        DotReader reader(filename);
+        open = reader.is_open();
+        directed = reader.is_directed();
+        if (!open)
+            return;
+
+        // a few chunks per thread, so that stealing evens out dense regions
+        NameTable table;
+        std::vector<Chunk> chunks(threads * 4);
+        for (unsigned i = 0; i < chunks.size(); i++)
+        {
+            chunks[i].table = &table;
+            chunks[i].base = (uint64_t) i << CHUNK_SHIFT;
+        }
+        reader.read_parallel(chunks, threads);
+        directed = reader.is_directed();
+        attributes = reader.get_attributes();
+
+        STATS_PHASE(load_ms);
+        unsigned n = chunks.size();
+        ThreadPool pool(threads);
+
+        // a token numbers its name when it is the name's first appearance
+        std::vector<unsigned> firsts(n + 1, 0);
+        std::vector<size_t> name_bytes(n + 1, 0);
+        std::vector<unsigned> edge_offsets(n + 1, 0);
+        pool.for_each(0, n, [&](unsigned c, unsigned) {
+            const Chunk& chunk = chunks[c];
+            for (unsigned i = 0; i < chunk.names.size(); i++)
+            {
+                const NameTable::Entry& e = table.entry(chunk.names[i]);
+                if (e.first == (chunk.base | i))
+                {
+                    firsts[c + 1] ++;
+                    name_bytes[c + 1] += e.size;
+                }
+            }
+            edge_offsets[c + 1] = chunk.sources.size();
+        });
+        for (unsigned c = 0; c < n; c++)
+        {
+            firsts[c + 1] += firsts[c];
+            name_bytes[c + 1] += name_bytes[c];
+            edge_offsets[c + 1] += edge_offsets[c];
+        }
+
+        names.resize(firsts[n], name_bytes[n]);
+        pool.for_each(0, n, [&](unsigned c, unsigned) {
+            const Chunk& chunk = chunks[c];
+            unsigned next = firsts[c];
+            size_t offset = name_bytes[c];
+            for (unsigned i = 0; i < chunk.names.size(); i++)
+            {
+                NameTable::Entry& e = table.entry(chunk.names[i]);
+                if (e.first == (chunk.base | i))
+                {
+                    e.number = next;
+                    names.place(next ++, offset, e.data, e.size);
+                    offset += e.size;
+                }
+            }
+        });
+
+        sources.resize(edge_offsets[n]);
+        destinations.resize(edge_offsets[n]);
+        weights.resize(edge_offsets[n]);
+        pool.for_each(0, n, [&](unsigned c, unsigned) {
+            const Chunk& chunk = chunks[c];
+            unsigned out = edge_offsets[c];
+            for (unsigned i = 0; i < chunk.sources.size(); i++, out++)
+            {
+                sources[out] = table.entry(chunk.sources[i]).number;
+                destinations[out] = table.entry(chunk.destinations[i]).number;
+                weights[out] = chunk.weights[i];
+            }
+        });
+    }
+
+    bool is_open() const { return open; }
+    bool is_directed() const { return directed; }
+    const std::vector<std::pair<std::string, std::string> >& get_attributes() const { return attributes; }
+
+    // vertex names by index, and edges as indices into them, in file order
+    const StringPool& get_names() const { return names; }
+    const std::vector<unsigned>& get_sources() const { return sources; }
+    const std::vector<unsigned>& get_destinations() const { return destinations; }
+    const std::vector<double>& get_weights() const { return weights; }
+
+    // Appends the vertices and edges to g, whose VDATA must be constructible
+    // from a std::string, or be a PooledLabel; the names go through
+    // Graph::intern_label on all the loader's threads. Weights are cast to
+    // g's EDATA.
+    template<class GRAPH>
+    void build(GRAPH& g) const
+    {
+        typedef typename GRAPH::VertexData VDATA;
+        typedef typename GRAPH::EdgeData EDATA;
+
+        std::vector<VDATA> labels(names.size());
+        ThreadPool pool(std::min(threads, std::max(names.size() / 4096, 1u)));
+        pool.for_each(0, names.size(), [&](unsigned i, unsigned) {
+            labels[i] = g.intern_label(names.data(i), names.length(i));
+        });
+
+        unsigned offset = g.num_vertices();
+        g.reserve(names.size(), sources.size());
+        for (unsigned i = 0; i < names.size(); i++)
+        {
+            g.add_vertex(labels[i]);
+        }
+
+        std::vector<unsigned> src(sources.size()), dst(destinations.size());
+        std::vector<EDATA> w(weights.size());
+        for (unsigned i = 0; i < sources.size(); i++)
+        {
+            src[i] = sources[i] + offset;
+            dst[i] = destinations[i] + offset;
+            w[i] = (EDATA) weights[i];
+        }
+        g.add_edges(src, dst, w);
+    }
+};
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <functional>
+#include <stdint.h>
+
+
+// Vertex label for a Graph whose labels are strings: a single pointer to the
+// characters, interned in the graph's LabelPool, so Graph<PooledLabel, int>
+// keeps 8 bytes per vertex for its label where a std::string takes 32. Labels
+// of one pool are equal exactly when their pointers are, and the hash is
+// stored with the characters, so hashing, comparing and copying a label
+// never lock anything nor, within a pool, read the characters. Labels from
+// different pools still compare by their characters.
+//
+// Labels come from Graph::intern_label, and stay valid as long as a graph
+// sharing their pool does; a default label is the empty string.
+class PooledLabel
+{
+    friend class LabelPool;
+
+public:
+    // header of an interned label; the characters and a null follow it
+    struct Entry
+    {
+        uint32_t hash;
+        uint32_t size;
+
+        const char* data() const { return (const char*) (this + 1); }
+    };
+
+    static uint32_t hash(const char* data, size_t size)
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; i++)
+        {
+            h ^= (unsigned char) data[i];
+            h *= 1099511628211ULL;
+        }
+        return (uint32_t) (h ^ (h >> 32));
+    }
+
+private:
+    const Entry* entry;
+
+    explicit PooledLabel(const Entry* e) { entry = e; }
+
+    static const Entry* empty()
+    {
+        struct Empty { Entry entry; char null; };
+        static const Empty e = { { hash("", 0), 0 }, 0 };
+        return &e.entry;
+    }
+
+public:
+    PooledLabel() { entry = empty(); }
+
+    const char* c_str() const { return entry->data(); }
+    size_t size() const { return entry->size; }
+    std::string str() const { return std::string(entry->data(), entry->size); }
+    uint32_t get_hash() const { return entry->hash; }
+
+    bool operator==(const PooledLabel& o) const
+    {
+        return entry == o.entry || (entry->hash == o.entry->hash && entry->size == o.entry->size
+                                    && std::memcmp(entry->data(), o.entry->data(), entry->size) == 0);
+    }
+    bool operator!=(const PooledLabel& o) const { return !(*this == o); }
+
+    // by the characters, as std::string orders
+    bool operator<(const PooledLabel& o) const
+    {
+        if (entry == o.entry)
+            return false;
+        int c = std::memcmp(entry->data(), o.entry->data(), std::min(entry->size, o.entry->size));
+        return c < 0 || (c == 0 && entry->size < o.entry->size);
+    }
+};
+
+// Every distinct label once, for the graphs that share the pool: a graph,
+// its clones and its subgraphs. Labels are never released before the pool.
+//
+// The labels live in append-only blocks and never move. Interning goes
+// through one of SHARDS open-addressed tables of 32-bit handles, picked by
+// the label's hash, under that shard's lock, so any number of threads may
+// intern at once; reading a label takes no lock at all.
+class LabelPool
+{
+
+private:
+    enum { SHARDS = 16, BLOCK_SIZE = 64 * 1024 };
+
+    typedef PooledLabel::Entry Entry;
+
+    // an entry is found by its block and its offset there in units of
+    // alignof(Entry), which 64 KB blocks keep to OFFSET_BITS
+    enum { OFFSET_BITS = 14 };
+
+    struct Shard
+    {
+        mutable std::mutex lock;
+        std::vector<std::unique_ptr<char[]> > blocks;
+        size_t used;                        // bytes taken in the last block
+        size_t bytes;                       // bytes of every block
+        std::vector<uint32_t> slots;        // handle + 1 of an entry, 0 when empty
+        unsigned count;
+
+        Shard() { used = BLOCK_SIZE; bytes = 0; count = 0; }
+
+        const Entry* entry(uint32_t slot) const
+        {
+            uint32_t handle = slot - 1;
+            return (const Entry*) (blocks[handle >> OFFSET_BITS].get() + (handle & ((1u << OFFSET_BITS) - 1)) * alignof(Entry));
+        }
+
+        // the slot of a new entry
+        uint32_t store(const char* data, size_t size, uint32_t h)
+        {
+            size_t need = (sizeof(Entry) + size + 1 + alignof(Entry) - 1) / alignof(Entry) * alignof(Entry);
+            if (used + need > BLOCK_SIZE)
+            {
+                // a label longer than a block gets one of its own, and the
+                // next label a new block
+                size_t block = std::max<size_t>(need, BLOCK_SIZE);
+                blocks.push_back(std::unique_ptr<char[]>(new char[block]));
+                bytes += block;
+                used = 0;
+            }
+            char* at = blocks.back().get() + used;
+            Entry* e = (Entry*) at;
+            e->hash = h;
+            e->size = (uint32_t) size;
+            std::memcpy(at + sizeof(Entry), data, size);
+            at[sizeof(Entry) + size] = 0;
+
+            uint32_t handle = (uint32_t) ((blocks.size() - 1) << OFFSET_BITS | used / alignof(Entry));
+            used = std::min<size_t>(used + need, BLOCK_SIZE);
+            return handle + 1;
+        }
+
+        void grow()
+        {
+            std::vector<uint32_t> bigger(std::max<size_t>(slots.size() * 2, 64), 0);
+            size_t mask = bigger.size() - 1;
+            for (size_t i = 0; i < slots.size(); i++)
+            {
+                if (!slots[i])
+                    continue;
+                size_t s = (entry(slots[i])->hash / SHARDS) & mask;
+                while (bigger[s])
+                    s = (s + 1) & mask;
+                bigger[s] = slots[i];
+            }
+            slots.swap(bigger);
+        }
+    };
+
+    Shard shards[SHARDS];
+
+    LabelPool(const LabelPool&);
+    LabelPool& operator=(const LabelPool&);
+
+public:
+    LabelPool() { }
+
+    PooledLabel intern(const char* data, size_t size)
+    {
+        if (size == 0)
+            return PooledLabel();
+
+        uint32_t h = PooledLabel::hash(data, size);
+        Shard& shard = shards[h % SHARDS];
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        if ((shard.count + 1) * 4 > shard.slots.size() * 3)
+            shard.grow();
+        size_t mask = shard.slots.size() - 1;
+        size_t s = (h / SHARDS) & mask;
+        while (shard.slots[s])
+        {
+            const Entry* e = shard.entry(shard.slots[s]);
+            if (e->hash == h && e->size == size && std::memcmp(e->data(), data, size) == 0)
+                return PooledLabel(e);
+            s = (s + 1) & mask;
+        }
+        shard.slots[s] = shard.store(data, size, h);
+        shard.count ++;
+        return PooledLabel(shard.entry(shard.slots[s]));
+    }
+
+    PooledLabel intern(const std::string& s) { return intern(s.data(), s.size()); }
+
+    // distinct labels, the empty one aside
+    unsigned size() const
+    {
+        unsigned n = 0;
+        for (unsigned i = 0; i < SHARDS; i++)
+        {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            n += shards[i].count;
+        }
+        return n;
+    }
+
+    size_t memory_usage() const
+    {
+        size_t bytes = sizeof(*this);
+        for (unsigned i = 0; i < SHARDS; i++)
+        {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            bytes += shards[i].bytes + shards[i].slots.capacity() * sizeof(uint32_t);
+        }
+        return bytes;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const PooledLabel& label)
+{
+    return out.write(label.c_str(), label.size());
+}
+
+inline std::string operator+(const std::string& s, const PooledLabel& label) { return s + label.str(); }
+inline std::string operator+(const PooledLabel& label, const std::string& s) { return label.str() + s; }
+inline std::string operator+(const char* s, const PooledLabel& label) { return s + label.str(); }
+inline std::string operator+(const PooledLabel& label, const char* s) { return label.str() + s; }
+
+namespace std
+{
+    template<>
+    struct hash<PooledLabel>
+    {
+        size_t operator()(const PooledLabel& label) const { return label.get_hash(); }
+    };
+}
+
+// The pool a new graph with LABEL values starts with: none, unless they are
+// pooled labels.
+template<class LABEL>
+std::shared_ptr<LabelPool> make_label_pool()
+{
+    return std::shared_ptr<LabelPool>();
+}
+
+template<>
+inline std::shared_ptr<LabelPool> make_label_pool<PooledLabel>()
+{
+    return std::make_shared<LabelPool>();
+}
+
+// A label of characters that need not end in a null, interned in pool when
+// LABEL is pooled.
+template<class LABEL>
+LABEL make_label(LabelPool*, const char* data, size_t size)
+{
+    return LABEL(std::string(data, size));
+}
+
+template<>
+inline PooledLabel make_label<PooledLabel>(LabelPool* pool, const char* data, size_t size)
+{
+    return pool->intern(data, size);
+}
@@ -0,0 +1,336 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+
+// Addressable min-queues over vertex indices, used as the QUEUE policy of the
+// shortest-path engines. Every policy offers
+//     reset(n)          empty the queue for vertices [0, n)
+//     empty()
+//     push(v, key)      insert v, or lower the 64-bit key of a queued v
+//     pop()             remove and return a vertex of minimal key
+// BucketQueue and RadixHeap additionally need the monotone keys Dijkstra produces.
+
+
+// Indexed d-ary heap with decrease-key.
+template<unsigned D = 4>
+class DaryHeap
+{
+
+private:
+    enum { ABSENT = ~0u };
+
+    std::vector<unsigned> heap;
+    std::vector<uint64_t> keys;
+    std::vector<unsigned> position;
+
+    void place(unsigned i, unsigned v)
+    {
+        heap[i] = v;
+        position[v] = i;
+    }
+
+    void sift_up(unsigned i)
+    {
+        unsigned v = heap[i];
+        while (i > 0)
+        {
+            unsigned parent = (i - 1) / D;
+            if (keys[heap[parent]] <= keys[v])
+                break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, v);
+    }
+
+    void sift_down(unsigned i)
+    {
+        unsigned v = heap[i];
+        unsigned n = heap.size();
+        for (;;)
+        {
+            unsigned first = i * D + 1;
+            if (first >= n)
+                break;
+
+            unsigned best = first;
+            unsigned last = first + D < n ? first + D : n;
+            for (unsigned c = first + 1; c < last; c++)
+            {
+                if (keys[heap[c]] < keys[heap[best]])
+                    best = c;
+            }
+            if (keys[heap[best]] >= keys[v])
+                break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, v);
+    }
+
+public:
+    void reset(unsigned n)
+    {
+        heap.clear();
+        keys.resize(n);
+        position.assign(n, ABSENT);
+    }
+
+    bool empty() const { return heap.empty(); }
+
+    void push(unsigned v, uint64_t key)
+    {
+        if (position[v] == ABSENT)
+        {
+            keys[v] = key;
+            heap.push_back(v);
+            sift_up(heap.size() - 1);
+        }
+        else if (key < keys[v])
+        {
+            keys[v] = key;
+            sift_up(position[v]);
+        }
+    }
+
+    unsigned pop()
+    {
+        unsigned top = heap[0];
+        position[top] = ABSENT;
+        unsigned last = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            heap[0] = last;
+            sift_down(0);
+        }
+        return top;
+    }
+};
+
+
+// Dial's bucket queue: one doubly linked list per key, scanned in key order.
+// The circular bucket array doubles whenever a key lands beyond its span, so
+// it adapts to the largest edge weight without being told about it. Meant
+// for small integer weights: the keys of floating-point distances spread far
+// too wide for it.
+class BucketQueue
+{
+
+private:
+    enum { ABSENT = ~0u };
+
+    std::vector<unsigned> heads;
+    std::vector<unsigned> next;
+    std::vector<unsigned> prev;
+    std::vector<uint64_t> keys;
+    std::vector<bool> queued;
+    uint64_t cursor;
+    unsigned count;
+
+    unsigned slot(uint64_t key) const { return key & (heads.size() - 1); }
+
+    void link(unsigned v)
+    {
+        unsigned b = slot(keys[v]);
+        prev[v] = ABSENT;
+        next[v] = heads[b];
+        if (heads[b] != ABSENT)
+            prev[heads[b]] = v;
+        heads[b] = v;
+    }
+
+    void unlink(unsigned v)
+    {
+        if (prev[v] != ABSENT)
+            next[prev[v]] = next[v];
+        else
+            heads[slot(keys[v])] = next[v];
+        if (next[v] != ABSENT)
+            prev[next[v]] = prev[v];
+    }
+
+    void grow(uint64_t key)
+    {
+        std::vector<unsigned> members;
+        for (unsigned b = 0; b < heads.size(); b++)
+        {
+            for (unsigned v = heads[b]; v != ABSENT; v = next[v])
+                members.push_back(v);
+        }
+
+        uint64_t size = heads.size();
+        while (key - cursor >= size)
+            size *= 2;
+        heads.assign(size, ABSENT);
+
+        for (unsigned i = 0; i < members.size(); i++)
+            link(members[i]);
+    }
+
+public:
+    BucketQueue() { cursor = ~(uint64_t) 0; count = 0; }
+
+    void reset(unsigned n)
+    {
+        if (heads.empty())
+            heads.assign(64, ABSENT);
+        else
+            heads.assign(heads.size(), ABSENT);
+        next.resize(n);
+        prev.resize(n);
+        keys.resize(n);
+        queued.assign(n, false);
+        cursor = ~(uint64_t) 0;
+        count = 0;
+    }
+
+    bool empty() const { return count == 0; }
+
+    void push(unsigned v, uint64_t key)
+    {
+        if (queued[v])
+        {
+            if (key >= keys[v])
+                return;
+            unlink(v);
+        }
+        else
+        {
+            // the cursor stays on the last extracted key, which no later key undercuts
+            if (count == 0 && key < cursor)
+                cursor = key;
+            queued[v] = true;
+            count ++;
+        }
+
+        if (key - cursor >= heads.size())
+        {
+            keys[v] = key;
+            grow(key);
+            link(v);
+            return;
+        }
+        keys[v] = key;
+        link(v);
+    }
+
+    unsigned pop()
+    {
+        while (heads[slot(cursor)] == ABSENT)
+            cursor ++;
+
+        unsigned v = heads[slot(cursor)];
+        unlink(v);
+        queued[v] = false;
+        count --;
+        return v;
+    }
+};
+
+
+// Radix heap: 65 buckets split by the highest bit in which a key differs from
+// the last extracted minimum. Decrease-key inserts a fresh entry; outdated
+// entries are recognised and dropped when their bucket is redistributed.
+class RadixHeap
+{
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        unsigned vertex;
+    };
+
+    std::vector<Entry> buckets[65];
+    std::vector<Entry> moving;
+    std::vector<uint64_t> keys;
+    std::vector<bool> queued;
+    uint64_t last;
+    unsigned count;
+
+    unsigned bucket(uint64_t key) const
+    {
+        uint64_t diff = key ^ last;
+        return diff ? 64 - __builtin_clzll(diff) : 0;
+    }
+
+    bool current(const Entry& e) const { return queued[e.vertex] && keys[e.vertex] == e.key; }
+
+public:
+    RadixHeap() { last = 0; count = 0; }
+
+    void reset(unsigned n)
+    {
+        for (unsigned b = 0; b < 65; b++)
+            buckets[b].clear();
+        keys.resize(n);
+        queued.assign(n, false);
+        last = 0;
+        count = 0;
+    }
+
+    bool empty() const { return count == 0; }
+
+    void push(unsigned v, uint64_t key)
+    {
+        if (queued[v])
+        {
+            if (key >= keys[v])
+                return;
+        }
+        else
+        {
+            queued[v] = true;
+            count ++;
+        }
+        keys[v] = key;
+
+        Entry e = { key, v };
+        buckets[bucket(key)].push_back(e);
+    }
+
+    unsigned pop()
+    {
+        for (;;)
+        {
+            while (!buckets[0].empty())
+            {
+                Entry e = buckets[0].back();
+                buckets[0].pop_back();
+                if (current(e))
+                {
+                    queued[e.vertex] = false;
+                    count --;
+                    return e.vertex;
+                }
+            }
+
+            unsigned b = 1;
+            while (buckets[b].empty())
+                b ++;
+
+            std::vector<Entry>& from = buckets[b];
+            uint64_t minimum = ~(uint64_t) 0;
+            for (unsigned i = 0; i < from.size(); i++)
+            {
+                if (current(from[i]) && from[i].key < minimum)
+                    minimum = from[i].key;
+            }
+
+            moving.clear();
+            moving.swap(from);
+            if (minimum == ~(uint64_t) 0)
+                continue;
+
+            last = minimum;
+            for (unsigned i = 0; i < moving.size(); i++)
+            {
+                if (current(moving[i]))
+                    buckets[bucket(moving[i].key)].push_back(moving[i]);
+            }
+        }
+    }
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <memory>
+
+#include "compact_graph.hpp"
+#include "disjoint_set.hpp"
+#include "parallel.hpp"
+
+
+// Minimum spanning forest engines over a CompactGraph. Edges are ordered by
+// (weight, edge index), so ties are broken the same way everywhere and both
+// engines return the same forest. Directed edges are taken as undirected.
+
+template<class EDATA>
+class KruskalBuilder
+{
+
+private:
+    const CompactGraph<EDATA>* graph;
+    unsigned threads;
+
+public:
+    KruskalBuilder(const CompactGraph<EDATA>* g, unsigned threads = 0)
+    {
+        this->graph = g;
+        this->threads = threads;
+    }
+
+    std::vector<unsigned> get()
+    {
+        const CompactGraph<EDATA>* g = graph;
+        std::vector<unsigned> order(g->num_edges());
+        for (unsigned e = 0; e < order.size(); e++)
+        {
+            order[e] = e;
+        }
+        parallel_sort(order, [g](unsigned a, unsigned b) {
+            EDATA wa = g->edge_weight(a);
+            EDATA wb = g->edge_weight(b);
+            return wa < wb || (!(wb < wa) && a < b);
+        }, threads);
+
+        DisjointSet sets(g->num_vertices());
+        std::vector<unsigned> forest;
+        for (unsigned i = 0; i < order.size() && forest.size() + 1 < g->num_vertices(); i++)
+        {
+            unsigned e = order[i];
+            if (sets.unite(g->edge_source(e), g->edge_destination(e)))
+            {
+                forest.push_back(e);
+            }
+        }
+        return forest;
+    }
+};
+
+
+// Borůvka rounds: every component picks its lightest outgoing edge in
+// parallel (a compare-and-swap per endpoint), the picks are merged, and edges
+// that became internal are dropped before the next round.
+template<class EDATA>
+class BoruvkaBuilder
+{
+
+private:
+    const CompactGraph<EDATA>* graph;
+    unsigned threads;
+
+    bool lighter(unsigned a, unsigned b) const
+    {
+        if (b == CompactGraph<EDATA>::NONE)
+            return true;
+        EDATA wa = graph->edge_weight(a);
+        EDATA wb = graph->edge_weight(b);
+        return wa < wb || (!(wb < wa) && a < b);
+    }
+
+    void offer(std::atomic<unsigned>& slot, unsigned e) const
+    {
+        unsigned current = slot.load(std::memory_order_relaxed);
+        while (lighter(e, current) && !slot.compare_exchange_weak(current, e, std::memory_order_relaxed))
+            ;
+    }
+
+public:
+    BoruvkaBuilder(const CompactGraph<EDATA>* g, unsigned threads = 0)
+    {
+        this->graph = g;
+        this->threads = threads ? threads : default_threads();
+    }
+
+    std::vector<unsigned> get()
+    {
+        const unsigned NONE = CompactGraph<EDATA>::NONE;
+        unsigned n = graph->num_vertices();
+        std::vector<unsigned> forest;
+        std::vector<unsigned> component(n);
+        std::unique_ptr<std::atomic<unsigned>[]> best(new std::atomic<unsigned>[n]);
+        DisjointSet sets(n);
+
+        std::vector<unsigned> active(graph->num_edges());
+        for (unsigned e = 0; e < active.size(); e++)
+        {
+            active[e] = e;
+        }
+        for (unsigned v = 0; v < n; v++)
+        {
+            component[v] = v;
+        }
+
+        std::vector<std::vector<unsigned> > kept(threads);
+        while (!active.empty())
+        {
+            parallel_for(0, n, threads, [&](unsigned lo, unsigned hi, unsigned) {
+                for (unsigned v = lo; v < hi; v++)
+                    best[v].store(NONE, std::memory_order_relaxed);
+            });
+
+            // keep only edges between components, and let both sides bid for them;
+            // threads left without a range this round must not hand in old edges
+            for (unsigned t = 0; t < kept.size(); t++)
+            {
+                kept[t].clear();
+            }
+            parallel_for(0, active.size(), threads, [&](unsigned lo, unsigned hi, unsigned t) {
+                for (unsigned i = lo; i < hi; i++)
+                {
+                    unsigned e = active[i];
+                    unsigned cu = component[graph->edge_source(e)];
+                    unsigned cv = component[graph->edge_destination(e)];
+                    if (cu == cv)
+                        continue;
+                    kept[t].push_back(e);
+                    offer(best[cu], e);
+                    offer(best[cv], e);
+                }
+            });
+
+            active.clear();
+            for (unsigned t = 0; t < kept.size(); t++)
+            {
+                active.insert(active.end(), kept[t].begin(), kept[t].end());
+            }
+
+            bool merged = false;
+            for (unsigned c = 0; c < n; c++)
+            {
+                unsigned e = best[c].load(std::memory_order_relaxed);
+                if (e != NONE && sets.unite(graph->edge_source(e), graph->edge_destination(e)))
+                {
+                    forest.push_back(e);
+                    merged = true;
+                }
+            }
+            if (!merged)
+            {
+                break;
+            }
+
+            parallel_for(0, n, threads, [&](unsigned lo, unsigned hi, unsigned) {
+                for (unsigned v = lo; v < hi; v++)
+                    component[v] = sets.find_root(v);
+            });
+        }
+        return forest;
+    }
+};
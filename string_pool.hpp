@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+
+
+// Strings back to back in one buffer, addressed by 32-bit ids: no allocation
+// and no object header per string, as a std::string has.
+class StringPool
+{
+
+private:
+    std::vector<char> chars;
+    std::vector<size_t> starts;     // string i is chars[starts[i], starts[i + 1])
+
+public:
+    StringPool() { starts.push_back(0); }
+
+    unsigned size() const { return starts.size() - 1; }
+    size_t num_chars() const { return chars.size(); }
+
+    unsigned add(const char* data, size_t size)
+    {
+        chars.insert(chars.end(), data, data + size);
+        starts.push_back(chars.size());
+        return starts.size() - 2;
+    }
+
+    unsigned add(const std::string& s) { return add(s.data(), s.size()); }
+
+    const char* data(unsigned id) const { return chars.data() + starts[id]; }
+    size_t length(unsigned id) const { return starts[id + 1] - starts[id]; }
+    std::string get(unsigned id) const { return std::string(data(id), length(id)); }
+
+    // Room for count strings of bytes characters in all, to be filled by
+    // place(), from any number of threads as long as each id is placed once
+    // and the strings follow each other in id order.
+    void resize(unsigned count, size_t bytes)
+    {
+        chars.resize(bytes);
+        starts.assign(count + 1, bytes);
+    }
+
+    void place(unsigned id, size_t offset, const char* data, size_t size)
+    {
+        starts[id] = offset;
+        std::memcpy(chars.data() + offset, data, size);
+    }
+
+    size_t memory_usage() const
+    {
+        return chars.capacity() + starts.capacity() * sizeof(size_t);
+    }
+};
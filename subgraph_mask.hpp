@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "overlay.hpp"
+
+
+// Vertices and edges of a subgraph, as bitmaps over the indices of the
+// parent graph; a FILTER for the engines of compact_graph.hpp and
+// traversal.hpp. An edge only counts when both its ends are in the mask too.
+// Indices past the sizes given count as left out, so a mask stays usable
+// after the parent graph grew; not after it lost an edge, whose index the
+// last edge takes (see Graph::Listener::edge_reindexed).
+class SubgraphMask
+{
+
+private:
+    std::vector<uint64_t> vertex_bits;
+    std::vector<uint64_t> edge_bits;
+    unsigned nvertices;
+    unsigned nedges;
+
+    static bool test(const std::vector<uint64_t>& bits, unsigned i)
+    {
+        return i / 64 < bits.size() && (bits[i / 64] >> (i % 64)) & 1;
+    }
+
+    static void set(std::vector<uint64_t>& bits, unsigned i, bool on)
+    {
+        if (i / 64 >= bits.size())
+            return;
+        uint64_t bit = (uint64_t) 1 << (i % 64);
+        bits[i / 64] = on ? bits[i / 64] | bit : bits[i / 64] & ~bit;
+    }
+
+    // all of [0, n) in or out, no bit set past n
+    static void fill(std::vector<uint64_t>& bits, unsigned n, bool on)
+    {
+        bits.assign((n + 63) / 64, on ? ~(uint64_t) 0 : 0);
+        if (on && n % 64)
+            bits.back() = ((uint64_t) 1 << (n % 64)) - 1;
+    }
+
+public:
+    // over a graph of nvertices and nedges, with everything in or nothing
+    SubgraphMask(unsigned nvertices = 0, unsigned nedges = 0, bool all = false)
+    {
+        this->nvertices = nvertices;
+        this->nedges = nedges;
+        fill(vertex_bits, nvertices, all);
+        fill(edge_bits, nedges, all);
+    }
+
+    // the listed vertices and edges; indices out of range are ignored
+    SubgraphMask(unsigned nvertices, unsigned nedges, const std::vector<unsigned>& vertices, const std::vector<unsigned>& edges)
+    {
+        this->nvertices = nvertices;
+        this->nedges = nedges;
+        fill(vertex_bits, nvertices, false);
+        fill(edge_bits, nedges, false);
+        for (unsigned i = 0; i < vertices.size(); i++)
+            set(vertex_bits, vertices[i], true);
+        for (unsigned i = 0; i < edges.size(); i++)
+            set(edge_bits, edges[i], true);
+    }
+
+    // every vertex and the edges of a query result, such as a tree
+    SubgraphMask(unsigned nvertices, unsigned nedges, const EdgeOverlay& overlay)
+    {
+        this->nvertices = nvertices;
+        this->nedges = nedges;
+        fill(vertex_bits, nvertices, true);
+        fill(edge_bits, nedges, false);
+        for (unsigned i = 0; i < overlay.size(); i++)
+            set(edge_bits, overlay.edges()[i], true);
+    }
+
+    unsigned num_vertices() const { return nvertices; }
+    unsigned num_edges() const { return nedges; }
+
+    bool vertex(unsigned v) const { return test(vertex_bits, v); }
+    bool edge(unsigned e) const { return test(edge_bits, e); }
+
+    void set_vertex(unsigned v, bool in = true) { set(vertex_bits, v, in); }
+    void set_edge(unsigned e, bool in = true) { set(edge_bits, e, in); }
+
+    void set_all_vertices(bool in = true) { fill(vertex_bits, nvertices, in); }
+    void set_all_edges(bool in = true) { fill(edge_bits, nedges, in); }
+
+    // keeps what both masks keep
+    SubgraphMask& operator&=(const SubgraphMask& o)
+    {
+        for (unsigned i = 0; i < vertex_bits.size(); i++)
+            vertex_bits[i] &= i < o.vertex_bits.size() ? o.vertex_bits[i] : 0;
+        for (unsigned i = 0; i < edge_bits.size(); i++)
+            edge_bits[i] &= i < o.edge_bits.size() ? o.edge_bits[i] : 0;
+        return *this;
+    }
+};
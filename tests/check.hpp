@@ -0,0 +1,59 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+
+// Minimal test registry. TEST(name) defines a case that runs when the test
+// program does; CHECK and CHECK_EQUAL report a failure with its location and
+// carry on, so that one run lists every broken expectation.
+struct TestCase
+{
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<TestCase>& test_cases()
+{
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline unsigned& test_failures()
+{
+    static unsigned failures = 0;
+    return failures;
+}
+
+struct TestRegistration
+{
+    TestRegistration(const char* name, void (*run)())
+    {
+        TestCase c = { name, run };
+        test_cases().push_back(c);
+    }
+};
+
+#define TEST(name) \
+    static void test_##name(); \
+    static TestRegistration registration_##name(#name, test_##name); \
+    static void test_##name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) \
+        { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            test_failures() ++; \
+        } \
+    } while (0)
+
+#define CHECK_EQUAL(actual, expected) \
+    do { \
+        if (!((actual) == (expected))) \
+        { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #actual " == " #expected \
+                      << " (" << (actual) << " vs " << (expected) << ")" << std::endl; \
+            test_failures() ++; \
+        } \
+    } while (0)
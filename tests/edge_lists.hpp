@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+
+#include "compact_graph.hpp"
+#include "weights.hpp"
+
+// Random edge lists and a slow reference for checking the graph algorithms.
+
+struct EdgeList
+{
+    unsigned n;
+    std::vector<unsigned> src;
+    std::vector<unsigned> dst;
+    std::vector<int> w;
+
+    void add(unsigned s, unsigned d, int weight)
+    {
+        src.push_back(s);
+        dst.push_back(d);
+        w.push_back(weight);
+    }
+
+    CompactGraph<int> freeze(bool directed) const { return CompactGraph<int>(directed, n, src, dst, w); }
+};
+
+inline EdgeList random_edges(unsigned n, unsigned m, unsigned long seed)
+{
+    EdgeList list;
+    list.n = n;
+    for (unsigned i = 0; i < m; i++)
+    {
+        seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+        unsigned s = (seed >> 33) % n;
+        seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+        unsigned d = (seed >> 33) % n;
+        list.add(s, d, 1 + (seed >> 40) % 50);
+    }
+    return list;
+}
+
+// distances by Bellman-Ford, -1 when unreached
+inline std::vector<long> reference_distances(const EdgeList& list, bool directed, unsigned start)
+{
+    std::vector<long> d(list.n, -1);
+    d[start] = 0;
+    for (unsigned round = 0; round < list.n; round++)
+    {
+        for (unsigned e = 0; e < list.src.size(); e++)
+        {
+            for (int side = 0; side < (directed ? 1 : 2); side++)
+            {
+                unsigned a = side ? list.dst[e] : list.src[e];
+                unsigned b = side ? list.src[e] : list.dst[e];
+                if (d[a] >= 0 && (d[b] < 0 || d[a] + list.w[e] < d[b]))
+                    d[b] = d[a] + list.w[e];
+            }
+        }
+    }
+    return d;
+}
+
+// hop counts by a plain queue, -1 when unreached
+inline std::vector<int> hops_from(const CompactGraph<int>& g, unsigned source)
+{
+    std::vector<int> hops(g.num_vertices(), -1);
+    std::vector<unsigned> queue(1, source);
+    hops[source] = 0;
+    for (unsigned head = 0; head < queue.size(); head++)
+    {
+        unsigned v = queue[head];
+        for (unsigned a = g.begin(v); a < g.end(v); a++)
+        {
+            if (hops[g.target(a)] < 0)
+            {
+                hops[g.target(a)] = hops[v] + 1;
+                queue.push_back(g.target(a));
+            }
+        }
+    }
+    return hops;
+}
+
+// Sum of a path as the queries return it: edges from end back to start.
+// Returns -1 when the edges do not form such a walk.
+inline long walk_length(const CompactGraph<int>& g, const std::vector<unsigned>& path, unsigned start, unsigned end)
+{
+    long total = 0;
+    unsigned v = end;
+    for (unsigned i = 0; i < path.size(); i++)
+    {
+        unsigned e = path[i];
+        if (g.edge_destination(e, g.opposite(e, v)) != v)
+            return -1;
+        total += g.edge_weight(e);
+        v = g.opposite(e, v);
+    }
+    return v == start ? total : -1;
+}
+
+// Int weights by the library defaults; unreached vertices are at infinity().
+typedef DefaultWeights<int> IntWeights;
+
+inline IntWeights int_weights() { return IntWeights(); }
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+#include "graph.hpp"
+
+// Graphs as main.cpp builds them: string labels, int weights.
+typedef Graph<std::string, int> StringGraph;
+
+inline StringGraph make_graph(bool directed)
+{
+    return StringGraph(directed);
+}
@@ -0,0 +1,23 @@
+#include <cstring>
+
+#include "check.hpp"
+
+// Runs every test, or those whose name contains the first argument.
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : "";
+    unsigned run = 0;
+    for (unsigned i = 0; i < test_cases().size(); i++)
+    {
+        const TestCase& c = test_cases()[i];
+        if (!std::strstr(c.name, filter))
+            continue;
+        unsigned before = test_failures();
+        c.run();
+        if (test_failures() != before)
+            std::cerr << "FAILED " << c.name << std::endl;
+        run ++;
+    }
+    std::cout << run << " tests, " << test_failures() << " failed checks" << std::endl;
+    return test_failures() ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+#include <vector>
+
+#include "check.hpp"
+#include "edge_lists.hpp"
+#include "all_sources.hpp"
+
+namespace
+{
+
+// the same aggregates from Bellman-Ford distances and a shortest-path tree
+SourceStats<int> reference_stats(const EdgeList& list, const CompactGraph<int>& g, bool directed, unsigned source)
+{
+    std::vector<long> d = reference_distances(list, directed, source);
+    CompactGraph<int>::ShortestPathTree tree = g.shortest_path_tree(source, int_weights());
+    SourceStats<int> s = { 0, 0, 0, 0 };
+    for (unsigned v = 0; v < list.n; v++)
+    {
+        if (d[v] < 0)
+            continue;
+        s.distance_sum += d[v];
+        if (s.eccentricity < d[v])
+            s.eccentricity = d[v];
+        if (tree.parent[v] != CompactGraph<int>::NONE)
+            s.tree_weight += g.edge_weight(tree.parent[v]);
+        s.reached++;
+    }
+    return s;
+}
+
+}
+
+TEST(all_sources_stats_of_every_source)
+{
+    ThreadPool pool(3);
+    for (int directed = 0; directed < 2; directed++)
+    {
+        EdgeList list = random_edges(80, 160, 41 + directed);
+        CompactGraph<int> g = list.freeze(directed);
+        std::vector<SourceStats<int> > stats = AllSourcesBuilder<int>(&g, int_weights(), &pool).get();
+        std::vector<SourceStats<int> > own = AllSourcesBuilder<int, BucketQueue>(&g, int_weights(), 0, 2).get();
+        CHECK_EQUAL(stats.size(), list.n);
+        for (unsigned v = 0; v < list.n; v++)
+        {
+            SourceStats<int> expected = reference_stats(list, g, directed, v);
+            CHECK_EQUAL(stats[v].tree_weight, expected.tree_weight);
+            CHECK_EQUAL(stats[v].distance_sum, expected.distance_sum);
+            CHECK_EQUAL(stats[v].eccentricity, expected.eccentricity);
+            CHECK_EQUAL(stats[v].reached, expected.reached);
+            CHECK_EQUAL(own[v].distance_sum, expected.distance_sum);
+        }
+    }
+}
+
+TEST(all_sources_pivot)
+{
+    // a star: the centre wins on every criterion
+    EdgeList list;
+    list.n = 5;
+    for (unsigned v = 0; v < 4; v++)
+        list.add(v, 4, 1 + v);
+    CompactGraph<int> g = list.freeze(false);
+    AllSourcesBuilder<int> builder(&g, int_weights(), 0, 2);
+    CHECK_EQUAL(builder.pivot(CLOSENESS), 4u);
+    CHECK_EQUAL(builder.pivot(ECCENTRICITY), 4u);
+
+    // every tree of a tree weighs the same, so the lowest index wins
+    CHECK_EQUAL(builder.pivot(TREE_WEIGHT), 0u);
+
+    EdgeList empty;
+    empty.n = 0;
+    CompactGraph<int> none = empty.freeze(false);
+    CHECK_EQUAL(AllSourcesBuilder<int>(&none, int_weights()).pivot(), CompactGraph<int>::NONE);
+}
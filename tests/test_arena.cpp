@@ -0,0 +1,175 @@
+#include <vector>
+#include <utility>
+#include <string>
+
+#include "check.hpp"
+#include "arena.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+struct Counted
+{
+    static int live;
+    unsigned value;
+    Counted(unsigned v) { value = v; live++; }
+    ~Counted() { live--; }
+};
+
+int Counted::live = 0;
+
+}
+
+TEST(arena_pointers_stay_valid)
+{
+    {
+        Arena<Counted> arena;
+        std::vector<Counted*> made;
+        for (unsigned i = 0; i < 5000; i++)
+            made.push_back(arena.create(i));
+        CHECK_EQUAL(arena.size(), 5000u);
+        CHECK_EQUAL(Counted::live, 5000);
+        for (unsigned i = 0; i < made.size(); i++)
+            CHECK_EQUAL(made[i]->value, i);
+
+        // a move hands the objects over without touching them
+        Arena<Counted> moved(std::move(arena));
+        CHECK_EQUAL(arena.size(), 0u);
+        CHECK_EQUAL(moved.size(), 5000u);
+        CHECK_EQUAL(made[4999]->value, 4999u);
+
+        moved.clear();
+        CHECK_EQUAL(Counted::live, 0);
+        moved.create(1u);
+    }
+    CHECK_EQUAL(Counted::live, 0);
+}
+
+TEST(arena_reserve)
+{
+    // an empty reservation adds no block, a tiny one still lets create() grow
+    Arena<unsigned> arena;
+    arena.reserve(0);
+    CHECK_EQUAL(arena.capacity_bytes(), 0u);
+    arena.reserve(1);
+    for (unsigned i = 0; i < 300; i++)
+        CHECK_EQUAL(*arena.create(i), i);
+
+    Arena<unsigned> exact;
+    exact.reserve(1000);
+    size_t bytes = exact.capacity_bytes();
+    for (unsigned i = 0; i < 1000; i++)
+        exact.create(i);
+    CHECK_EQUAL(exact.capacity_bytes(), bytes);
+}
+
+TEST(arena_backed_graph_clone_and_move)
+{
+    StringGraph g = make_graph(false);
+    g.reserve(0, 0);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    g.add_edge(4, a, b);
+
+    // the clone is deep: changing it leaves the original alone
+    StringGraph copy = g.clone();
+    copy.add_edge(5, copy.get_vertex_data("a"), copy.get_vertex_data("b"));
+    CHECK_EQUAL(g.num_edges(), 1u);
+    CHECK_EQUAL(copy.num_edges(), 2u);
+    CHECK(copy.get_vertex_data("a") != a);
+
+    StringGraph moved(std::move(g));
+    CHECK(moved.get_vertex_data("b") == b);
+    CHECK_EQUAL(moved.num_edges(), 1u);
+
+    StringGraph empty = make_graph(false);
+    StringGraph none = empty.clone();
+    CHECK_EQUAL(none.num_vertices(), 0u);
+    none.add_vertex("x");
+    CHECK_EQUAL(none.num_vertices(), 1u);
+}
+
+TEST(arena_destroy_recycles)
+{
+    {
+        Arena<Counted> arena;
+        std::vector<Counted*> made;
+        for (unsigned i = 0; i < 100; i++)
+            made.push_back(arena.create(i));
+        size_t bytes = arena.capacity_bytes();
+
+        // churn reuses the freed slots, most recent first
+        for (unsigned round = 0; round < 1000; round++)
+        {
+            arena.destroy(made[round % 100]);
+            CHECK_EQUAL(Counted::live, 99);
+            Counted* again = arena.create(round);
+            CHECK(again == made[round % 100]);
+        }
+        CHECK_EQUAL(arena.capacity_bytes(), bytes);
+
+        // clear() skips the destroyed objects
+        arena.destroy(made[3]);
+        arena.destroy(made[70]);
+        CHECK_EQUAL(arena.size(), 98u);
+        arena.clear();
+        CHECK_EQUAL(Counted::live, 0);
+    }
+    CHECK_EQUAL(Counted::live, 0);
+}
+
+namespace
+{
+
+struct Reindexed : StringGraph::Listener
+{
+    std::vector<std::pair<unsigned, unsigned> > moves;     // (old index, new index)
+
+    void edge_reindexed(StringGraph::Edge* e, unsigned old_index)
+    {
+        moves.push_back(std::make_pair(old_index, e->get_index()));
+    }
+};
+
+}
+
+TEST(arena_backed_graph_recycles_removed_edges)
+{
+    StringGraph g = make_graph(true);
+    for (unsigned v = 0; v < 10; v++)
+        g.add_vertex(std::to_string(v));
+    for (unsigned e = 0; e < 50; e++)
+        g.add_edge(e, g.get_vertex(e % 10), g.get_vertex(e * 7 % 10));
+
+    Reindexed listener;
+    g.add_listener(&listener);
+
+    // the last edge moves into the removed one's index, and is told so
+    StringGraph::Edge* last = g.get_edge(49);
+    g.remove_edge(g.get_edge(12));
+    CHECK(g.get_edge(12) == last);
+    CHECK_EQUAL(listener.moves.size(), 1u);
+    CHECK(listener.moves[0] == std::make_pair(49u, 12u));
+
+    // removing the last edge moves nothing
+    g.remove_edge(g.get_edge(48));
+    CHECK_EQUAL(listener.moves.size(), 1u);
+
+    // steady churn keeps the edge memory where it was
+    size_t bytes = g.memory_usage().edges;
+    for (unsigned round = 0; round < 5000; round++)
+    {
+        g.remove_edge(g.get_edge(round * 13 % g.num_edges()));
+        StringGraph::Edge* e = g.add_edge(round, g.get_vertex(round % 10), g.get_vertex(round / 10 % 10));
+        CHECK_EQUAL(e->get_index(), g.num_edges() - 1);
+        CHECK_EQUAL(e->get_weight(), (int) round);
+    }
+    CHECK_EQUAL(g.num_edges(), 48u);
+    CHECK_EQUAL(g.memory_usage().edges, bytes);
+
+    unsigned degrees = 0;
+    for (unsigned v = 0; v < g.num_vertices(); v++)
+        degrees += g.get_vertex(v)->get_degree();
+    CHECK_EQUAL(degrees, 48u);
+}
@@ -0,0 +1,46 @@
+#include <vector>
+#include <utility>
+
+#include "check.hpp"
+#include "edge_lists.hpp"
+#include "batch_paths.hpp"
+
+TEST(batch_paths_match_dijkstra)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        EdgeList list = random_edges(70, 180, 55 + directed);
+        CompactGraph<int> g = list.freeze(directed);
+        CompactGraph<int> reverse = g.reversed();
+
+        // shared sources, shared targets, repeats and s == t
+        std::vector<std::pair<unsigned, unsigned> > queries;
+        unsigned long state = 9;
+        for (unsigned i = 0; i < 120; i++)
+        {
+            state = state * 6364136223846793005ul + 1442695040888963407ul;
+            unsigned other = (state >> 33) % list.n;
+            queries.push_back(i % 3 ? std::make_pair(5u, other) : std::make_pair(other, 11u));
+        }
+        queries.push_back(std::make_pair(4u, 4u));
+
+        BatchPathBuilder<int>::TreeCache cache(3);
+        for (int round = 0; round < 3; round++)
+        {
+            // without a cache, filling it, then answered from it
+            std::vector<std::vector<unsigned> > paths = BatchPathBuilder<int>(&g, &reverse, int_weights(), round ? &cache : 0, 2).get(queries);
+            CHECK_EQUAL(paths.size(), queries.size());
+            for (unsigned i = 0; i < queries.size(); i++)
+            {
+                unsigned s = queries[i].first;
+                unsigned t = queries[i].second;
+                long expected = reference_distances(list, directed, s)[t];
+                if (expected <= 0)
+                    CHECK(paths[i].empty());
+                else
+                    CHECK_EQUAL(walk_length(g, paths[i], s, t), expected);
+            }
+        }
+        CHECK(cache.size() > 0);
+    }
+}
@@ -0,0 +1,112 @@
+#include <vector>
+
+#include "check.hpp"
+#include "edge_lists.hpp"
+
+namespace
+{
+
+CompactGraph<int>::ShortestPathTree tree_of(const CompactGraph<int>& g, unsigned start)
+{
+    return g.shortest_path_tree(start, int_weights());
+}
+
+}
+
+TEST(compact_graph_adjacency_in_edge_order)
+{
+    EdgeList list;
+    list.n = 4;
+    list.add(0, 1, 5);
+    list.add(2, 0, 3);
+    list.add(1, 2, 4);
+    list.add(0, 3, 1);
+
+    CompactGraph<int> g = list.freeze(false);
+    CHECK_EQUAL(g.num_vertices(), 4u);
+    CHECK_EQUAL(g.num_edges(), 4u);
+    CHECK_EQUAL(g.num_arcs(), 8u);
+    CHECK_EQUAL(g.get_degree(0), 3u);
+
+    // vertex 0 sees edges 0, 1, 3 in that order
+    unsigned a = g.begin(0);
+    CHECK_EQUAL(g.edge(a), 0u);
+    CHECK_EQUAL(g.target(a), 1u);
+    CHECK_EQUAL(g.edge(a + 1), 1u);
+    CHECK_EQUAL(g.target(a + 1), 2u);
+    CHECK_EQUAL(g.weight(a + 1), 3);
+    CHECK_EQUAL(g.edge(a + 2), 3u);
+
+    CHECK_EQUAL(g.edge_destination(1, 0), 2u);
+    CHECK_EQUAL(g.edge_destination(1, 2), 0u);
+    CHECK_EQUAL(g.edge_destination(1, 3), CompactGraph<int>::NONE);
+    CHECK_EQUAL(g.opposite(2, 2), 1u);
+
+    CompactGraph<int> d = list.freeze(true);
+    CHECK_EQUAL(d.num_arcs(), 4u);
+    CHECK_EQUAL(d.get_degree(0), 2u);
+    CHECK_EQUAL(d.get_degree(3), 0u);
+    CHECK_EQUAL(d.edge_destination(1, 0), CompactGraph<int>::NONE);
+}
+
+TEST(compact_graph_min_spanning_forest)
+{
+    // a square with a diagonal, and a separate pair
+    EdgeList list;
+    list.n = 6;
+    list.add(0, 1, 4);
+    list.add(1, 2, 1);
+    list.add(2, 3, 2);
+    list.add(3, 0, 3);
+    list.add(0, 2, 5);
+    list.add(4, 5, 7);
+
+    CompactGraph<int> g = list.freeze(false);
+    std::vector<unsigned> tree = g.min_spanning_tree();
+    int total = 0;
+    for (unsigned i = 0; i < tree.size(); i++)
+        total += g.edge_weight(tree[i]);
+    CHECK_EQUAL(tree.size(), 4u);
+    CHECK_EQUAL(total, 13);
+
+    // isolated vertices, the start among them, do not end the forest early
+    EdgeList sparse;
+    sparse.n = 7;
+    sparse.add(1, 2, 3);
+    sparse.add(4, 5, 1);
+    sparse.add(5, 6, 2);
+    CompactGraph<int> s = sparse.freeze(false);
+    CHECK_EQUAL(s.min_spanning_tree(0).size(), 3u);
+    CHECK_EQUAL(s.min_spanning_tree(3).size(), 3u);
+}
+
+TEST(compact_graph_shortest_path_tree)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        EdgeList list = random_edges(40, 120, 7 + directed);
+        CompactGraph<int> g = list.freeze(directed);
+        for (unsigned start = 0; start < list.n; start += 7)
+        {
+            CompactGraph<int>::ShortestPathTree tree = tree_of(g, start);
+            std::vector<long> expected = reference_distances(list, directed, start);
+            for (unsigned v = 0; v < list.n; v++)
+            {
+                if (expected[v] < 0)
+                    continue;
+                CHECK_EQUAL(tree.distance[v], expected[v]);
+
+                // the parent edges lead back to start with the same weight
+                long along = 0;
+                unsigned u = v;
+                while (tree.parent[u] != CompactGraph<int>::NONE)
+                {
+                    along += g.edge_weight(tree.parent[u]);
+                    u = g.opposite(tree.parent[u], u);
+                }
+                CHECK_EQUAL(u, start);
+                CHECK_EQUAL(along, expected[v]);
+            }
+        }
+    }
+}
@@ -0,0 +1,145 @@
+#include <vector>
+#include <string>
+
+#include "check.hpp"
+#include "components.hpp"
+#include "edge_lists.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+unsigned long next_random(unsigned long& state, unsigned n)
+{
+    state = state * 6364136223846793005ul + 1442695040888963407ul;
+    return (state >> 33) % n;
+}
+
+// mismatches of the components against reachability by plain BFS
+unsigned count_mismatches(const CompactGraph<int>& g, const Components<int>& c)
+{
+    unsigned mismatches = 0;
+    std::vector<std::vector<int> > hops(g.num_vertices());
+    for (unsigned v = 0; v < g.num_vertices(); v++)
+        hops[v] = hops_from(g, v);
+
+    for (unsigned u = 0; u < g.num_vertices(); u++)
+    {
+        unsigned size = 0;
+        for (unsigned v = 0; v < g.num_vertices(); v++)
+        {
+            bool reaches = hops[u][v] >= 0;
+            bool mutual = reaches && hops[v][u] >= 0;
+            mismatches += !reaches && c.may_reach(u, v) && (!g.is_directed() || c.strong_component(u) == c.strong_component(v));
+            mismatches += reaches && !c.may_reach(u, v);
+            mismatches += mutual != (c.strong_component(u) == c.strong_component(v));
+            if (!g.is_directed())
+                mismatches += reaches != c.connected(u, v);
+            size += c.connected(u, v);
+        }
+        mismatches += size != c.component_size(u);
+    }
+
+    // arcs never climb the order of the strong components
+    for (unsigned v = 0; v < g.num_vertices(); v++)
+    {
+        for (unsigned a = g.begin(v); a < g.end(v); a++)
+            mismatches += c.strong_component(g.target(a)) > c.strong_component(v);
+    }
+    return mismatches;
+}
+
+}
+
+TEST(components_match_reachability)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        // sparse enough to leave several components
+        EdgeList list = random_edges(70, 60 + 40 * directed, 3 + directed);
+        CompactGraph<int> g = list.freeze(directed);
+        Components<int> c;
+        c.build(g);
+        CHECK(c.is_current());
+        CHECK_EQUAL(count_mismatches(g, c), 0u);
+        CHECK(c.num_components() > 1);
+        if (directed)
+            CHECK(c.num_strong_components() > c.num_components());
+    }
+}
+
+TEST(components_updated_as_the_graph_grows)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        EdgeList list = random_edges(40, 20, 9 + directed);
+        Components<int> c;
+        c.build(list.freeze(directed));
+
+        unsigned long state = 5;
+        for (unsigned i = 0; i < 60; i++)
+        {
+            if (i % 10 == 0)
+            {
+                list.n ++;
+                c.vertex_added();
+            }
+            unsigned s = next_random(state, list.n);
+            unsigned d = next_random(state, list.n);
+            list.add(s, d, 1);
+            c.edge_added(s, d);
+            if (!c.is_current())
+                c.build(list.freeze(directed));
+            CHECK_EQUAL(count_mismatches(list.freeze(directed), c), 0u);
+        }
+
+        c.edge_removed();
+        CHECK(!c.is_built());
+    }
+}
+
+TEST(components_through_the_graph)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        StringGraph g = make_graph(directed);
+        unsigned long state = 17 + directed;
+        for (unsigned v = 0; v < 50; v++)
+            g.add_vertex(std::to_string(v));
+
+        for (unsigned u = 0; u < 120; u++)
+        {
+            if (u % 4 != 3 || g.num_edges() == 0)
+                g.add_edge(1 + next_random(state, 9), g.get_vertex(next_random(state, 50)), g.get_vertex(next_random(state, 50)));
+            else
+                g.remove_edge(g.get_edge(next_random(state, g.num_edges())));
+            if (u % 20 != 19)
+                continue;
+
+            unsigned mismatches = 0;
+            for (unsigned s = 0; s < 50; s += 3)
+            {
+                StringGraph::Vertex* start = g.get_vertex(s);
+                std::vector<bool> seen(50, false);
+                for (auto it = g.breadth_first_iterator(start); it.has_next(); it.next())
+                    seen[it.current()->get_index()] = true;
+                for (unsigned e = 0; e < 50; e++)
+                    mismatches += g.is_reachable(start, g.get_vertex(e)) != seen[e];
+            }
+            CHECK_EQUAL(mismatches, 0u);
+        }
+
+        if (!directed)
+        {
+            // the tree of a component spans it and nothing else
+            StringGraph::Vertex* start = g.get_vertex(0);
+            unsigned count = 0;
+            for (auto it = g.component_spanning_tree_iterator(start); it.has_next(); it.next())
+            {
+                CHECK(g.components().connected(0, it.current()->get_source()->get_index()));
+                count++;
+            }
+            CHECK_EQUAL(count + 1, g.components().component_size(0));
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <cstdio>
+
+#include "check.hpp"
+#include "contraction_hierarchy.hpp"
+#include "edge_lists.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+// grid with random weights, the shape hierarchies are meant for
+EdgeList grid_edges(unsigned side, unsigned long seed)
+{
+    EdgeList list;
+    list.n = side * side;
+    for (unsigned v = 0; v < list.n; v++)
+    {
+        seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+        if (v % side + 1 < side)
+            list.add(v, v + 1, 1 + (seed >> 33) % 20);
+        if (v + side < list.n)
+            list.add(v, v + side, 1 + (seed >> 45) % 20);
+    }
+    return list;
+}
+
+// mismatches between the hierarchy and Bellman-Ford over pairs
+unsigned count_mismatches(const EdgeList& list, bool directed, const CompactGraph<int>& g, const ContractionHierarchy<int>& hierarchy)
+{
+    unsigned mismatches = 0;
+    for (unsigned start = 0; start < list.n; start += 7)
+    {
+        std::vector<long> expected = reference_distances(list, directed, start);
+        for (unsigned end = 0; end < list.n; end += 3)
+        {
+            std::vector<unsigned> path = hierarchy.shortest_path(start, end, int_weights());
+            if (expected[end] < 0 || start == end)
+                mismatches += !path.empty();
+            else
+                mismatches += walk_length(g, path, start, end) != expected[end];
+        }
+    }
+    return mismatches;
+}
+
+}
+
+TEST(contraction_hierarchy_matches_dijkstra)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        EdgeList lists[] = { grid_edges(9, 5 + directed), random_edges(50, 90, 17 + directed) };
+        for (unsigned i = 0; i < 2; i++)
+        {
+            CompactGraph<int> g = lists[i].freeze(directed);
+            ContractionHierarchy<int> hierarchy(g, int_weights());
+            CHECK(hierarchy.fits(g));
+            CHECK_EQUAL(hierarchy.is_directed(), (bool) directed);
+            CHECK_EQUAL(count_mismatches(lists[i], directed, g, hierarchy), 0u);
+        }
+    }
+}
+
+TEST(contraction_hierarchy_concurrent_queries)
+{
+    EdgeList list = grid_edges(10, 3);
+    CompactGraph<int> g = list.freeze(false);
+    ContractionHierarchy<int> hierarchy(g, int_weights());
+    ContractionHierarchy<int> copy = hierarchy;
+
+    std::vector<unsigned> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < mismatches.size(); t++)
+        threads.push_back(std::thread([&, t]() { mismatches[t] = count_mismatches(list, false, g, t % 2 ? copy : hierarchy); }));
+    for (unsigned t = 0; t < threads.size(); t++)
+        threads[t].join();
+    for (unsigned t = 0; t < mismatches.size(); t++)
+        CHECK_EQUAL(mismatches[t], 0u);
+}
+
+TEST(contraction_hierarchy_file_round_trip)
+{
+    const char* FILENAME = "hierarchy_test.chidx";
+    EdgeList list = grid_edges(8, 11);
+    CompactGraph<int> g = list.freeze(true);
+    ContractionHierarchy<int> built(g, int_weights());
+    CHECK(built.write(FILENAME));
+
+    ContractionHierarchy<int> read(FILENAME);
+    CHECK(read.fits(g));
+    CHECK_EQUAL(read.num_shortcuts(), built.num_shortcuts());
+    CHECK_EQUAL(count_mismatches(list, true, g, read), 0u);
+
+    // a truncated file reads back empty
+    std::ifstream in(FILENAME, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream(FILENAME, std::ios::binary).write(bytes.data(), bytes.size() - 3);
+    ContractionHierarchy<int> truncated(FILENAME);
+    CHECK_EQUAL(truncated.num_vertices(), 0u);
+    CHECK(truncated.shortest_path(0, 5, int_weights()).empty());
+
+    ContractionHierarchy<int> missing("no_such_file.chidx");
+    CHECK(!missing.fits(g));
+    std::remove(FILENAME);
+}
+
+TEST(contraction_hierarchy_through_the_graph)
+{
+    StringGraph g = make_graph(false);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    StringGraph::Vertex* c = g.add_vertex("c");
+    g.add_edge(2, a, b);
+    g.add_edge(3, b, c);
+    g.add_edge(9, a, c);
+
+    ContractionHierarchy<int> hierarchy = g.contraction_hierarchy();
+    int total = 0;
+    unsigned count = 0;
+    for (auto it = g.hierarchy_path_iterator(hierarchy, a, c); it.has_next(); it.next())
+    {
+        total += it.current()->get_weight();
+        count++;
+    }
+    CHECK_EQUAL(total, 5);
+    CHECK_EQUAL(count, 2u);
+
+    // a hierarchy of another shape gives no path
+    g.add_vertex("d");
+    CHECK(!g.hierarchy_path_iterator(hierarchy, a, c).has_next());
+}
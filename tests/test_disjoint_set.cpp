@@ -0,0 +1,26 @@
+#include "check.hpp"
+#include "disjoint_set.hpp"
+
+TEST(disjoint_set_unite_and_find)
+{
+    DisjointSet sets(6);
+    CHECK_EQUAL(sets.num_sets(), 6u);
+    CHECK(sets.unite(0, 1));
+    CHECK(sets.unite(2, 3));
+    CHECK(sets.unite(1, 3));
+    CHECK(!sets.unite(0, 2));
+    CHECK_EQUAL(sets.num_sets(), 3u);
+    CHECK(sets.same(0, 3));
+    CHECK(!sets.same(0, 4));
+    CHECK_EQUAL(sets.find_root(2), sets.find(0));
+
+    unsigned v = sets.add();
+    CHECK_EQUAL(v, 6u);
+    CHECK_EQUAL(sets.size(), 7u);
+    CHECK_EQUAL(sets.num_sets(), 4u);
+    CHECK(sets.unite(v, 5));
+
+    sets.reset(3);
+    CHECK_EQUAL(sets.num_sets(), 3u);
+    CHECK(!sets.same(0, 1));
+}
@@ -0,0 +1,90 @@
+#include <vector>
+
+#include "check.hpp"
+#include "edge_lists.hpp"
+#include "distance_matrix.hpp"
+
+namespace
+{
+
+void check_against_dijkstra(const EdgeList& list, bool directed, unsigned threads)
+{
+    CompactGraph<int> g = list.freeze(directed);
+    DistanceMatrix<int> matrix(g, int_weights(), threads);
+    CHECK_EQUAL(matrix.num_vertices(), list.n);
+
+    for (unsigned u = 0; u < list.n; u++)
+    {
+        CompactGraph<int>::ShortestPathTree tree = g.shortest_path_tree(u, int_weights());
+        for (unsigned v = 0; v < list.n; v++)
+        {
+            bool reached = tree.distance[v] < int_weights().infinity();
+            CHECK_EQUAL(matrix.is_reachable(u, v), reached);
+            if (!reached)
+            {
+                CHECK(matrix.path(g, u, v).empty());
+                continue;
+            }
+            CHECK_EQUAL(matrix.distance(u, v), tree.distance[v]);
+
+            // the path runs from u to v along arcs, with the same length
+            std::vector<unsigned> path = matrix.path(g, u, v);
+            int along = 0;
+            unsigned x = u;
+            for (unsigned i = 0; i < path.size(); i++)
+            {
+                CHECK_EQUAL(g.edge_destination(path[i], x), g.opposite(path[i], x));
+                along += g.edge_weight(path[i]);
+                x = g.opposite(path[i], x);
+            }
+            CHECK_EQUAL(x, v);
+            CHECK_EQUAL(along, tree.distance[v]);
+        }
+    }
+}
+
+}
+
+TEST(distance_matrix_matches_dijkstra)
+{
+    // sizes around whole tiles, so the padding is exercised too
+    unsigned sizes[] = { 1, 63, 64, 150 };
+    for (unsigned s = 0; s < 4; s++)
+    {
+        for (int directed = 0; directed < 2; directed++)
+        {
+            EdgeList list = random_edges(sizes[s], sizes[s] * 3, 90 + s);
+            check_against_dijkstra(list, directed, 1 + s % 3);
+        }
+    }
+}
+
+TEST(distance_matrix_with_zero_weights)
+{
+    // zero-weight cycles make ties that the next hops must not loop around
+    EdgeList list = random_edges(100, 400, 12);
+    for (unsigned i = 0; i < list.w.size(); i++)
+        list.w[i] %= 3;
+    check_against_dijkstra(list, true, 2);
+    check_against_dijkstra(list, false, 3);
+}
+
+TEST(distance_matrix_row_kernel)
+{
+    // whatever kernel MinPlusRow<int> picks on this CPU agrees with the scalar loop
+    unsigned count = 64;
+    std::vector<int> d(count), dk(count), expected(count);
+    std::vector<unsigned> next(count), expected_next(count);
+    unsigned long state = 3;
+    for (unsigned j = 0; j < count; j++)
+    {
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+        d[j] = expected[j] = (state >> 33) % 100;
+        dk[j] = (state >> 45) % 100;
+        next[j] = expected_next[j] = j;
+    }
+    min_plus_row(&expected[0], &expected_next[0], 40, 999u, &dk[0], count);
+    MinPlusRow<int>::relax(&d[0], &next[0], 40, 999u, &dk[0], count);
+    CHECK(d == expected);
+    CHECK(next == expected_next);
+}
@@ -0,0 +1,127 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+
+#include "check.hpp"
+#include "dot_reader.hpp"
+
+namespace
+{
+
+struct Recorder
+{
+    std::vector<std::string> vertices;
+    std::vector<std::string> edges;     // "src dst weight"
+
+    void vertex(const char* data, size_t size)
+    {
+        vertices.push_back(std::string(data, size));
+    }
+
+    void edge(const char* src, size_t srclen, const char* dst, size_t dstlen, double weight)
+    {
+        edges.push_back(std::string(src, srclen) + " " + std::string(dst, dstlen) + " " + std::to_string((int) weight));
+    }
+};
+
+Recorder read_text(const std::string& text, bool* directed = 0)
+{
+    const char* filename = "test_dot_reader.dot";
+    std::ofstream(filename, std::ios::binary) << text;
+    Recorder r;
+    DotReader reader(filename);
+    CHECK(reader.is_open());
+    reader.read(r);
+    if (directed)
+        *directed = reader.is_directed();
+    std::remove(filename);
+    return r;
+}
+
+}
+
+TEST(dot_reader_graph_statements)
+{
+    bool directed = true;
+    Recorder r = read_text(
+        "graph {\n"
+        "\tlabelloc=\"t\";label=\"a title\"\n"
+        "\t// a comment\n"
+        "\tAntoine -- Hilda [label=40]\n"
+        "\t\"Jean Luc\" -- Hilda [weight=7, color=red];\n"
+        "\tlonely\n"
+        "\ta -- b -- c [label=3]\n"
+        "\td -- e\n"
+        "}\n", &directed);
+
+    CHECK(!directed);
+    CHECK_EQUAL(r.edges.size(), 5u);
+    CHECK_EQUAL(r.edges[0], std::string("Antoine Hilda 40"));
+    CHECK_EQUAL(r.edges[1], std::string("Jean Luc Hilda 7"));
+    CHECK_EQUAL(r.edges[2], std::string("a b 3"));
+    CHECK_EQUAL(r.edges[3], std::string("b c 3"));
+    CHECK_EQUAL(r.edges[4], std::string("d e 1"));
+    CHECK_EQUAL(r.vertices.size(), 1u);
+    CHECK_EQUAL(r.vertices[0], std::string("lonely"));
+}
+
+TEST(dot_reader_directed_inputs)
+{
+    bool directed = false;
+    Recorder r = read_text("digraph g {\n a -> b [label=2]\n}\n", &directed);
+    CHECK(directed);
+    CHECK_EQUAL(r.edges.size(), 1u);
+
+    // a bare edge list takes its direction from the first operator
+    directed = false;
+    r = read_text("x -> y [label=4]\ny -> z\n", &directed);
+    CHECK(directed);
+    CHECK_EQUAL(r.edges.size(), 2u);
+    CHECK_EQUAL(r.edges[1], std::string("y z 1"));
+}
+
+TEST(dot_reader_attributes)
+{
+    const char* filename = "test_dot_reader.dot";
+    std::ofstream(filename, std::ios::binary) << "graph {\n\tlabelloc=\"t\";label=\"np=8\"\n\ta -- b\n}\n";
+    DotReader reader(filename);
+    Recorder r;
+    reader.read(r);
+    std::remove(filename);
+
+    CHECK_EQUAL(reader.get_attributes().size(), 2u);
+    CHECK_EQUAL(reader.get_attributes()[1].first, std::string("label"));
+    CHECK_EQUAL(reader.get_attributes()[1].second, std::string("np=8"));
+}
+
+TEST(dot_reader_stops_before_a_cut_statement)
+{
+    // a buffer that is not the last one ends in the middle of an edge
+    std::string text = "a -- b [label=1]\nc -- d [lab";
+    DotReader reader("test_dot_reader_missing.dot");
+    CHECK(!reader.is_open());
+
+    Recorder r;
+    const char* begin = text.data();
+    const char* stop = reader.parse(begin, begin + text.size(), r, false);
+    CHECK_EQUAL(r.edges.size(), 1u);
+    CHECK_EQUAL(std::string(stop), std::string("\nc -- d [lab"));
+
+    // the same text as the last buffer reads what it can
+    Recorder whole;
+    std::string complete = "a -- b [label=1]\nc -- d [label=2]\n";
+    CHECK(reader.parse(complete.data(), complete.data() + complete.size(), whole) == complete.data() + complete.size());
+    CHECK_EQUAL(whole.edges.size(), 2u);
+}
+
+TEST(dot_reader_reads_test_file)
+{
+    Recorder r;
+    DotReader reader("test.dot");
+    if (!reader.is_open())
+        return;
+    reader.read(r);
+    CHECK(r.edges.size() > 0);
+    CHECK_EQUAL(r.edges[0], std::string("Antoine Hilda 40"));
+}
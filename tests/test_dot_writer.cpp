@@ -0,0 +1,132 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#include "check.hpp"
+#include "dot_writer.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+std::string read_file(const std::string& name)
+{
+    std::ifstream in(name);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+DotWriter triangle()
+{
+    DotWriter writer;
+    writer.add_edge("a", "b", 1);
+    writer.add_edge(std::string("b"), std::string("c"), 2);
+    writer.add_edge('a', 'c', 5);
+    return writer;
+}
+
+}
+
+TEST(dot_writer_renders_the_save_graph_layout)
+{
+    DotWriter writer = triangle();
+    CHECK_EQUAL(writer.num_edges(), 3u);
+
+    EdgeOverlay overlay;
+    overlay.insert(1);
+    std::string text;
+    writer.render(text, &overlay, "label=\"t\"");
+    CHECK_EQUAL(text, std::string("graph { \nlabel=\"t\"\n"
+                                  "\ta -- b [label=1]\n"
+                                  "\tb -- c [label=2, penwidth=3, color=\"red\"]\n"
+                                  "\ta -- c [label=5]\n"
+                                  "}\n"));
+
+    text.clear();
+    writer.render(text, 0, "", "g");
+    CHECK(text.compare(0, 12, "graph \"g\" { ") == 0);
+    CHECK(text.find("penwidth") == std::string::npos);
+}
+
+TEST(dot_writer_highlighted_only)
+{
+    DotWriter writer = triangle();
+    writer.set_highlighted_only(true);
+
+    // overlay order and out of range indices do not matter
+    EdgeOverlay overlay;
+    overlay.insert(2);
+    overlay.insert(0);
+    overlay.insert(7);
+    std::string text;
+    writer.render(text, &overlay, "");
+    CHECK_EQUAL(text, std::string("graph { \n\n"
+                                  "\ta -- b [label=1, penwidth=3, color=\"red\"]\n"
+                                  "\ta -- c [label=5, penwidth=3, color=\"red\"]\n"
+                                  "}\n"));
+
+    text.clear();
+    writer.render(text, 0, "");
+    CHECK_EQUAL(text, std::string("graph { \n\n}\n"));
+}
+
+TEST(dot_writer_matches_save_graph)
+{
+    const char* SAVED = "dot_writer_saved.dot";
+    const char* WRITTEN = "dot_writer_written.dot";
+    StringGraph g = make_graph(false);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    StringGraph::Vertex* c = g.add_vertex("c");
+    g.add_edge(1, a, b);
+    g.add_edge(1, b, c);
+    g.add_edge(5, a, c);
+
+    EdgeOverlay path = g.shortest_path_iterator(a, c).overlay();
+    g.save_graph(SAVED, path, "label=\"p\"");
+    CHECK(g.dot_writer().write(WRITTEN, &path, "label=\"p\""));
+    CHECK_EQUAL(read_file(WRITTEN), read_file(SAVED));
+    std::remove(SAVED);
+    std::remove(WRITTEN);
+}
+
+TEST(dot_writer_many_outputs)
+{
+    DotWriter writer = triangle();
+    std::vector<EdgeOverlay> overlays(5);
+    std::vector<DotWriter::Output> outputs(overlays.size());
+    for (unsigned i = 0; i < outputs.size(); i++)
+    {
+        overlays[i].insert(i % 3);
+        outputs[i].filename = "dot_writer_" + std::to_string(i) + ".dot";
+        outputs[i].name = "g" + std::to_string(i);
+        outputs[i].overlay = &overlays[i];
+        outputs[i].label = "label=\"" + std::to_string(i) + "\"";
+    }
+
+    // each file is what a single write gives
+    CHECK(writer.write_all(outputs, 3));
+    std::string multi;
+    for (unsigned i = 0; i < outputs.size(); i++)
+    {
+        std::string single;
+        writer.render(single, outputs[i].overlay, outputs[i].label);
+        CHECK_EQUAL(read_file(outputs[i].filename), single);
+        std::remove(outputs[i].filename.c_str());
+        writer.render(multi, outputs[i].overlay, outputs[i].label, outputs[i].name);
+    }
+
+    const char* MULTI = "dot_writer_multi.dot";
+    CHECK(writer.write_multi(MULTI, outputs));
+    CHECK_EQUAL(read_file(MULTI), multi);
+    std::remove(MULTI);
+
+    // a file that cannot be opened is reported
+    outputs[0].filename = "no_such_directory/out.dot";
+    CHECK(!writer.write_all(outputs, 2));
+    for (unsigned i = 1; i < outputs.size(); i++)
+        std::remove(outputs[i].filename.c_str());
+}
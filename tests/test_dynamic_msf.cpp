@@ -0,0 +1,106 @@
+#include <vector>
+#include <string>
+
+#include "check.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+typedef DynamicSpanningForest<StringGraph> DynamicForest;
+
+unsigned long next_random(unsigned long& state, unsigned n)
+{
+    state = state * 6364136223846793005ul + 1442695040888963407ul;
+    return (state >> 33) % n;
+}
+
+void check_against_kruskal(const StringGraph& g, const DynamicForest& forest)
+{
+    unsigned count = 0;
+    long weight = 0;
+    for (auto it = g.min_spanning_tree_iterator(StringGraph::KRUSKAL); it.has_next(); it.next())
+    {
+        count++;
+        weight += it.current()->get_weight();
+    }
+    CHECK_EQUAL(forest.size(), count);
+    CHECK_EQUAL((long) forest.get_weight(), weight);
+
+    // the kept edges are in the graph and make a forest
+    DisjointSet sets(g.num_vertices());
+    for (unsigned i = 0; i < forest.edges().size(); i++)
+    {
+        StringGraph::Edge* e = forest.edges()[i];
+        CHECK(g.get_edge(e->get_index()) == e);
+        CHECK(forest.contains(e));
+        CHECK(sets.unite(e->get_source()->get_index(), e->get_destination()->get_index()));
+    }
+}
+
+}
+
+TEST(dynamic_msf_under_random_updates)
+{
+    // directions are ignored, so a directed graph has the same forest
+    for (int directed = 0; directed < 2; directed++)
+    {
+        StringGraph g = make_graph(directed);
+        unsigned long state = 13 + directed;
+        for (unsigned v = 0; v < 80; v++)
+            g.add_vertex(std::to_string(v));
+        for (unsigned e = 0; e < 120; e++)
+            g.add_edge(1 + next_random(state, 30), g.get_vertex(next_random(state, 80)), g.get_vertex(next_random(state, 80)));
+
+        DynamicForest forest(g);
+        check_against_kruskal(g, forest);
+        for (unsigned u = 0; u < 800; u++)
+        {
+            unsigned kind = next_random(state, 4);
+            if (kind == 0 || g.num_edges() == 0)
+                g.add_edge(1 + next_random(state, 30), g.get_vertex(next_random(state, g.num_vertices())), g.get_vertex(next_random(state, g.num_vertices())));
+            else if (kind == 1)
+                g.remove_edge(g.get_edge(next_random(state, g.num_edges())));
+            else if (kind == 2)
+                g.get_edge(next_random(state, g.num_edges()))->set_weight(1 + next_random(state, 30));
+            else
+                g.add_vertex("new" + std::to_string(u));
+
+            if (u % 50 == 49)
+                check_against_kruskal(g, forest);
+        }
+        check_against_kruskal(g, forest);
+        g.remove_listener(&forest);
+    }
+}
+
+TEST(dynamic_msf_replacement_edge)
+{
+    StringGraph g = make_graph(false);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    StringGraph::Vertex* c = g.add_vertex("c");
+    StringGraph::Vertex* d = g.add_vertex("d");
+    StringGraph::Edge* ab = g.add_edge(1, a, b);
+    StringGraph::Edge* bc = g.add_edge(2, b, c);
+    StringGraph::Edge* ac = g.add_edge(9, a, c);
+
+    DynamicForest forest(g);
+    CHECK_EQUAL(forest.get_weight(), 3);
+    CHECK(!forest.contains(ac));
+    CHECK(!forest.is_connected(a, d));
+
+    // cutting a tree edge brings in the lightest edge across
+    g.remove_edge(bc);
+    CHECK(forest.contains(ac));
+    CHECK_EQUAL(forest.get_weight(), 10);
+
+    // a heavier tree edge gives way to a lighter one closing a cycle
+    ab->set_weight(20);
+    StringGraph::Edge* bc2 = g.add_edge(3, b, c);
+    CHECK(forest.contains(bc2));
+    CHECK(!forest.contains(ab));
+    CHECK_EQUAL(forest.get_weight(), 12);
+    CHECK(forest.overlay().contains(bc2->get_index()));
+    g.remove_listener(&forest);
+}
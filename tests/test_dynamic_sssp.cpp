@@ -0,0 +1,118 @@
+#include <vector>
+#include <string>
+
+#include "check.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+typedef DynamicShortestPathTree<StringGraph> DynamicTree;
+
+unsigned long next_random(unsigned long& state, unsigned n)
+{
+    state = state * 6364136223846793005ul + 1442695040888963407ul;
+    return (state >> 33) % n;
+}
+
+// the kept tree against a tree grown from scratch on the current graph
+void check_against_scratch(StringGraph& g, const DynamicTree& tree)
+{
+    DynamicTree scratch(g, tree.get_root());
+    for (unsigned v = 0; v < g.num_vertices(); v++)
+    {
+        StringGraph::Vertex* vertex = g.get_vertex(v);
+        CHECK_EQUAL(tree.is_reachable(vertex), scratch.is_reachable(vertex));
+        if (!scratch.is_reachable(vertex))
+            continue;
+        CHECK_EQUAL(tree.get_distance(vertex), scratch.get_distance(vertex));
+
+        // the parent edges are in the graph and add up to the distance
+        int along = 0;
+        std::vector<StringGraph::Edge*> path = tree.path(vertex);
+        for (unsigned i = 0; i < path.size(); i++)
+        {
+            CHECK(g.get_edge(path[i]->get_index()) == path[i]);
+            along += path[i]->get_weight();
+        }
+        CHECK_EQUAL(along, tree.get_distance(vertex));
+    }
+}
+
+}
+
+TEST(dynamic_sssp_under_random_updates)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        StringGraph g = make_graph(directed);
+        unsigned long state = 4 + directed;
+        for (unsigned v = 0; v < 60; v++)
+            g.add_vertex(std::to_string(v));
+        for (unsigned e = 0; e < 150; e++)
+            g.add_edge(1 + next_random(state, 20), g.get_vertex(next_random(state, 60)), g.get_vertex(next_random(state, 60)));
+
+        DynamicTree tree(g, g.get_vertex(0));
+        for (unsigned u = 0; u < 600; u++)
+        {
+            unsigned kind = next_random(state, 4);
+            if (kind == 0 || g.num_edges() == 0)
+                g.add_edge(1 + next_random(state, 20), g.get_vertex(next_random(state, g.num_vertices())), g.get_vertex(next_random(state, g.num_vertices())));
+            else if (kind == 1)
+                g.remove_edge(g.get_edge(next_random(state, g.num_edges())));
+            else if (kind == 2)
+                g.get_edge(next_random(state, g.num_edges()))->set_weight(1 + next_random(state, 20));
+            else
+                g.add_vertex("new" + std::to_string(u));
+
+            if (u % 40 == 39)
+                check_against_scratch(g, tree);
+        }
+        check_against_scratch(g, tree);
+    }
+}
+
+TEST(dynamic_sssp_removed_edge_index)
+{
+    StringGraph g = make_graph(false);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    StringGraph::Vertex* c = g.add_vertex("c");
+    StringGraph::Edge* ab = g.add_edge(1, a, b);
+    g.add_edge(5, a, c);
+    StringGraph::Edge* bc = g.add_edge(1, b, c);
+
+    DynamicTree tree(g, a);
+    CHECK_EQUAL(tree.get_distance(c), 2);
+
+    // the last edge takes the removed one's index
+    g.remove_edge(ab);
+    CHECK_EQUAL(g.num_edges(), 2u);
+    CHECK(g.get_edge(0) == bc);
+    CHECK_EQUAL(bc->get_index(), 0u);
+    CHECK_EQUAL(tree.get_distance(c), 5);
+    CHECK_EQUAL(tree.get_distance(b), 6);
+    CHECK_EQUAL(a->get_degree(), 1u);
+}
+
+TEST(dynamic_sssp_listener_lifetimes)
+{
+    StringGraph g = make_graph(true);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    {
+        // destroyed first, it unregisters itself
+        DynamicTree early(g, a);
+    }
+    DynamicTree tree(g, a);
+    g.add_edge(3, a, b);
+    CHECK(tree.is_reachable(b));
+
+    // a graph destroyed first lets its listeners go
+    DynamicTree* orphan;
+    {
+        StringGraph h = make_graph(true);
+        orphan = new DynamicTree(h, h.add_vertex("x"));
+    }
+    delete orphan;
+}
@@ -0,0 +1,78 @@
+#include <cstdio>
+
+#include "check.hpp"
+#include "generator.hpp"
+#include "dot_reader.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+struct Counter
+{
+    unsigned vertices;
+    unsigned edges;
+    void vertex(const char*, size_t) { vertices++; }
+    void edge(const char*, size_t, const char*, size_t, double) { edges++; }
+};
+
+}
+
+TEST(generator_is_seeded)
+{
+    GeneratedGraph a = GraphGenerator(5, 3, 9).random(100, 400);
+    GeneratedGraph b = GraphGenerator(5, 3, 9).random(100, 400);
+    GeneratedGraph c = GraphGenerator(6, 3, 9).random(100, 400);
+    CHECK(a.sources == b.sources && a.destinations == b.destinations && a.weights == b.weights);
+    CHECK(a.sources != c.sources || a.destinations != c.destinations);
+
+    CHECK_EQUAL(a.num_edges(), 400u);
+    for (unsigned i = 0; i < a.num_edges(); i++)
+    {
+        CHECK(a.sources[i] != a.destinations[i]);
+        CHECK(a.destinations[i] < 100);
+        CHECK(a.weights[i] >= 3 && a.weights[i] <= 9);
+    }
+}
+
+TEST(generator_shapes)
+{
+    GraphGenerator generator(1);
+    GeneratedGraph grid = generator.grid(4, 5);
+    CHECK_EQUAL(grid.nvertices, 20u);
+    CHECK_EQUAL(grid.num_edges(), 4u * 4 + 3u * 5);
+
+    GeneratedGraph dense = generator.dense(7);
+    CHECK_EQUAL(dense.num_edges(), 21u);
+    GeneratedGraph both = GraphGenerator(1, 1, 100, true).dense(7);
+    CHECK_EQUAL(both.num_edges(), 42u);
+
+    // the size of an rmat graph is a scale
+    GeneratedGraph rmat = generator.rmat(10, 4);
+    CHECK_EQUAL(rmat.nvertices, 1024u);
+    CHECK(rmat.num_edges() <= 4096u);
+    for (unsigned i = 0; i < rmat.num_edges(); i++)
+        CHECK(rmat.sources[i] != rmat.destinations[i] && rmat.sources[i] < 1024 && rmat.destinations[i] < 1024);
+}
+
+TEST(generator_dot_and_build)
+{
+    const char* FILENAME = "generator_test.dot";
+    GeneratedGraph g = GraphGenerator(2, 1, 50, true).random(30, 70);
+    CHECK(g.write_dot(FILENAME));
+
+    DotReader reader(FILENAME);
+    Counter counter = { 0, 0 };
+    reader.read(counter);
+    CHECK(reader.is_directed());
+    CHECK_EQUAL(counter.vertices, 30u);
+    CHECK_EQUAL(counter.edges, 70u);
+    std::remove(FILENAME);
+
+    StringGraph built = make_graph(true);
+    g.build(built, GeneratedGraph::vertex_name);
+    CHECK_EQUAL(built.num_vertices(), 30u);
+    CHECK_EQUAL(built.num_edges(), 70u);
+    CHECK(built.get_edge(3)->get_weight() == g.weights[3]);
+    CHECK(built.get_edge(3)->get_source()->get_value() == GeneratedGraph::vertex_name(g.sources[3]));
+}
@@ -0,0 +1,168 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+#include "check.hpp"
+#include "graph_snapshot.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+const char* FILENAME = "test_graph_snapshot.bin";
+
+CompactGraph<int> sample(bool directed)
+{
+    std::vector<unsigned> src = { 0, 1, 2, 3, 0 };
+    std::vector<unsigned> dst = { 1, 2, 3, 0, 2 };
+    std::vector<int> w = { 4, 1, 2, 3, 5 };
+    return CompactGraph<int>(directed, 5, src, dst, w);
+}
+
+std::vector<char> file_bytes()
+{
+    std::ifstream file(FILENAME, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void write_bytes(const std::vector<char>& bytes)
+{
+    std::ofstream(FILENAME, std::ios::binary).write(bytes.data(), bytes.size());
+}
+
+// the section table follows magic, five 32-bit fields, the counts and the size
+uint64_t section_start(const std::vector<char>& bytes, unsigned section)
+{
+    uint64_t start;
+    std::memcpy(&start, &bytes[8 + 6 * 4 + 8 + section * 8], 8);
+    return start;
+}
+
+template<class T>
+void patch(std::vector<char>& bytes, unsigned section, unsigned i, T value)
+{
+    std::memcpy(&bytes[section_start(bytes, section) + i * sizeof(T)], &value, sizeof(T));
+}
+
+}
+
+TEST(graph_snapshot_round_trip)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        CompactGraph<int> g = sample(directed);
+        std::vector<std::string> labels = { "delta", "alpha", "", "charlie", "bravo" };
+        CHECK(GraphSnapshot<int>::write(FILENAME, g, labels));
+
+        GraphSnapshot<int> snapshot(FILENAME);
+        CHECK(snapshot.is_open());
+        const CompactGraph<int>& s = snapshot.get_graph();
+        CHECK_EQUAL(s.is_directed(), (bool) directed);
+        CHECK_EQUAL(s.num_vertices(), g.num_vertices());
+        CHECK_EQUAL(s.num_edges(), g.num_edges());
+        CHECK_EQUAL(s.num_arcs(), g.num_arcs());
+        for (unsigned v = 0; v < g.num_vertices(); v++)
+        {
+            CHECK_EQUAL(s.begin(v), g.begin(v));
+            CHECK_EQUAL(s.end(v), g.end(v));
+            CHECK_EQUAL(snapshot.get_name(v), labels[v]);
+            CHECK_EQUAL(snapshot.find_vertex(labels[v]), v);
+        }
+        for (unsigned a = 0; a < g.num_arcs(); a++)
+        {
+            CHECK_EQUAL(s.target(a), g.target(a));
+            CHECK_EQUAL(s.edge(a), g.edge(a));
+            CHECK_EQUAL(s.weight(a), g.weight(a));
+        }
+        for (unsigned e = 0; e < g.num_edges(); e++)
+        {
+            CHECK_EQUAL(s.edge_source(e), g.edge_source(e));
+            CHECK_EQUAL(s.edge_destination(e), g.edge_destination(e));
+            CHECK_EQUAL(s.edge_weight(e), g.edge_weight(e));
+        }
+        CHECK_EQUAL(snapshot.find_vertex("zulu"), CompactGraph<int>::NONE);
+        CHECK_EQUAL(s.min_spanning_tree().size(), g.min_spanning_tree().size());
+    }
+    std::remove(FILENAME);
+}
+
+TEST(graph_snapshot_rejects_bad_files)
+{
+    std::vector<std::string> labels = { "a", "b", "c", "d", "e" };
+    CHECK(GraphSnapshot<int>::write(FILENAME, sample(false), labels));
+    std::vector<char> good = file_bytes();
+
+    // wrong weight type
+    {
+        GraphSnapshot<double> snapshot(FILENAME);
+        CHECK(!snapshot.is_open());
+    }
+
+    std::vector<char> bad = good;
+    bad[0] = 'X';
+    write_bytes(bad);
+    CHECK(!GraphSnapshot<int>(FILENAME).is_open());
+
+    bad = good;
+    bad.resize(bad.size() - 64);
+    write_bytes(bad);
+    CHECK(!GraphSnapshot<int>(FILENAME).is_open());
+
+    write_bytes(std::vector<char>(good.begin(), good.begin() + 16));
+    CHECK(!GraphSnapshot<int>(FILENAME).is_open());
+
+    CHECK(!GraphSnapshot<int>("test_graph_snapshot_missing.bin").is_open());
+
+    // too few labels for the vertices
+    CHECK(!GraphSnapshot<int>::write(FILENAME, sample(false), std::vector<std::string>(2)));
+    std::remove(FILENAME);
+}
+
+TEST(graph_snapshot_of_a_graph)
+{
+    StringGraph g = make_graph(false);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    g.add_edge(3, a, b);
+    CHECK(g.save_snapshot(FILENAME));
+
+    GraphSnapshot<int> snapshot(FILENAME);
+    CHECK(snapshot.is_open());
+    CHECK_EQUAL(snapshot.find_vertex("b"), 1u);
+    CHECK_EQUAL(snapshot.get_graph().edge_weight(0), 3);
+    std::remove(FILENAME);
+}
+
+TEST(graph_snapshot_rejects_bad_contents)
+{
+    enum { OFFSETS, TARGETS, ARC_EDGES, WEIGHTS, SOURCES, DESTINATIONS, EDGE_WEIGHTS, NAME_OFFSETS, NAMES, NAME_ORDER };
+    std::vector<std::string> labels = { "a", "b", "c", "d", "e" };
+    CHECK(GraphSnapshot<int>::write(FILENAME, sample(false), labels));
+    std::vector<char> good = file_bytes();
+    CHECK(GraphSnapshot<int>(FILENAME).is_open());
+
+    // each corruption is in bounds of its section but not of what it indexes
+    std::vector<std::vector<char> > corrupt(9, good);
+    patch<unsigned>(corrupt[0], OFFSETS, 2, 9);
+    patch<unsigned>(corrupt[1], TARGETS, 0, 5);
+    patch<unsigned>(corrupt[2], ARC_EDGES, 3, 5);
+    patch<unsigned>(corrupt[3], SOURCES, 1, 99);
+    patch<unsigned>(corrupt[4], DESTINATIONS, 4, 5);
+    patch<uint64_t>(corrupt[5], NAME_OFFSETS, 1, 1000);
+    patch<uint64_t>(corrupt[6], NAME_OFFSETS, 5, 1000);
+    patch<uint32_t>(corrupt[7], NAME_ORDER, 0, 7);
+    // a section that is not aligned
+    uint64_t shifted = section_start(good, TARGETS) + 4;
+    std::memcpy(&corrupt[8][8 + 6 * 4 + 8 + TARGETS * 8], &shifted, 8);
+
+    for (unsigned i = 0; i < corrupt.size(); i++)
+    {
+        write_bytes(corrupt[i]);
+        CHECK(!GraphSnapshot<int>(FILENAME).is_open());
+    }
+    std::remove(FILENAME);
+}
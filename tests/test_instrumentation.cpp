@@ -0,0 +1,71 @@
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#include "check.hpp"
+#include "instrumentation.hpp"
+#include "edge_lists.hpp"
+
+TEST(instrumentation_records)
+{
+    QueryStats a;
+    a.queue_pushes = 3;
+    a.settled = 2;
+    a.compute_ms = 1.5;
+    QueryStats b = a;
+    b += a;
+    CHECK_EQUAL(b.queue_pushes, 6ul);
+    CHECK_EQUAL(b.settled, 4ul);
+    CHECK(b.json().find("\"queue_pushes\":6") != std::string::npos);
+    CHECK(b.json().find("\"compute_ms\":3") != std::string::npos);
+    CHECK(b.csv().find("6,0,0,0,0,4,0,") == 0);
+    b.clear();
+    CHECK_EQUAL(b.queue_pushes, 0ul);
+
+    const char* FILENAME = "instrumentation_test.csv";
+    StatsLog log;
+    log.record("one", a);
+    log.record("two", a);
+    CHECK_EQUAL(log.total().settled, 4ul);
+    CHECK(log.write_csv(FILENAME));
+    std::ifstream in(FILENAME);
+    std::stringstream text;
+    text << in.rdbuf();
+    CHECK(text.str().find("name," + QueryStats::csv_header()) == 0);
+    CHECK(text.str().find("\ntotal,6,0,0,0,0,4,") != std::string::npos);
+    std::remove(FILENAME);
+}
+
+TEST(instrumentation_phase_timer)
+{
+    thread_query_stats().clear();
+    {
+        PhaseTimer outer(&QueryStats::compute_ms);
+        PhaseTimer inner(&QueryStats::path_ms, &QueryStats::compute_ms);
+        volatile unsigned spin = 0;
+        for (unsigned i = 0; i < 1000000; i++)
+            spin = spin + i;
+    }
+    // the nested phase is taken out of the outer one
+    CHECK(thread_query_stats().path_ms > 0);
+    CHECK(thread_query_stats().compute_ms >= 0);
+}
+
+TEST(instrumentation_engine_counters)
+{
+    EdgeList list = random_edges(50, 150, 3);
+    CompactGraph<int> g = list.freeze(false);
+    thread_query_stats().clear();
+    g.shortest_path_tree(0, int_weights());
+    const QueryStats& stats = thread_query_stats();
+#ifdef ALGO_STATS
+    CHECK(stats.settled > 0);
+    CHECK(stats.queue_pushes >= stats.settled);
+    CHECK(stats.relaxations > 0);
+#else
+    // compiled out: the engines leave the record alone
+    CHECK_EQUAL(stats.settled, 0ul);
+    CHECK_EQUAL(stats.queue_pushes, 0ul);
+#endif
+}
@@ -0,0 +1,72 @@
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+#include "label_index.hpp"
+
+namespace
+{
+
+struct Labels
+{
+    const std::vector<std::string>* values;
+    const std::string& operator()(unsigned i) const { return (*values)[i]; }
+};
+
+// every label hashes alike, so lookups go through the probing alone
+struct Collide
+{
+    size_t operator()(const std::string&) const { return 7; }
+};
+
+}
+
+TEST(label_index_find_and_insert)
+{
+    std::vector<std::string> values;
+    Labels labels = { &values };
+    LabelIndex<std::string> index;
+    CHECK(index.find("a", labels) == index.NONE);
+
+    for (unsigned i = 0; i < 1000; i++)
+    {
+        values.push_back("label" + std::to_string(i % 700));
+        index.insert(i, labels);
+    }
+
+    // repeated labels keep their first index
+    CHECK_EQUAL(index.size(), 700u);
+    for (unsigned i = 0; i < 700; i++)
+        CHECK_EQUAL(index.find("label" + std::to_string(i), labels), i);
+    CHECK(!index.insert(900, labels));
+    CHECK(index.find("label700", labels) == index.NONE);
+    CHECK(index.memory_usage() >= 700 * 2 * sizeof(unsigned));
+
+    index.clear();
+    CHECK_EQUAL(index.size(), 0u);
+    CHECK(index.find("label1", labels) == index.NONE);
+}
+
+TEST(label_index_collisions)
+{
+    std::vector<std::string> values;
+    Labels labels = { &values };
+    LabelIndex<std::string, Collide> index;
+    index.reserve(40);
+    for (unsigned i = 0; i < 40; i++)
+    {
+        values.push_back(std::string(i, 'x'));
+        CHECK(index.insert(i, labels));
+    }
+    for (unsigned i = 0; i < 40; i++)
+        CHECK_EQUAL(index.find(std::string(i, 'x'), labels), i);
+    CHECK(index.find("y", labels) == index.NONE);
+}
+
+TEST(label_index_heap_bytes)
+{
+    CHECK_EQUAL(label_heap_bytes(42), (size_t) 0);
+    CHECK_EQUAL(label_heap_bytes(std::string("a")), (size_t) 0);
+    std::string longer(100, 'a');
+    CHECK(label_heap_bytes(longer) > 100);
+}
@@ -0,0 +1,113 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstdio>
+
+#include "check.hpp"
+#include "overlay.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+std::string read_file(const char* name)
+{
+    std::ifstream in(name);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+// shortest path lengths over every pair, as a const reader sees them
+std::vector<int> all_path_lengths(const StringGraph& g)
+{
+    std::vector<int> lengths;
+    for (unsigned s = 0; s < g.num_vertices(); s++)
+    {
+        for (unsigned t = 0; t < g.num_vertices(); t++)
+        {
+            int total = 0;
+            auto it = g.shortest_path_iterator(g.get_vertex(s), g.get_vertex(t));
+            for (; it.has_next(); it.next())
+                total += it.current()->get_weight();
+            lengths.push_back(total);
+        }
+    }
+    return lengths;
+}
+
+}
+
+TEST(overlay_membership)
+{
+    std::vector<unsigned> path;
+    path.push_back(3);
+    path.push_back(~0u);
+    path.push_back(200);
+    path.push_back(3);
+    EdgeOverlay overlay(path);
+    CHECK_EQUAL(overlay.size(), 2u);
+    CHECK(overlay.contains(3));
+    CHECK(overlay.contains(200));
+    CHECK(!overlay.contains(4));
+    CHECK(!overlay.contains(100000));
+    CHECK(!overlay.insert(200));
+    CHECK(overlay.insert(0));
+    CHECK_EQUAL(overlay.edges()[2], 0u);
+
+    overlay.clear();
+    CHECK(overlay.empty());
+    CHECK(!overlay.contains(3));
+    CHECK(overlay.insert(3));
+}
+
+TEST(overlay_rendered_without_marking_edges)
+{
+    const char* FILENAME = "overlay_test.dot";
+    StringGraph g = make_graph(false);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    StringGraph::Vertex* c = g.add_vertex("c");
+    g.add_edge(1, a, b);
+    g.add_edge(1, b, c);
+    g.add_edge(5, a, c);
+
+    g.save_graph(FILENAME, g.shortest_path_iterator(a, c).overlay(), "label=\"p\"");
+    std::string text = read_file(FILENAME);
+    CHECK(text.find("a -- b [label=1, penwidth=3") != std::string::npos);
+    CHECK(text.find("b -- c [label=1, penwidth=3") != std::string::npos);
+    CHECK(text.find("a -- c [label=5]") != std::string::npos);
+    CHECK(text.find("label=\"p\"") != std::string::npos);
+
+    // the plain form shows no highlight, since no edge was marked
+    g.save_graph(FILENAME);
+    CHECK(read_file(FILENAME).find("penwidth") == std::string::npos);
+    std::remove(FILENAME);
+}
+
+TEST(overlay_concurrent_const_queries)
+{
+    StringGraph g = make_graph(true);
+    std::vector<StringGraph::Vertex*> v;
+    for (unsigned i = 0; i < 30; i++)
+        v.push_back(g.add_vertex(std::to_string(i)));
+    unsigned long state = 8;
+    for (unsigned i = 0; i < 90; i++)
+    {
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+        g.add_edge(1 + (state >> 60), v[(state >> 33) % 30], v[(state >> 45) % 30]);
+    }
+
+    // readers that race to freeze the graph and fill its caches agree
+    const StringGraph& shared = g;
+    std::vector<std::vector<int> > results(4);
+    std::vector<std::thread> readers;
+    for (unsigned t = 0; t < results.size(); t++)
+        readers.push_back(std::thread([&shared, &results, t]() { results[t] = all_path_lengths(shared); }));
+    for (unsigned t = 0; t < readers.size(); t++)
+        readers[t].join();
+    for (unsigned t = 1; t < results.size(); t++)
+        CHECK(results[t] == results[0]);
+}
@@ -0,0 +1,44 @@
+#include <vector>
+#include <functional>
+
+#include "check.hpp"
+#include "parallel.hpp"
+
+TEST(parallel_for_covers_the_range_once)
+{
+    unsigned sizes[] = { 0, 1, 3, 100, 1001 };
+    for (unsigned s = 0; s < 5; s++)
+    {
+        for (unsigned threads = 1; threads <= 8; threads *= 2)
+        {
+            std::vector<unsigned> hits(sizes[s] + 10, 0);
+            parallel_for(10, 10 + sizes[s], threads, [&](unsigned lo, unsigned hi, unsigned) {
+                for (unsigned i = lo; i < hi; i++)
+                    hits[i]++;
+            });
+            for (unsigned i = 0; i < hits.size(); i++)
+                CHECK_EQUAL(hits[i], i < 10 ? 0u : 1u);
+        }
+    }
+}
+
+TEST(parallel_sort_matches_std_sort)
+{
+    // above the serial cutoff, with an odd number of runs to merge
+    std::vector<unsigned> data(200000);
+    unsigned long state = 5;
+    for (unsigned i = 0; i < data.size(); i++)
+    {
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+        data[i] = state >> 40;
+    }
+    std::vector<unsigned> expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    for (unsigned threads = 1; threads <= 5; threads += 2)
+    {
+        std::vector<unsigned> sorted = data;
+        parallel_sort(sorted, std::less<unsigned>(), threads);
+        CHECK(sorted == expected);
+    }
+}
@@ -0,0 +1,76 @@
+#include <vector>
+
+#include "check.hpp"
+#include "edge_lists.hpp"
+#include "fixtures.hpp"
+#include "parallel_bfs.hpp"
+
+namespace
+{
+
+void check_tree(const CompactGraph<int>& g, const BreadthFirstTree& tree, unsigned source)
+{
+    const unsigned NONE = CompactGraph<int>::NONE;
+    std::vector<int> hops = hops_from(g, source);
+    for (unsigned v = 0; v < g.num_vertices(); v++)
+    {
+        CHECK_EQUAL((int) tree.depth[v], hops[v] < 0 ? (int) NONE : hops[v]);
+        if (v == source || hops[v] < 0)
+        {
+            CHECK_EQUAL(tree.parent[v], NONE);
+            continue;
+        }
+        // the parent edge is an arc from the previous level
+        unsigned e = tree.parent[v];
+        unsigned u = g.opposite(e, v);
+        CHECK_EQUAL(g.edge_destination(e, u), v);
+        CHECK_EQUAL(tree.depth[u] + 1, tree.depth[v]);
+    }
+
+    std::vector<unsigned> order = tree.order();
+    for (unsigned i = 1; i < order.size(); i++)
+        CHECK(tree.depth[order[i - 1]] <= tree.depth[order[i]]);
+}
+
+}
+
+TEST(parallel_bfs_depths_and_parents)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        // sparse graphs stay top-down, dense ones switch to bottom-up steps
+        for (unsigned degree = 2; degree <= 32; degree *= 4)
+        {
+            EdgeList list = random_edges(1000, 1000 * degree, degree + directed);
+            CompactGraph<int> g = list.freeze(directed);
+            CompactGraph<int> reverse = g.reversed();
+            for (unsigned threads = 1; threads <= 4; threads += 3)
+            {
+                for (unsigned source = 0; source < list.n; source += 333)
+                    check_tree(g, ParallelBfsBuilder<int>(&g, &reverse, threads).run(source), source);
+            }
+        }
+    }
+}
+
+TEST(parallel_bfs_level_order_iterator)
+{
+    StringGraph g = make_graph(false);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    StringGraph::Vertex* c = g.add_vertex("c");
+    g.add_vertex("d");
+    g.add_edge(1, b, c);
+    g.add_edge(1, c, a);
+
+    auto it = g.parallel_breadth_first_iterator(b, 2);
+    CHECK(it.current() == b);
+    CHECK_EQUAL(it.depth(), 0u);
+    it.next();
+    CHECK(it.current() == c);
+    it.next();
+    CHECK(it.current() == a);
+    CHECK_EQUAL(it.depth(), 2u);
+    it.next();
+    CHECK(!it.has_next());
+}
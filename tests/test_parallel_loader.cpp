@@ -0,0 +1,179 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <cstdio>
+
+#include "check.hpp"
+#include "parallel_loader.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+// the sequential load, numbering vertices as they first appear
+struct SequentialLoader
+{
+    StringGraph* g;
+
+    StringGraph::Vertex* get_vertex(const char* data, size_t size)
+    {
+        std::string name(data, size);
+        StringGraph::Vertex* vertex = g->get_vertex_data(name);
+        return vertex ? vertex : g->add_vertex(name);
+    }
+
+    void vertex(const char* data, size_t size) { get_vertex(data, size); }
+
+    void edge(const char* src, size_t srclen, const char* dst, size_t dstlen, double weight)
+    {
+        StringGraph::Vertex* source = get_vertex(src, srclen);
+        g->add_edge((int) weight, source, get_vertex(dst, dstlen));
+    }
+};
+
+void write_edge_list(const char* filename, bool directed, unsigned lines, unsigned long seed)
+{
+    std::ofstream out(filename);
+    out << (directed ? "digraph {\n" : "graph {\n") << "\tlabel=\"list\"\n";
+    const char* arrow = directed ? " -> " : " -- ";
+    for (unsigned i = 0; i < lines; i++)
+    {
+        seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+        unsigned s = (seed >> 33) % 300;
+        unsigned d = (seed >> 45) % 300;
+        // runs of one source, as edge lists have, and a few lone vertices
+        if (i % 37 == 0)
+            out << "\tlone" << i << "\n";
+        out << "\tv" << s / 4 << arrow << "v" << d << " [label=" << 1 + (seed >> 55) % 90 << "]\n";
+    }
+    out << "}\n";
+}
+
+bool same_graph(const StringGraph& a, const StringGraph& b)
+{
+    if (a.num_vertices() != b.num_vertices() || a.num_edges() != b.num_edges() || a.is_directed() != b.is_directed())
+        return false;
+    for (unsigned v = 0; v < a.num_vertices(); v++)
+    {
+        if (a.get_vertex(v)->get_value() != b.get_vertex(v)->get_value()
+                || a.get_vertex(v)->get_degree() != b.get_vertex(v)->get_degree())
+            return false;
+    }
+    for (unsigned e = 0; e < a.num_edges(); e++)
+    {
+        const StringGraph::Edge* x = a.get_edge(e);
+        const StringGraph::Edge* y = b.get_edge(e);
+        if (x->get_weight() != y->get_weight() || x->get_source()->get_index() != y->get_source()->get_index()
+                || x->get_destination()->get_index() != y->get_destination()->get_index())
+            return false;
+    }
+    return true;
+}
+
+}
+
+TEST(parallel_loader_numbers_like_a_sequential_load)
+{
+    const char* FILENAME = "parallel_loader_test.dot";
+    for (int directed = 0; directed < 2; directed++)
+    {
+        write_edge_list(FILENAME, directed, 2000, 5 + directed);
+
+        StringGraph expected = make_graph(directed);
+        expected.set_vertex_index(true);
+        SequentialLoader loader = { &expected };
+        DotReader reader(FILENAME);
+        reader.read(loader);
+
+        unsigned threads[] = { 1, 2, 3, 8 };
+        for (unsigned t = 0; t < 4; t++)
+        {
+            ParallelDotLoader parallel(FILENAME, threads[t]);
+            CHECK(parallel.is_open());
+            CHECK_EQUAL(parallel.is_directed(), (bool) directed);
+            CHECK_EQUAL(parallel.get_attributes().size(), 1u);
+
+            StringGraph g = make_graph(parallel.is_directed());
+            parallel.build(g);
+            CHECK(same_graph(g, expected));
+        }
+    }
+
+    // more chunks than lines
+    std::ofstream(FILENAME) << "graph {\na -- b\n}\n";
+    ParallelDotLoader tiny(FILENAME, 16);
+    CHECK_EQUAL(tiny.get_names().size(), 2u);
+    CHECK_EQUAL(tiny.get_sources().size(), 1u);
+    std::remove(FILENAME);
+
+    ParallelDotLoader missing("no_such_file.dot");
+    CHECK(!missing.is_open());
+    CHECK_EQUAL(missing.get_names().size(), 0u);
+}
+
+TEST(parallel_loader_name_table)
+{
+    NameTable table;
+    std::vector<std::string> names;
+    for (unsigned i = 0; i < 3000; i++)
+        names.push_back("n" + std::to_string(i));
+
+    // every thread interns every name, each at its own positions
+    std::vector<std::vector<unsigned> > ids(4, std::vector<unsigned>(names.size()));
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < ids.size(); t++)
+    {
+        threads.push_back(std::thread([&, t]() {
+            for (unsigned i = 0; i < names.size(); i++)
+                ids[t][i] = table.intern(names[i].data(), names[i].size(), (uint64_t) (t + 1) << 32 | i);
+        }));
+    }
+    for (unsigned t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    CHECK_EQUAL(table.size(), (unsigned) names.size());
+    for (unsigned i = 0; i < names.size(); i++)
+    {
+        for (unsigned t = 1; t < ids.size(); t++)
+            CHECK_EQUAL(ids[t][i], ids[0][i]);
+        NameTable::Entry& e = table.entry(ids[0][i]);
+        CHECK_EQUAL(std::string(e.data, e.size), names[i]);
+        CHECK_EQUAL(e.first, ((uint64_t) 1 << 32) | i);
+    }
+}
+
+TEST(parallel_loader_add_edges)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        StringGraph bulk = make_graph(directed);
+        StringGraph single = make_graph(directed);
+        for (unsigned v = 0; v < 20; v++)
+        {
+            bulk.add_vertex(std::to_string(v));
+            single.add_vertex(std::to_string(v));
+        }
+        single.add_edge(7, single.get_vertex(0), single.get_vertex(1));
+        bulk.add_edge(7, bulk.get_vertex(0), bulk.get_vertex(1));
+
+        std::vector<unsigned> src, dst;
+        std::vector<int> w;
+        for (unsigned i = 0; i < 60; i++)
+        {
+            src.push_back(i * 7 % 20);
+            dst.push_back(i * 11 % 20);
+            w.push_back(1 + i % 9);
+            single.add_edge(w.back(), single.get_vertex(src.back()), single.get_vertex(dst.back()));
+        }
+        CHECK(bulk.add_edges(src, dst, w));
+        CHECK(same_graph(bulk, single));
+
+        // nothing is added from bad arrays
+        dst.back() = 20;
+        CHECK(!bulk.add_edges(src, dst, w));
+        w.pop_back();
+        CHECK(!bulk.add_edges(src, dst, w));
+        CHECK_EQUAL(bulk.num_edges(), 61u);
+    }
+}
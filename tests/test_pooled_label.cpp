@@ -0,0 +1,158 @@
+#include <string>
+#include <vector>
+#include <thread>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <unordered_set>
+
+#include "check.hpp"
+#include "graph.hpp"
+#include "parallel_loader.hpp"
+
+namespace
+{
+
+typedef Graph<PooledLabel, int> LabelGraph;
+typedef Graph<std::string, int> PlainGraph;
+
+}
+
+TEST(pooled_label_interning)
+{
+    LabelPool pool;
+    PooledLabel a = pool.intern("alpha");
+    PooledLabel b = pool.intern(std::string("alpha"));
+    PooledLabel c = pool.intern("beta", 4);
+    CHECK(a == b);
+    CHECK(a.c_str() == b.c_str());
+    CHECK(a != c);
+    CHECK_EQUAL(pool.size(), 2u);
+
+    // the empty label is the default one and is not stored
+    CHECK(pool.intern("") == PooledLabel());
+    CHECK_EQUAL(PooledLabel().size(), (size_t) 0);
+    CHECK_EQUAL(std::string(PooledLabel().c_str()), std::string(""));
+    CHECK_EQUAL(pool.size(), 2u);
+
+    // characters are kept whole, null terminated
+    PooledLabel zero = pool.intern(std::string("a\0b", 3));
+    CHECK_EQUAL(zero.size(), (size_t) 3);
+    CHECK_EQUAL(zero.str(), std::string("a\0b", 3));
+    CHECK(zero != pool.intern("a"));
+    std::string huge(200000, 'h');
+    PooledLabel big = pool.intern(huge);
+    CHECK_EQUAL(big.str(), huge);
+    CHECK(pool.intern(huge) == big);
+    CHECK(pool.memory_usage() > huge.size());
+
+    std::ostringstream out;
+    out << a << "/" << c;
+    CHECK_EQUAL(out.str(), std::string("alpha/beta"));
+    CHECK_EQUAL("<" + a + ">", std::string("<alpha>"));
+}
+
+TEST(pooled_label_order_and_hash)
+{
+    LabelPool pool;
+    const char* words[] = { "", "a", "ab", "abc", "b", "ba", "z" };
+    for (unsigned i = 0; i < 7; i++)
+    {
+        for (unsigned j = 0; j < 7; j++)
+            CHECK_EQUAL(pool.intern(words[i]) < pool.intern(words[j]), std::string(words[i]) < std::string(words[j]));
+    }
+
+    // labels of two pools are equal by their characters, with the same hash
+    LabelPool other;
+    CHECK(pool.intern("shared") == other.intern("shared"));
+    CHECK(pool.intern("shared") != other.intern("shares"));
+    CHECK_EQUAL(std::hash<PooledLabel>()(pool.intern("shared")), std::hash<PooledLabel>()(other.intern("shared")));
+
+    std::unordered_set<PooledLabel> set;
+    set.insert(pool.intern("x"));
+    set.insert(other.intern("x"));
+    set.insert(pool.intern("y"));
+    CHECK_EQUAL(set.size(), (size_t) 2);
+}
+
+TEST(pooled_label_concurrent_interning)
+{
+    LabelPool pool;
+    std::vector<std::vector<PooledLabel> > labels(4, std::vector<PooledLabel>(5000));
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < labels.size(); t++)
+    {
+        threads.push_back(std::thread([&pool, &labels, t]() {
+            for (unsigned i = 0; i < labels[t].size(); i++)
+                labels[t][i] = pool.intern("n" + std::to_string(i));
+        }));
+    }
+    for (unsigned t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    CHECK_EQUAL(pool.size(), 5000u);
+    for (unsigned i = 0; i < 5000; i++)
+    {
+        for (unsigned t = 1; t < labels.size(); t++)
+            CHECK(labels[t][i].c_str() == labels[0][i].c_str());
+        CHECK_EQUAL(labels[0][i].str(), "n" + std::to_string(i));
+    }
+}
+
+TEST(pooled_label_graphs_share_their_pool)
+{
+    LabelGraph g(false);
+    g.set_vertex_index(true);
+    LabelGraph::Vertex* a = g.add_vertex(g.intern_label("a"));
+    LabelGraph::Vertex* b = g.add_vertex(g.intern_label("b", 1));
+    g.add_edge(3, a, b);
+    CHECK(g.get_vertex_data(g.intern_label("b")) == b);
+    CHECK(g.get_vertex_data(g.intern_label("c")) == nullptr);
+
+    // clones and subgraphs point at the same characters, and outlive g
+    LabelGraph* copy = new LabelGraph(g.clone());
+    std::vector<LabelGraph::Edge*> edges(1, g.get_edge(0));
+    LabelGraph::ArrayIterator<LabelGraph::Edge*> it(&edges);
+    LabelGraph sub = g.subgraph(&it);
+    CHECK(copy->get_vertex(1)->get_value().c_str() == b->get_value().c_str());
+    CHECK(sub.get_vertex(0)->get_value().c_str() == a->get_value().c_str());
+    CHECK(copy->intern_label("b").c_str() == b->get_value().c_str());
+
+    LabelGraph moved(std::move(g));
+    CHECK(moved.intern_label("a") == moved.get_vertex(0)->get_value());
+    moved = LabelGraph(true);
+    CHECK_EQUAL(copy->get_vertex(1)->get_value().str(), std::string("b"));
+    delete copy;
+    CHECK_EQUAL(sub.get_vertex(1)->get_value().str(), std::string("b"));
+
+    // the pool is counted with the labels
+    CHECK(sub.memory_usage().labels >= sizeof(LabelPool));
+    CHECK_EQUAL(PlainGraph(false).memory_usage().labels, (size_t) 0);
+}
+
+TEST(pooled_label_parallel_load)
+{
+    const char* FILENAME = "pooled_label_test.dot";
+    {
+        std::ofstream out(FILENAME);
+        out << "graph {\n";
+        for (unsigned i = 0; i < 20000; i++)
+            out << "\tv" << i % 9000 << " -- v" << (i * 7) % 9000 << " [label=1]\n";
+        out << "}\n";
+    }
+
+    ParallelDotLoader loader(FILENAME, 4);
+    LabelGraph g(loader.is_directed());
+    g.set_vertex_index(true);
+    loader.build(g);
+    std::remove(FILENAME);
+
+    PlainGraph plain(loader.is_directed());
+    loader.build(plain);
+    CHECK_EQUAL(g.num_vertices(), 9000u);
+    for (unsigned v = 0; v < g.num_vertices(); v++)
+    {
+        CHECK_EQUAL(g.get_vertex(v)->get_value().str(), plain.get_vertex(v)->get_value());
+        CHECK(g.get_vertex_data(g.intern_label(plain.get_vertex(v)->get_value())) == g.get_vertex(v));
+    }
+}
@@ -0,0 +1,109 @@
+#include <vector>
+#include <map>
+
+#include "check.hpp"
+#include "priority_queues.hpp"
+#include "edge_lists.hpp"
+
+namespace
+{
+
+unsigned long next_random(unsigned long& state)
+{
+    state = state * 6364136223846793005ul + 1442695040888963407ul;
+    return state >> 33;
+}
+
+// Dijkstra-like use: keys pushed after a pop are never below it, and queued
+// vertices only ever get lower keys.
+template<class QUEUE>
+void check_monotone_use(unsigned n, unsigned long seed)
+{
+    QUEUE queue;
+    for (int round = 0; round < 2; round++)
+    {
+        queue.reset(n);
+        std::map<unsigned, unsigned> expected;     // vertex -> key
+        std::vector<bool> done(n, false);
+        unsigned last = 0;
+        expected[0] = 0;
+        queue.push(0, 0);
+
+        while (!queue.empty())
+        {
+            unsigned v = queue.pop();
+            CHECK(expected.count(v));
+            unsigned key = expected[v];
+            for (std::map<unsigned, unsigned>::iterator it = expected.begin(); it != expected.end(); ++it)
+                CHECK(key <= it->second);
+            CHECK(key >= last);
+            last = key;
+            expected.erase(v);
+            done[v] = true;
+
+            for (int i = 0; i < 4; i++)
+            {
+                unsigned u = next_random(seed) % n;
+                if (done[u])
+                    continue;
+                unsigned k = key + next_random(seed) % (round ? 5000 : 20);
+                if (!expected.count(u) || k < expected[u])
+                    expected[u] = k;
+                queue.push(u, k);
+            }
+        }
+        CHECK(expected.empty());
+    }
+}
+
+template<class QUEUE>
+void check_dijkstra(bool directed, unsigned long seed)
+{
+    unsigned n = 60;
+    std::vector<unsigned> src, dst;
+    std::vector<int> w;
+    for (unsigned i = 0; i < 240; i++)
+    {
+        src.push_back(next_random(seed) % n);
+        dst.push_back(next_random(seed) % n);
+        w.push_back(1 + next_random(seed) % 30);
+    }
+    CompactGraph<int> g(directed, n, src, dst, w);
+
+    IntWeights weights = int_weights();
+    for (unsigned start = 0; start < n; start += 11)
+    {
+        CompactGraph<int>::ShortestPathTree reference = g.shortest_path_tree(start, weights);
+        CompactGraph<int>::ShortestPathTree tree = g.template shortest_path_tree<QUEUE>(start, weights);
+        for (unsigned v = 0; v < n; v++)
+            CHECK_EQUAL(tree.distance[v], reference.distance[v]);
+    }
+}
+
+}
+
+TEST(priority_queues_dary_heap)
+{
+    check_monotone_use<DaryHeap<> >(200, 1);
+    check_monotone_use<DaryHeap<2> >(200, 2);
+}
+
+TEST(priority_queues_bucket_queue)
+{
+    check_monotone_use<BucketQueue>(200, 3);
+}
+
+TEST(priority_queues_radix_heap)
+{
+    check_monotone_use<RadixHeap>(200, 4);
+}
+
+TEST(priority_queues_in_dijkstra)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        check_dijkstra<BucketQueue>(directed, 5 + directed);
+        check_dijkstra<RadixHeap>(directed, 7 + directed);
+        check_dijkstra<DaryHeap<8> >(directed, 9 + directed);
+    }
+}
@@ -0,0 +1,176 @@
+#include <vector>
+#include <string>
+#include <thread>
+
+#include "check.hpp"
+#include "edge_lists.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+// Exact distances to end, used as the tightest admissible A* heuristic.
+struct DistanceTo
+{
+    const std::vector<int>* distance;
+    int operator()(unsigned v) const { return (*distance)[v] < int_weights().infinity() ? (*distance)[v] : 0; }
+};
+
+struct HalfDistanceTo
+{
+    const std::vector<int>* distance;
+    int operator()(unsigned v) const { return (*distance)[v] < int_weights().infinity() ? (*distance)[v] / 2 : 0; }
+};
+
+// EdgeListIterator is private to Graph, so it is only ever deduced
+template<class ITERATOR>
+int iterated_weight(ITERATOR it, unsigned& count)
+{
+    int total = 0;
+    count = 0;
+    for (; it.has_next(); it.next())
+    {
+        total += it.current()->get_weight();
+        count++;
+    }
+    return total;
+}
+
+struct Zero
+{
+    int operator()(unsigned) const { return 0; }
+};
+
+}
+
+TEST(shortest_paths_match_the_tree)
+{
+    IntWeights weights = int_weights();
+    for (int directed = 0; directed < 2; directed++)
+    {
+        EdgeList list = random_edges(50, 110, 31 + directed);
+        CompactGraph<int> g = list.freeze(directed);
+        CompactGraph<int> reverse = g.reversed();
+        CompactGraph<int>::Search<DaryHeap<> > search, backward;
+
+        for (unsigned start = 0; start < list.n; start += 9)
+        {
+            std::vector<long> expected = reference_distances(list, directed, start);
+            for (unsigned end = 0; end < list.n; end += 4)
+            {
+                std::vector<unsigned> single = g.shortest_path(start, end, weights);
+                std::vector<unsigned> reused = g.shortest_path(start, end, weights, search);
+                std::vector<unsigned> both = g.bidirectional_shortest_path(start, end, reverse, weights);
+                std::vector<unsigned> guided = g.astar_path(start, end, Zero(), weights);
+                std::vector<unsigned> both_reused = g.bidirectional_shortest_path(start, end, reverse, weights, search, backward, WholeGraph());
+                std::vector<unsigned> guided_reused = g.astar_path(start, end, Zero(), weights, search, WholeGraph());
+                if (expected[end] < 0 || start == end)
+                {
+                    CHECK(single.empty());
+                    CHECK(reused.empty());
+                    CHECK(both.empty());
+                    CHECK(guided.empty());
+                    CHECK(both_reused.empty());
+                    CHECK(guided_reused.empty());
+                    continue;
+                }
+                CHECK_EQUAL(walk_length(g, single, start, end), expected[end]);
+                CHECK_EQUAL(walk_length(g, reused, start, end), expected[end]);
+                CHECK_EQUAL(walk_length(g, both, start, end), expected[end]);
+                CHECK_EQUAL(walk_length(g, guided, start, end), expected[end]);
+                CHECK_EQUAL(walk_length(g, both_reused, start, end), expected[end]);
+                CHECK_EQUAL(walk_length(g, guided_reused, start, end), expected[end]);
+            }
+        }
+    }
+}
+
+TEST(shortest_paths_astar_with_admissible_heuristics)
+{
+    IntWeights weights = int_weights();
+    EdgeList list = random_edges(60, 150, 77);
+    CompactGraph<int> g = list.freeze(true);
+    CompactGraph<int> reverse = g.reversed();
+
+    for (unsigned end = 0; end < list.n; end += 13)
+    {
+        CompactGraph<int>::ShortestPathTree to_end = reverse.shortest_path_tree(end, weights);
+        DistanceTo exact = { &to_end.distance };
+        HalfDistanceTo half = { &to_end.distance };
+        for (unsigned start = 0; start < list.n; start += 5)
+        {
+            std::vector<long> expected = reference_distances(list, true, start);
+            if (expected[end] <= 0)
+                continue;
+            CHECK_EQUAL(walk_length(g, g.astar_path(start, end, exact, weights), start, end), expected[end]);
+            CHECK_EQUAL(walk_length(g, g.astar_path(start, end, half, weights), start, end), expected[end]);
+        }
+    }
+}
+
+TEST(shortest_paths_through_the_graph_iterators)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        // a-b-c is cheaper than the direct a-c
+        StringGraph g = make_graph(directed);
+        StringGraph::Vertex* a = g.add_vertex("a");
+        StringGraph::Vertex* b = g.add_vertex("b");
+        StringGraph::Vertex* c = g.add_vertex("c");
+        g.add_edge(2, a, b);
+        g.add_edge(3, b, c);
+        g.add_edge(9, a, c);
+
+        unsigned count;
+        CHECK_EQUAL(iterated_weight(g.shortest_path_iterator(a, c), count), 5);
+        CHECK_EQUAL(count, 2u);
+        CHECK_EQUAL(iterated_weight(g.bidirectional_shortest_path_iterator(a, c), count), 5);
+        CHECK_EQUAL(count, 2u);
+        CHECK_EQUAL(iterated_weight(g.astar_path_iterator(a, c, [](StringGraph::Vertex*) { return 0; }), count), 5);
+        CHECK_EQUAL(count, 2u);
+    }
+}
+
+// The graph hands its searches from one query to the next, and a fresh one to
+// a query running alongside.
+TEST(shortest_paths_reuse_the_graph_searches)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        EdgeList list = random_edges(40, 90, 53 + directed);
+        StringGraph g = make_graph(directed);
+        for (unsigned v = 0; v < list.n; v++)
+            g.add_vertex(std::to_string(v));
+        for (unsigned e = 0; e < list.src.size(); e++)
+            g.add_edge(list.w[e], g.get_vertex(list.src[e]), g.get_vertex(list.dst[e]));
+
+        std::vector<std::vector<long> > expected;
+        for (unsigned start = 0; start < list.n; start++)
+            expected.push_back(reference_distances(list, directed, start));
+
+        std::vector<unsigned> mismatches(4, 0);
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < mismatches.size(); t++)
+        {
+            threads.push_back(std::thread([&, t]() {
+                unsigned count;
+                for (unsigned start = t; start < list.n; start += 3)
+                {
+                    for (unsigned end = 0; end < list.n; end++)
+                    {
+                        long want = start == end || expected[start][end] < 0 ? 0 : expected[start][end];
+                        StringGraph::Vertex* a = g.get_vertex(start);
+                        StringGraph::Vertex* b = g.get_vertex(end);
+                        mismatches[t] += iterated_weight(g.shortest_path_iterator(a, b), count) != want;
+                        mismatches[t] += iterated_weight(g.bidirectional_shortest_path_iterator(a, b), count) != want;
+                        mismatches[t] += iterated_weight(g.astar_path_iterator(a, b, [](StringGraph::Vertex*) { return 0; }), count) != want;
+                    }
+                }
+            }));
+        }
+        for (unsigned t = 0; t < threads.size(); t++)
+            threads[t].join();
+        for (unsigned t = 0; t < mismatches.size(); t++)
+            CHECK_EQUAL(mismatches[t], 0u);
+    }
+}
@@ -0,0 +1,85 @@
+#include <vector>
+#include <algorithm>
+
+#include "check.hpp"
+#include "edge_lists.hpp"
+#include "spanning_forest.hpp"
+
+namespace
+{
+
+// The forest must be acyclic and span every component; returns its weight.
+long check_forest(const EdgeList& list, const std::vector<unsigned>& forest)
+{
+    DisjointSet all(list.n);
+    for (unsigned e = 0; e < list.src.size(); e++)
+        all.unite(list.src[e], list.dst[e]);
+
+    DisjointSet sets(list.n);
+    long total = 0;
+    for (unsigned i = 0; i < forest.size(); i++)
+    {
+        CHECK(sets.unite(list.src[forest[i]], list.dst[forest[i]]));
+        total += list.w[forest[i]];
+    }
+    CHECK_EQUAL(sets.num_sets(), all.num_sets());
+    return total;
+}
+
+// weight of a minimum spanning forest, by a plain serial Kruskal
+long reference_weight(const EdgeList& list)
+{
+    std::vector<std::pair<int, unsigned> > order;
+    for (unsigned e = 0; e < list.w.size(); e++)
+        order.push_back(std::make_pair(list.w[e], e));
+    std::sort(order.begin(), order.end());
+
+    DisjointSet sets(list.n);
+    long total = 0;
+    for (unsigned i = 0; i < order.size(); i++)
+    {
+        if (sets.unite(list.src[order[i].second], list.dst[order[i].second]))
+            total += order[i].first;
+    }
+    return total;
+}
+
+}
+
+TEST(spanning_forest_engines_agree)
+{
+    for (unsigned long seed = 1; seed <= 6; seed++)
+    {
+        // sparse enough to leave several components, with many equal weights
+        EdgeList list = random_edges(300, 200 + 60 * seed, seed);
+        for (unsigned i = 0; i < list.w.size(); i++)
+            list.w[i] %= 5;
+        CompactGraph<int> g = list.freeze(false);
+
+        long expected = reference_weight(list);
+        for (unsigned threads = 1; threads <= 4; threads++)
+        {
+            CHECK_EQUAL(check_forest(list, KruskalBuilder<int>(&g, threads).get()), expected);
+            CHECK_EQUAL(check_forest(list, BoruvkaBuilder<int>(&g, threads).get()), expected);
+        }
+    }
+}
+
+TEST(spanning_forest_without_edges)
+{
+    EdgeList list;
+    list.n = 5;
+    CompactGraph<int> g = list.freeze(false);
+    CHECK(KruskalBuilder<int>(&g, 2).get().empty());
+    CHECK(BoruvkaBuilder<int>(&g, 2).get().empty());
+}
+
+TEST(spanning_forest_prim_on_a_connected_graph)
+{
+    // a path through every vertex keeps the graph connected
+    EdgeList list = random_edges(200, 400, 17);
+    for (unsigned v = 1; v < list.n; v++)
+        list.add(v - 1, v, 50);
+    CompactGraph<int> g = list.freeze(false);
+    CHECK_EQUAL(check_forest(list, g.min_spanning_tree(7)), reference_weight(list));
+}
@@ -0,0 +1,50 @@
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+#include "string_pool.hpp"
+
+TEST(string_pool_add_and_read)
+{
+    StringPool pool;
+    CHECK_EQUAL(pool.size(), 0u);
+    CHECK_EQUAL(pool.add("alpha"), 0u);
+    CHECK_EQUAL(pool.add(std::string("")), 1u);
+    CHECK_EQUAL(pool.add(std::string("a\0b", 3)), 2u);
+
+    CHECK_EQUAL(pool.size(), 3u);
+    CHECK_EQUAL(pool.get(0), std::string("alpha"));
+    CHECK_EQUAL(pool.length(1), (size_t) 0);
+    CHECK_EQUAL(pool.get(2), std::string("a\0b", 3));
+    CHECK_EQUAL(pool.num_chars(), (size_t) 8);
+    CHECK(pool.memory_usage() >= pool.num_chars());
+}
+
+TEST(string_pool_placed_in_order)
+{
+    std::vector<std::string> names;
+    names.push_back("x");
+    names.push_back("");
+    names.push_back("yyy");
+    names.push_back("zz");
+
+    size_t bytes = 0;
+    for (unsigned i = 0; i < names.size(); i++)
+        bytes += names[i].size();
+
+    // placed out of order, as the parallel loader's threads do
+    StringPool pool;
+    pool.resize(names.size(), bytes);
+    size_t offsets[] = { 0, 1, 1, 4 };
+    for (unsigned i = names.size(); i-- > 0; )
+        pool.place(i, offsets[i], names[i].data(), names[i].size());
+
+    CHECK_EQUAL(pool.size(), (unsigned) names.size());
+    for (unsigned i = 0; i < names.size(); i++)
+        CHECK_EQUAL(pool.get(i), names[i]);
+
+    // and added to as usual afterwards
+    CHECK_EQUAL(pool.add("w"), 4u);
+    CHECK_EQUAL(pool.get(3), std::string("zz"));
+    CHECK_EQUAL(pool.get(4), std::string("w"));
+}
@@ -0,0 +1,165 @@
+#include <vector>
+#include <string>
+
+#include "check.hpp"
+#include "subgraph_mask.hpp"
+#include "fixtures.hpp"
+
+namespace
+{
+
+template<class ITERATOR>
+long iterated_weight(ITERATOR it, unsigned& count)
+{
+    long total = 0;
+    count = 0;
+    for (; it.has_next(); it.next())
+    {
+        total += it.current()->get_weight();
+        count++;
+    }
+    return total;
+}
+
+template<class ITERATOR>
+unsigned visited(ITERATOR it)
+{
+    unsigned count = 0;
+    for (; it.has_next(); it.next())
+        count++;
+    return count;
+}
+
+unsigned long next_random(unsigned long& state, unsigned n)
+{
+    state = state * 6364136223846793005ul + 1442695040888963407ul;
+    return (state >> 33) % n;
+}
+
+}
+
+TEST(subgraph_mask_bits)
+{
+    SubgraphMask mask(70, 130);
+    CHECK(!mask.vertex(0));
+    mask.set_vertex(69);
+    mask.set_edge(64);
+    mask.set_edge(500);
+    CHECK(mask.vertex(69));
+    CHECK(mask.edge(64));
+    CHECK(!mask.edge(500));
+    CHECK(!mask.vertex(70));
+
+    mask.set_all_vertices();
+    CHECK(mask.vertex(0) && mask.vertex(69));
+    CHECK(!mask.vertex(70));
+    mask.set_vertex(3, false);
+    CHECK(!mask.vertex(3));
+
+    std::vector<unsigned> vertices(1, 3), edges(1, 64);
+    vertices.push_back(1000);
+    SubgraphMask other(70, 130, vertices, edges);
+    CHECK(other.vertex(3));
+    CHECK(!other.vertex(4));
+
+    mask &= other;
+    CHECK(!mask.vertex(3));
+    CHECK(!mask.vertex(69));
+    CHECK(mask.edge(64));
+
+    EdgeOverlay overlay;
+    overlay.insert(7);
+    SubgraphMask tree(70, 130, overlay);
+    CHECK(tree.vertex(42));
+    CHECK(tree.edge(7));
+    CHECK(!tree.edge(64));
+    CHECK_EQUAL(tree.num_edges(), 130u);
+}
+
+TEST(subgraph_view_matches_its_copy)
+{
+    for (int directed = 0; directed < 2; directed++)
+    {
+        StringGraph g = make_graph(directed);
+        unsigned long state = 21 + directed;
+        for (unsigned v = 0; v < 60; v++)
+            g.add_vertex(std::to_string(v));
+        for (unsigned e = 0; e < 150; e++)
+            g.add_edge(1 + next_random(state, 40), g.get_vertex(next_random(state, 60)), g.get_vertex(next_random(state, 60)));
+
+        // drop a few vertices and a third of the edges
+        SubgraphMask mask = g.subgraph_mask(true);
+        for (unsigned v = 0; v < 60; v += 7)
+            mask.set_vertex(v, false);
+        for (unsigned e = 0; e < 150; e++)
+            mask.set_edge(e, next_random(state, 3) != 0);
+        StringGraph::View view = g.view(mask);
+        StringGraph copy = view.materialize();
+
+        // the copy numbers the kept vertices in order
+        std::vector<StringGraph::Vertex*> kept;
+        for (unsigned v = 0; v < 60; v++)
+        {
+            if (mask.vertex(v))
+                kept.push_back(g.get_vertex(v));
+        }
+        CHECK_EQUAL(copy.num_vertices(), (unsigned) kept.size());
+
+        unsigned count, expected_count;
+        for (unsigned i = 0; i < kept.size(); i += 5)
+        {
+            StringGraph::Vertex* start = kept[i];
+            StringGraph::Vertex* copy_start = copy.get_vertex(i);
+            CHECK_EQUAL(visited(view.breadth_first_iterator(start)), visited(copy.breadth_first_iterator(copy_start)));
+            CHECK_EQUAL(visited(view.depth_first_iterator(start)), visited(copy.depth_first_iterator(copy_start)));
+            CHECK_EQUAL(iterated_weight(view.shortest_path_tree_iterator(start), count),
+                        iterated_weight(copy.shortest_path_tree_iterator(copy_start), expected_count));
+
+            for (unsigned j = 1; j < kept.size(); j += 4)
+            {
+                long expected = iterated_weight(copy.shortest_path_iterator(copy_start, copy.get_vertex(j)), expected_count);
+                CHECK_EQUAL(iterated_weight(view.shortest_path_iterator(start, kept[j]), count), expected);
+                CHECK_EQUAL(count, expected_count);
+                CHECK_EQUAL(iterated_weight(view.bidirectional_shortest_path_iterator(start, kept[j]), count), expected);
+                CHECK_EQUAL(iterated_weight(view.astar_path_iterator(start, kept[j], [](StringGraph::Vertex*) { return 0; }), count), expected);
+            }
+        }
+
+        if (!directed)
+        {
+            CHECK_EQUAL(iterated_weight(view.min_spanning_tree_iterator(), count),
+                        iterated_weight(copy.min_spanning_tree_iterator(), expected_count));
+            CHECK_EQUAL(count, expected_count);
+        }
+
+        // every listed edge is in the view
+        for (auto it = view.min_spanning_tree_iterator(); it.has_next(); it.next())
+            CHECK(view.contains(it.current()));
+    }
+}
+
+TEST(subgraph_view_leaves_out_dropped_ends)
+{
+    StringGraph g = make_graph(false);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    StringGraph::Vertex* c = g.add_vertex("c");
+    g.add_edge(1, a, b);
+    g.add_edge(1, b, c);
+    g.add_edge(5, a, c);
+
+    SubgraphMask mask = g.subgraph_mask(true);
+    mask.set_vertex(b->get_index(), false);
+    StringGraph::View view = g.view(mask);
+    unsigned count;
+    CHECK_EQUAL(iterated_weight(view.shortest_path_iterator(a, c), count), 5);
+    CHECK(!view.shortest_path_iterator(a, b).has_next());
+    CHECK_EQUAL(view.materialize().num_edges(), 1u);
+
+    // subgraph keeps each edge once
+    std::vector<StringGraph::Edge*> listed(2, g.get_edge(0));
+    StringGraph::ArrayIterator<StringGraph::Edge*> it(&listed);
+    StringGraph sub = g.subgraph(&it);
+    CHECK_EQUAL(sub.num_vertices(), 2u);
+    CHECK_EQUAL(sub.num_edges(), 1u);
+}
@@ -0,0 +1,32 @@
+#include <vector>
+#include <atomic>
+
+#include "check.hpp"
+#include "thread_pool.hpp"
+
+TEST(thread_pool_runs_every_item_once)
+{
+    for (unsigned threads = 1; threads <= 4; threads++)
+    {
+        ThreadPool pool(threads);
+        CHECK_EQUAL(pool.size(), threads);
+
+        // the pool is reused across calls, including uneven and empty ranges
+        unsigned sizes[] = { 1000, 0, 7, 1 };
+        for (unsigned s = 0; s < 4; s++)
+        {
+            std::vector<std::atomic<unsigned> > hits(sizes[s] + 3);
+            for (unsigned i = 0; i < hits.size(); i++)
+                hits[i] = 0;
+            std::atomic<bool> bad_worker(false);
+            pool.for_each(3, 3 + sizes[s], [&](unsigned item, unsigned worker) {
+                hits[item]++;
+                if (worker >= threads)
+                    bad_worker = true;
+            });
+            CHECK(!bad_worker);
+            for (unsigned i = 0; i < hits.size(); i++)
+                CHECK_EQUAL(hits[i].load(), i < 3 ? 0u : 1u);
+        }
+    }
+}
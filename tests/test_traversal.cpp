@@ -0,0 +1,98 @@
+#include <vector>
+
+#include "check.hpp"
+#include "edge_lists.hpp"
+#include "fixtures.hpp"
+#include "traversal.hpp"
+
+namespace
+{
+
+void recursive_preorder(const CompactGraph<int>& g, unsigned v, std::vector<bool>& seen, std::vector<unsigned>& order)
+{
+    seen[v] = true;
+    order.push_back(v);
+    for (unsigned a = g.begin(v); a < g.end(v); a++)
+    {
+        if (!seen[g.target(a)])
+            recursive_preorder(g, g.target(a), seen, order);
+    }
+}
+
+}
+
+TEST(traversal_depth_first_preorder)
+{
+    TraversalWorkspace work;
+    for (int directed = 0; directed < 2; directed++)
+    {
+        EdgeList list = random_edges(80, 120, 21 + directed);
+        CompactGraph<int> g = list.freeze(directed);
+        for (unsigned source = 0; source < list.n; source += 10)
+        {
+            std::vector<bool> seen(list.n, false);
+            std::vector<unsigned> expected;
+            recursive_preorder(g, source, seen, expected);
+
+            // the workspace is reused from one traversal to the next
+            std::vector<unsigned> order;
+            for (DepthFirstTraversal<int> t(&work, list.n, source); t.has_next(); t.next(g))
+                order.push_back(t.current());
+            CHECK(order == expected);
+        }
+    }
+}
+
+TEST(traversal_breadth_first_levels)
+{
+    TraversalWorkspace work;
+    EdgeList list = random_edges(80, 150, 23);
+    CompactGraph<int> g = list.freeze(true);
+    for (unsigned source = 0; source < list.n; source += 10)
+    {
+        std::vector<int> hops = hops_from(g, source);
+        unsigned reached = 0;
+        for (BreadthFirstTraversal<int> t(&work, list.n, source); t.has_next(); t.next(g))
+        {
+            CHECK_EQUAL((int) t.depth(), hops[t.current()]);
+            reached++;
+        }
+        unsigned expected = 0;
+        for (unsigned v = 0; v < list.n; v++)
+            expected += hops[v] >= 0;
+        CHECK_EQUAL(reached, expected);
+    }
+}
+
+TEST(traversal_graph_iterators)
+{
+    StringGraph g = make_graph(true);
+    StringGraph::Vertex* a = g.add_vertex("a");
+    StringGraph::Vertex* b = g.add_vertex("b");
+    StringGraph::Vertex* c = g.add_vertex("c");
+    StringGraph::Vertex* d = g.add_vertex("d");
+    g.add_edge(1, a, b);
+    g.add_edge(1, b, c);
+    CHECK(g.is_reachable(a, c));
+    CHECK(!g.is_reachable(c, a));
+    CHECK(!g.is_reachable(a, d));
+
+    // a copy carries on by itself from the same position
+    auto dfs = g.depth_first_iterator(a);
+    dfs.next();
+    auto copy = dfs;
+    dfs.next();
+    CHECK(dfs.current() == c);
+    CHECK(copy.current() == b);
+    CHECK_EQUAL(dfs.depth(), 2u);
+
+    // an edge added mid-traversal is seen once the iterator steps again
+    auto bfs = g.breadth_first_iterator(a);
+    g.add_edge(1, a, d);
+    unsigned count = 0;
+    for (; bfs.has_next(); bfs.next())
+        count++;
+    CHECK_EQUAL(count, 4u);
+    copy.next();
+    CHECK(copy.current() == c);
+}
@@ -0,0 +1,40 @@
+#include <memory>
+
+#include "check.hpp"
+#include "tree_cache.hpp"
+
+TEST(tree_cache_evicts_least_recently_used)
+{
+    LruCache<int, int> cache(2);
+    cache.put(1, std::make_shared<const int>(10));
+    cache.put(2, std::make_shared<const int>(20));
+    std::shared_ptr<const int> one = cache.get(1);
+    CHECK_EQUAL(*one, 10);
+
+    // 2 is now the oldest
+    cache.put(3, std::make_shared<const int>(30));
+    CHECK_EQUAL(cache.size(), 2u);
+    CHECK(!cache.get(2));
+    CHECK_EQUAL(*cache.get(3), 30);
+
+    // replacing refreshes, and a value handed out outlives its eviction
+    cache.put(1, std::make_shared<const int>(11));
+    cache.put(4, std::make_shared<const int>(40));
+    CHECK(!cache.get(3));
+    CHECK_EQUAL(*cache.get(1), 11);
+    CHECK_EQUAL(*one, 10);
+
+    cache.set_capacity(1);
+    CHECK_EQUAL(cache.size(), 1u);
+    CHECK(cache.get(1));
+    cache.clear();
+    CHECK_EQUAL(cache.size(), 0u);
+}
+
+TEST(tree_cache_of_no_capacity)
+{
+    LruCache<int, int> cache;
+    cache.put(1, std::make_shared<const int>(1));
+    CHECK_EQUAL(cache.size(), 0u);
+    CHECK(!cache.get(1));
+}
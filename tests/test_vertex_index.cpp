@@ -0,0 +1,43 @@
+#include <string>
+
+#include "check.hpp"
+#include "fixtures.hpp"
+
+TEST(vertex_index_finds_labels)
+{
+    StringGraph g = make_graph(false);
+    g.add_vertex("a");
+    g.add_vertex("b");
+    CHECK(g.get_vertex_data("b") == g.get_vertex(1));
+
+    // built from the existing vertices, then kept up to date
+    g.set_vertex_index(true);
+    CHECK(g.has_vertex_index());
+    CHECK(g.get_vertex_data("a") == g.get_vertex(0));
+    g.add_vertex("c");
+    CHECK(g.get_vertex_data("c") == g.get_vertex(2));
+    CHECK(g.get_vertex_data("missing") == nullptr);
+}
+
+TEST(vertex_index_keeps_first_duplicate)
+{
+    StringGraph g = make_graph(false);
+    g.set_vertex_index(true);
+    g.add_vertex("x");
+    g.add_vertex("x");
+    CHECK(g.get_vertex_data("x") == g.get_vertex(0));
+}
+
+TEST(vertex_index_follows_renames)
+{
+    StringGraph g = make_graph(false);
+    g.set_vertex_index(true);
+    StringGraph::Vertex* v = g.add_vertex("old");
+    g.set_vertex_value(v, "new");
+    CHECK(g.get_vertex_data("old") == nullptr);
+    CHECK(g.get_vertex_data("new") == v);
+
+    g.set_vertex_index(false);
+    CHECK(!g.has_vertex_index());
+    CHECK(g.get_vertex_data("new") == v);
+}
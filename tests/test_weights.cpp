@@ -0,0 +1,128 @@
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "check.hpp"
+#include "weights.hpp"
+#include "compact_graph.hpp"
+#include "disjoint_set.hpp"
+
+namespace
+{
+
+struct DoubleEdges
+{
+    unsigned n;
+    std::vector<unsigned> src;
+    std::vector<unsigned> dst;
+    std::vector<double> w;
+
+    void add(unsigned s, unsigned d, double weight)
+    {
+        src.push_back(s);
+        dst.push_back(d);
+        w.push_back(weight);
+    }
+};
+
+double next_fraction(unsigned long& state)
+{
+    state = state * 6364136223846793005ul + 1442695040888963407ul;
+    return (state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+}
+
+TEST(weights_default_conventions)
+{
+    DefaultWeights<int> i;
+    CHECK_EQUAL(i.zero(), 0);
+    CHECK_EQUAL(i.infinity(), std::numeric_limits<int>::max() / 2);
+    CHECK(i.infinity() + i.infinity() > 0);
+    CHECK_EQUAL(i.priority(17), 17u);
+
+    // distinct doubles get distinct keys, in the same order
+    DefaultWeights<double> d;
+    CHECK(d.infinity() > 1e300);
+    double values[] = { 0.0, 1e-300, 0.5, 1000.1, 1000.1000000001, 1e12 };
+    for (unsigned k = 1; k < 6; k++)
+        CHECK(d.priority(values[k - 1]) < d.priority(values[k]));
+    CHECK(d.priority(d.zero()) < d.priority(d.infinity()));
+
+    FunctionWeights<int> f([](int&) { return 99; }, [](int&) { return 1; }, [](int& w) { return (unsigned) w * 2; });
+    CHECK_EQUAL(f.zero(), 1);
+    CHECK_EQUAL(f.infinity(), 99);
+    CHECK_EQUAL(f.priority(4), 8u);
+}
+
+TEST(weights_close_double_distances)
+{
+    // a heavy ring of edges out of 0 into a mesh of light ones: the first
+    // distances differ only in their fractions and must still settle in order
+    DoubleEdges list;
+    list.n = 200;
+    unsigned long state = 1;
+    for (unsigned v = 1; v < list.n; v++)
+        list.add(0, v, 1000 + next_fraction(state));
+    for (unsigned i = 0; i < 800; i++)
+    {
+        unsigned a = 1 + (unsigned) (next_fraction(state) * (list.n - 1));
+        unsigned b = 1 + (unsigned) (next_fraction(state) * (list.n - 1));
+        list.add(a, b, next_fraction(state) / 10);
+    }
+
+    for (int directed = 0; directed < 2; directed++)
+    {
+        CompactGraph<double> g(directed, list.n, list.src, list.dst, list.w);
+        CompactGraph<double>::ShortestPathTree tree = g.shortest_path_tree(0);
+
+        std::vector<double> d(list.n, INFINITY);
+        d[0] = 0;
+        for (unsigned round = 0; round < list.n; round++)
+        {
+            for (unsigned e = 0; e < list.w.size(); e++)
+            {
+                for (int side = 0; side < (directed ? 1 : 2); side++)
+                {
+                    unsigned a = side ? list.dst[e] : list.src[e];
+                    unsigned b = side ? list.src[e] : list.dst[e];
+                    d[b] = std::min(d[b], d[a] + list.w[e]);
+                }
+            }
+        }
+        for (unsigned v = 0; v < list.n; v++)
+            CHECK(std::fabs(tree.distance[v] - d[v]) < 1e-9);
+    }
+}
+
+TEST(weights_fractional_spanning_tree)
+{
+    // weights below one all looked alike to an integer queue
+    DoubleEdges list;
+    list.n = 100;
+    unsigned long state = 2;
+    for (unsigned v = 1; v < list.n; v++)
+        list.add(v - 1, v, 0.9 + next_fraction(state) / 10);
+    for (unsigned i = 0; i < 400; i++)
+        list.add((unsigned) (next_fraction(state) * list.n), (unsigned) (next_fraction(state) * list.n), next_fraction(state));
+    CompactGraph<double> g(false, list.n, list.src, list.dst, list.w);
+
+    std::vector<unsigned> order(list.w.size());
+    for (unsigned e = 0; e < order.size(); e++)
+        order[e] = e;
+    std::sort(order.begin(), order.end(), [&](unsigned a, unsigned b) { return list.w[a] < list.w[b]; });
+    DisjointSet sets(list.n);
+    double expected = 0;
+    for (unsigned i = 0; i < order.size(); i++)
+    {
+        if (sets.unite(list.src[order[i]], list.dst[order[i]]))
+            expected += list.w[order[i]];
+    }
+
+    std::vector<unsigned> tree = g.min_spanning_tree();
+    double total = 0;
+    for (unsigned i = 0; i < tree.size(); i++)
+        total += list.w[tree[i]];
+    CHECK_EQUAL(tree.size(), list.n - 1);
+    CHECK(std::fabs(total - expected) < 1e-9);
+}
@@ -0,0 +1,48 @@
+TEMPLATE = app
+TARGET = tests
+CONFIG += console c++11 thread
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    main.cpp \
+    test_compact_graph.cpp \
+    test_vertex_index.cpp \
+    test_dot_reader.cpp \
+    test_graph_snapshot.cpp \
+    test_priority_queues.cpp \
+    test_shortest_paths.cpp \
+    test_disjoint_set.cpp \
+    test_parallel.cpp \
+    test_spanning_forest.cpp \
+    test_all_sources.cpp \
+    test_thread_pool.cpp \
+    test_distance_matrix.cpp \
+    test_batch_paths.cpp \
+    test_tree_cache.cpp \
+    test_traversal.cpp \
+    test_parallel_bfs.cpp \
+    test_weights.cpp \
+    test_arena.cpp \
+    test_overlay.cpp \
+    test_generator.cpp \
+    test_instrumentation.cpp \
+    test_dynamic_sssp.cpp \
+    test_dynamic_msf.cpp \
+    test_dot_writer.cpp \
+    test_contraction_hierarchy.cpp \
+    test_subgraph_mask.cpp \
+    test_parallel_loader.cpp \
+    test_components.cpp \
+    test_string_pool.cpp \
+    test_label_index.cpp \
+    test_pooled_label.cpp
+
+HEADERS += \
+    check.hpp \
+    edge_lists.hpp \
+    fixtures.hpp
+
+# DEFINES += ALGO_STATS to check the engine counters as well, see instrumentation.hpp
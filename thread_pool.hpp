@@ -0,0 +1,176 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+#include "parallel.hpp"
+
+
+// Persistent pool running index loops with range stealing: each worker starts
+// on its own slice of the indices and, once done, steals the upper half of
+// the largest slice left. The calling thread takes part as worker 0, so a
+// worker index is always below size() and can address per-thread scratch.
+class ThreadPool
+{
+
+private:
+    struct Range
+    {
+        std::mutex lock;
+        unsigned begin;
+        unsigned end;
+    };
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Range[]> ranges;
+    unsigned nthreads;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    unsigned long generation;
+    unsigned running;
+    bool stopping;
+    std::function<void(unsigned, unsigned)> job;
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    bool take(unsigned worker, unsigned& item)
+    {
+        Range& own = ranges[worker];
+        {
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (own.begin < own.end)
+            {
+                item = own.begin ++;
+                return true;
+            }
+        }
+
+        for (;;)
+        {
+            unsigned victim = nthreads;
+            unsigned most = 0;
+            for (unsigned t = 0; t < nthreads; t++)
+            {
+                std::lock_guard<std::mutex> guard(ranges[t].lock);
+                if (ranges[t].end - ranges[t].begin > most)
+                {
+                    most = ranges[t].end - ranges[t].begin;
+                    victim = t;
+                }
+            }
+            if (victim == nthreads)
+                return false;
+
+            unsigned lo, hi;
+            {
+                std::lock_guard<std::mutex> guard(ranges[victim].lock);
+                Range& r = ranges[victim];
+                if (r.begin >= r.end)
+                    continue;
+                hi = r.end;
+                lo = r.begin + (r.end - r.begin) / 2;
+                r.end = lo;
+            }
+
+            std::lock_guard<std::mutex> guard(own.lock);
+            own.begin = lo + 1;
+            own.end = hi;
+            item = lo;
+            return true;
+        }
+    }
+
+    void work(unsigned worker)
+    {
+        unsigned item;
+        while (take(worker, item))
+        {
+            job(item, worker);
+        }
+    }
+
+    void loop(unsigned worker)
+    {
+        unsigned long seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> guard(mutex);
+                wake.wait(guard, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+
+            work(worker);
+
+            std::lock_guard<std::mutex> guard(mutex);
+            if (-- running == 0)
+                finished.notify_all();
+        }
+    }
+
+public:
+    ThreadPool(unsigned threads = 0)
+    {
+        nthreads = threads ? threads : default_threads();
+        ranges.reset(new Range[nthreads]);
+        generation = 0;
+        running = 0;
+        stopping = false;
+
+        for (unsigned t = 1; t < nthreads; t++)
+        {
+            workers.push_back(std::thread(&ThreadPool::loop, this, t));
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (unsigned t = 0; t < workers.size(); t++)
+        {
+            workers[t].join();
+        }
+    }
+
+    unsigned size() const { return nthreads; }
+
+    // Calls fn(item, worker) for every item of [begin, end) and waits for all of
+    // them. One loop at a time: for_each must not be called from inside fn.
+    void for_each(unsigned begin, unsigned end, std::function<void(unsigned, unsigned)> fn)
+    {
+        unsigned n = end > begin ? end - begin : 0;
+        for (unsigned t = 0; t < nthreads; t++)
+        {
+            std::lock_guard<std::mutex> guard(ranges[t].lock);
+            ranges[t].begin = begin + (unsigned long long) n * t / nthreads;
+            ranges[t].end = begin + (unsigned long long) n * (t + 1) / nthreads;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            job = fn;
+            running = nthreads - 1;
+            generation ++;
+        }
+        wake.notify_all();
+
+        work(0);
+
+        std::unique_lock<std::mutex> guard(mutex);
+        finished.wait(guard, [&] { return running == 0; });
+        job = nullptr;
+    }
+};
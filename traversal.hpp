@@ -0,0 +1,184 @@
+#pragma once
+
+#include <vector>
+
+#include "compact_graph.hpp"
+
+
+// Visited marks stamped with the number of the current run: clearing is a
+// counter increment, and the array is only wiped when the counter wraps.
+class VisitedSet
+{
+
+private:
+    std::vector<unsigned> stamp;
+    unsigned epoch;
+
+public:
+    VisitedSet() { epoch = 0; }
+
+    void clear(unsigned n)
+    {
+        reserve(n);
+        if (++ epoch == 0)
+        {
+            stamp.assign(stamp.size(), 0);
+            epoch = 1;
+        }
+    }
+
+    // makes room for vertices added since clear()
+    void reserve(unsigned n)
+    {
+        if (stamp.size() < n)
+            stamp.resize(n, 0);
+    }
+
+    bool contains(unsigned v) const { return stamp[v] == epoch; }
+
+    // false when v was already visited
+    bool insert(unsigned v)
+    {
+        if (stamp[v] == epoch)
+            return false;
+        stamp[v] = epoch;
+        return true;
+    }
+};
+
+
+// Scratch state of a traversal, kept between runs so that repeated
+// traversals reuse its memory instead of allocating.
+struct TraversalWorkspace
+{
+    struct Frame
+    {
+        unsigned vertex;
+        unsigned arc;       // next arc to scan, NONE before the first
+    };
+
+    VisitedSet visited;
+    std::vector<Frame> stack;
+    std::vector<unsigned> queue;
+    unsigned head;
+    unsigned level_end;
+    unsigned depth;
+};
+
+
+// Lazy depth-first preorder with an explicit stack: current() is the vertex
+// just entered and next() scans on until it enters the following one, in the
+// order of the recursive traversal.
+template<class EDATA>
+class DepthFirstTraversal
+{
+
+private:
+    TraversalWorkspace* work;
+
+public:
+    DepthFirstTraversal(TraversalWorkspace* work, unsigned n, unsigned source)
+    {
+        this->work = work;
+        work->visited.clear(n);
+        work->stack.clear();
+        TraversalWorkspace::Frame f = { source, CompactGraph<EDATA>::NONE };
+        work->stack.push_back(f);
+        work->visited.insert(source);
+    }
+
+    void rebind(TraversalWorkspace* work) { this->work = work; }
+
+    bool has_next() const { return !work->stack.empty(); }
+    unsigned current() const { return work->stack.back().vertex; }
+    unsigned depth() const { return work->stack.size() - 1; }
+
+    void next(const CompactGraph<EDATA>& g)
+    {
+        next(g, WholeGraph());
+    }
+
+    // only follows the arcs the filter keeps
+    template<class FILTER>
+    void next(const CompactGraph<EDATA>& g, const FILTER& filter)
+    {
+        std::vector<TraversalWorkspace::Frame>& stack = work->stack;
+        work->visited.reserve(g.num_vertices());
+        while (!stack.empty())
+        {
+            unsigned v = stack.back().vertex;
+            unsigned a = stack.back().arc;
+            if (a == CompactGraph<EDATA>::NONE)
+                a = g.begin(v);
+
+            for (; a < g.end(v); a++)
+            {
+                unsigned t = g.target(a);
+                if (filter.edge(g.edge(a)) && filter.vertex(t) && work->visited.insert(t))
+                {
+                    stack.back().arc = a + 1;
+                    TraversalWorkspace::Frame f = { t, CompactGraph<EDATA>::NONE };
+                    stack.push_back(f);
+                    return;
+                }
+            }
+            stack.pop_back();
+        }
+    }
+};
+
+
+// Lazy breadth-first order over a flat FIFO array: a vertex's arcs are only
+// scanned when next() moves past it.
+template<class EDATA>
+class BreadthFirstTraversal
+{
+
+private:
+    TraversalWorkspace* work;
+
+public:
+    BreadthFirstTraversal(TraversalWorkspace* work, unsigned n, unsigned source)
+    {
+        this->work = work;
+        work->visited.clear(n);
+        work->queue.assign(1, source);
+        work->visited.insert(source);
+        work->head = 0;
+        work->level_end = 1;
+        work->depth = 0;
+    }
+
+    void rebind(TraversalWorkspace* work) { this->work = work; }
+
+    bool has_next() const { return work->head < work->queue.size(); }
+    unsigned current() const { return work->queue[work->head]; }
+    unsigned depth() const { return work->depth; }
+
+    void next(const CompactGraph<EDATA>& g)
+    {
+        next(g, WholeGraph());
+    }
+
+    // only follows the arcs the filter keeps
+    template<class FILTER>
+    void next(const CompactGraph<EDATA>& g, const FILTER& filter)
+    {
+        std::vector<unsigned>& queue = work->queue;
+        work->visited.reserve(g.num_vertices());
+
+        unsigned v = queue[work->head ++];
+        for (unsigned a = g.begin(v); a < g.end(v); a++)
+        {
+            unsigned t = g.target(a);
+            if (filter.edge(g.edge(a)) && filter.vertex(t) && work->visited.insert(t))
+                queue.push_back(t);
+        }
+
+        if (work->head == work->level_end)
+        {
+            work->level_end = queue.size();
+            work->depth ++;
+        }
+    }
+};
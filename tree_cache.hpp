@@ -0,0 +1,102 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+
+// Bounded least-recently-used map of shared, immutable values. A value handed
+// out by get() stays valid after it has been evicted. Every call takes the
+// cache's lock, so one cache can serve several threads.
+template<class KEY, class VALUE>
+class LruCache
+{
+
+private:
+    typedef std::pair<KEY, std::shared_ptr<const VALUE> > Entry;
+
+    unsigned capacity;
+    std::list<Entry> entries;   // most recently used first
+    std::unordered_map<KEY, typename std::list<Entry>::iterator> index;
+    mutable std::mutex lock;
+
+    LruCache(const LruCache&);
+    LruCache& operator=(const LruCache&);
+
+    void trim()
+    {
+        while (entries.size() > capacity)
+        {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+
+public:
+    LruCache(unsigned capacity = 0)
+    {
+        this->capacity = capacity;
+    }
+
+    unsigned get_capacity() const { std::lock_guard<std::mutex> guard(lock); return capacity; }
+    unsigned size() const { std::lock_guard<std::mutex> guard(lock); return entries.size(); }
+
+    void set_capacity(unsigned capacity)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        this->capacity = capacity;
+        trim();
+    }
+
+    // null when absent
+    std::shared_ptr<const VALUE> get(const KEY& key)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = index.find(key);
+        if (found == index.end())
+        {
+            return std::shared_ptr<const VALUE>();
+        }
+        entries.splice(entries.begin(), entries, found->second);
+        return found->second->second;
+    }
+
+    void put(const KEY& key, std::shared_ptr<const VALUE> value)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (capacity == 0)
+        {
+            return;
+        }
+        auto found = index.find(key);
+        if (found != index.end())
+        {
+            found->second->second = value;
+            entries.splice(entries.begin(), entries, found->second);
+            return;
+        }
+        entries.push_front(Entry(key, value));
+        index[key] = entries.begin();
+        trim();
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        entries.clear();
+        index.clear();
+    }
+
+    // the locks stay with their caches
+    void swap(LruCache& o)
+    {
+        std::lock(lock, o.lock);
+        std::lock_guard<std::mutex> guard(lock, std::adopt_lock);
+        std::lock_guard<std::mutex> other(o.lock, std::adopt_lock);
+        std::swap(capacity, o.capacity);
+        entries.swap(o.entries);
+        index.swap(o.index);
+    }
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <limits>
+#include <functional>
+#include <type_traits>
+#include <cstring>
+#include <stdint.h>
+
+
+// Weight policies give the distance conventions of a Graph: the zero and
+// infinity distances and the 64-bit queue key of a distance, which must not
+// decrease as the distance grows and should tell distinct distances apart.
+// They are template parameters, so the relaxation loops call them directly
+// and can inline them:
+//     EDATA zero() const
+//     EDATA infinity() const      any path at least this long counts as unreachable
+//     uint64_t priority(EDATA) const
+template<class EDATA, class ENABLE = void>
+struct DefaultWeights;
+
+// Infinity is half the range, so that infinity plus an edge weight still fits.
+template<class EDATA>
+struct DefaultWeights<EDATA, typename std::enable_if<std::is_integral<EDATA>::value>::type>
+{
+    constexpr EDATA zero() const { return 0; }
+    constexpr EDATA infinity() const { return std::numeric_limits<EDATA>::max() / 2; }
+    constexpr uint64_t priority(EDATA w) const { return (uint64_t) w; }
+};
+
+// The key is the bit pattern of the distance as a double, which orders the
+// non-negative doubles exactly, so that no two distances share a key.
+template<class EDATA>
+struct DefaultWeights<EDATA, typename std::enable_if<std::is_floating_point<EDATA>::value>::type>
+{
+    constexpr EDATA zero() const { return 0; }
+    constexpr EDATA infinity() const { return std::numeric_limits<EDATA>::infinity(); }
+
+    uint64_t priority(EDATA w) const
+    {
+        double d = (double) w;
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        return bits;
+    }
+};
+
+
+// Adapter for weight conventions chosen at run time, through std::function;
+// every queue key then costs an indirect call.
+template<class EDATA>
+struct FunctionWeights
+{
+    std::function<int(EDATA&)> maxWeight;
+    std::function<int(EDATA&)> minWeight;
+    std::function<unsigned int(EDATA&)> priorityWeight;
+
+    FunctionWeights(std::function<int(EDATA&)> max, std::function<int(EDATA&)> min, std::function<unsigned int(EDATA&)> priority)
+    {
+        this->maxWeight = max;
+        this->minWeight = min;
+        this->priorityWeight = priority;
+    }
+
+    EDATA zero() const { EDATA w = EDATA(); return minWeight(w); }
+    EDATA infinity() const { EDATA w = EDATA(); return maxWeight(w); }
+    uint64_t priority(EDATA w) const { return priorityWeight(w); }
+};